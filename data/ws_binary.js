@@ -0,0 +1,38 @@
+// Protocole WebSocket binaire (src/ws_binary.h), demandé à l'ouverture: enregistrements
+// petit-boutiens enchaînés, 1er octet = type, décodés au format des trames JSON regroupées.
+// Décodeur commun au tableau de bord (index.html) et à la carte (map.html).
+const WSB_MODELS = ['stationary', 'cv', 'maneuver'];
+function decodeWsBin(buf){
+  const v = new DataView(buf), len = v.byteLength;
+  const deg = (o)=>{ const x = v.getInt32(o, true); return x === -2147483648 ? null : x / 1e7; };
+  const u16 = (o, s)=>{ const x = v.getUint16(o, true); return x === 0xFFFF ? null : x / s; };
+  const msg = {};
+  let o = 0;
+  while (o + 2 <= len){
+    const type = v.getUint8(o);
+    if (type === 1){ // GPS
+      if (o + 12 > len) break;
+      msg.gps = {valid: v.getUint8(o + 1) & 1, lat: deg(o + 2), lon: deg(o + 6), hdg: u16(o + 10, 100)};
+      o += 12;
+    } else if (type === 2){ // TARGET (filtrée ou ping brut)
+      if (o + 14 > len) break;
+      const t = {lat: deg(o + 6), lon: deg(o + 10), r95_m: u16(o + 4, 100), id: v.getUint8(o + 2)};
+      if (v.getUint8(o + 1) & 1){ t.filtered = true; (msg.targetf = msg.targetf || []).push(t); }
+      else (msg.raw = msg.raw || []).push(t);
+      o += 14;
+    } else if (type === 3){ // RSSI
+      msg.rssi = v.getInt8(o + 1);
+      o += 2;
+    } else if (type === 5){ // BEACONS
+      const n = v.getUint8(o + 1);
+      o += 2;
+      msg.targets = [];
+      for (let i = 0; i < n && o + 14 <= len; i++, o += 14){
+        const m = v.getUint8(o + 1);
+        msg.targets.push({id: v.getUint8(o), lat: deg(o + 4), lon: deg(o + 8), r95_m: u16(o + 2, 100),
+                          model: m === 0xFF ? null : (WSB_MODELS[m] || '?'), age_ms: u16(o + 12, 1)});
+      }
+    } else break; // 4 = ligne NMEA (non demandée), type inconnu
+  }
+  return msg;
+}
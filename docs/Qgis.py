@@ -123,6 +123,9 @@ while True:
                     if star >= 0:
                         core = core[:star]
                     parts = core.split(',')
+                    # $TARGETF,<id>,lat,lon,...: id de balise avant la position
+                    if parts[0] == "TARGETF" and len(parts) >= 4 and parts[1].isdigit():
+                        del parts[1]
                     if len(parts) >= 3:
                         lat = float(parts[1])
                         lon = float(parts[2])
@@ -163,6 +163,9 @@ class LiveController(QtCore.QObject):
                     info = f"valid={meta.get('valid','')},sats={meta.get('sats','')},hdop={meta.get('hdop','')}"
                     self.lyr_gps.set_point(lon, lat, ts, "GPS", info)
             elif head == "TARGET" or head == "TARGETF":
+                # $TARGETF,<id>,lat,lon,...: id de balise avant la position
+                if head == "TARGETF" and len(parts) >= 4 and parts[1].isdigit():
+                    del parts[1]
                 if len(parts) >= 3:
                     lat = float(parts[1])
                     lon = float(parts[2])
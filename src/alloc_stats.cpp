@@ -0,0 +1,30 @@
+#include "alloc_stats.h"
+#include <Arduino.h>
+
+#if HEAP_ALLOC_STATS
+static volatile TaskHandle_t watchedTask = nullptr;
+static volatile uint32_t allocCount = 0;
+
+extern "C" {
+void* __real_malloc(size_t n);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* p, size_t n);
+
+static inline void noteAlloc() {
+  TaskHandle_t t = watchedTask;
+  if (t && xTaskGetCurrentTaskHandle() == t) allocCount++;
+}
+
+void* __wrap_malloc(size_t n) { noteAlloc(); return __real_malloc(n); }
+void* __wrap_calloc(size_t n, size_t size) { noteAlloc(); return __real_calloc(n, size); }
+void* __wrap_realloc(void* p, size_t n) { noteAlloc(); return __real_realloc(p, n); }
+}
+
+void allocStatsWatchCurrentTask() { watchedTask = xTaskGetCurrentTaskHandle(); }
+bool allocStatsEnabled() { return true; }
+uint32_t allocStatsCount() { return allocCount; }
+#else
+void allocStatsWatchCurrentTask() {}
+bool allocStatsEnabled() { return false; }
+uint32_t allocStatsCount() { return 0; }
+#endif
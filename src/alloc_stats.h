@@ -0,0 +1,13 @@
+#pragma once
+#include <stdint.h>
+
+// Comptage des allocations du tas faites par une tâche (mesure des trames
+// périodiques de loop()). Actif avec -DHEAP_ALLOC_STATS=1 et l'édition de liens
+// -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (env esp32dev_allocstats de
+// platformio.ini): malloc/calloc/realloc (String, new, printf > 64 octets,
+// pile TCP appelée depuis la tâche) passent par un compteur sans verrou.
+// Sans le drapeau, allocStatsEnabled() est faux et le compteur reste à 0.
+
+void allocStatsWatchCurrentTask();
+bool allocStatsEnabled();
+uint32_t allocStatsCount();   // allocations de la tâche surveillée depuis le démarrage
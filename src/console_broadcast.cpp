@@ -22,13 +22,22 @@ void consoleBegin(){
   if (!gStarted) { gConsoleServer.begin(); gConsoleServer.setNoDelay(true); gStarted = true; }
 }
 
-void consoleBroadcastLine(const String& line){
+static bool isConsolePrefix(const char* line, size_t len){
+  static const char* const kPrefixes[] = { "$TARGET", "$STATUS", "$DTPING", "$ACK", "$SEAK", "$RET", "$CONFIG", "$GOSEAK" };
+  for (const char* p : kPrefixes) {
+    size_t pl = strlen(p);
+    if (len >= pl && memcmp(line, p, pl) == 0) return true;
+  }
+  return false;
+}
+
+void consoleBroadcastLine(const char* line, size_t len){
   if (WiFi.status() != WL_CONNECTED) return;
   ensureStarted();
   if (gConsoleClient && gConsoleClient.connected()) {
-    if (line.startsWith("$TARGET") || line.startsWith("$TARGETF") || line.startsWith("$STATUS") || line.startsWith("$DTPING") || line.startsWith("$ACK") || line.startsWith("$SEAK") || line.startsWith("$RET") || line.startsWith("$CONFIG") || line.startsWith("$GOSEAK")) {
-      gConsoleClient.print(line);
-      gConsoleClient.print("\r\n");
+    if (isConsolePrefix(line, len)) {
+      gConsoleClient.write((const uint8_t*)line, len);
+      gConsoleClient.write((const uint8_t*)"\r\n", 2);
     }
   } else {
     static unsigned long lastWarn = 0;
@@ -40,6 +49,10 @@ void consoleBroadcastLine(const String& line){
   }
 }
 
+void consoleBroadcastLine(const String& line){
+  consoleBroadcastLine(line.c_str(), line.length());
+}
+
 void consoleLoop(){
   ensureStarted();
   if (!gConsoleClient || !gConsoleClient.connected()) return;
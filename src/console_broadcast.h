@@ -6,6 +6,8 @@ void consoleBegin();
 
 // Envoie une ligne (sans CRLF) vers le client TCP "console" si connecté
 void consoleBroadcastLine(const String& line);
+// Variante sans allocation (buffer + longueur, sans CRLF)
+void consoleBroadcastLine(const char* line, size_t len);
 
 // Traite les données entrantes du client (à appeler dans loop)
 void consoleLoop();
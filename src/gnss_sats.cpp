@@ -0,0 +1,154 @@
+#include "gnss_sats.h"
+#include <string.h>
+
+void gnssSatInit(GnssSatTable& tab) {
+  memset(&tab, 0, sizeof(tab));
+  for (int c = 0; c < GNSS_CONST_COUNT; ++c) {
+    for (int s = 0; s < GNSS_SIG_SLOTS; ++s) tab.c[c].sigIds[s] = 0xFF;
+  }
+}
+
+const char* gnssConstName(GnssConst c) {
+  switch (c) {
+    case GNSS_GPS: return "gps";
+    case GNSS_GLO: return "glo";
+    case GNSS_GAL: return "gal";
+    case GNSS_BDS: return "bds";
+    case GNSS_QZSS: return "qzss";
+    default: return "unk";
+  }
+}
+
+GnssConst gnssConstFromTalker(const NmeaField& f) {
+  if (f.len < 5) return GNSS_UNKNOWN;
+  char a = f.p[0], b = f.p[1];
+  if (a == 'G' && b == 'P') return GNSS_GPS;
+  if (a == 'G' && b == 'L') return GNSS_GLO;
+  if (a == 'G' && b == 'A') return GNSS_GAL;
+  if ((a == 'G' && b == 'B') || (a == 'B' && b == 'D')) return GNSS_BDS;
+  if (a == 'G' && b == 'Q') return GNSS_QZSS;
+  return GNSS_UNKNOWN;
+}
+
+GnssConst gnssConstFromPrn(int prn) {
+  // Plages NMEA utilisées par SkyTraq (GetGNSSSystem du parseur constructeur)
+  if (prn <= 0) return GNSS_UNKNOWN;
+  if (prn >= 65 && prn <= 96) return GNSS_GLO;
+  if (prn >= 193 && prn <= 202) return GNSS_QZSS;
+  if (prn <= 64) return GNSS_GPS; // GPS + SBAS
+  return GNSS_BDS;
+}
+
+// Slot associé à un signal NMEA 4.1 (attribué au premier usage, -1 si plein)
+static int sigSlot(GnssConstTable& ct, uint8_t sigId) {
+  for (int s = 0; s < GNSS_SIG_SLOTS; ++s) if (ct.sigIds[s] == sigId) return s;
+  for (int s = 0; s < GNSS_SIG_SLOTS; ++s) {
+    if (ct.sigIds[s] == 0xFF) { ct.sigIds[s] = sigId; return s; }
+  }
+  return -1;
+}
+
+static GnssSat* findSat(GnssConstTable& ct, uint8_t prn, bool add) {
+  for (uint8_t i = 0; i < ct.count; ++i) if (ct.sats[i].prn == prn) return &ct.sats[i];
+  if (!add || ct.count >= GNSS_MAX_SATS) return nullptr;
+  GnssSat& s = ct.sats[ct.count++];
+  s.prn = prn;
+  s.elevDeg = -128;
+  s.azDeg = 0xFFFF;
+  for (int k = 0; k < GNSS_SIG_SLOTS; ++k) s.snr[k] = GNSS_SNR_NONE;
+  s.seen = 0;
+  return &s;
+}
+
+// Fin de cycle: le signal disparaît des satellites non revus, les satellites sans aucun signal sont retirés
+static void endCycle(GnssConstTable& ct, int slot) {
+  uint8_t bit = (uint8_t)(1u << slot);
+  uint8_t i = 0;
+  while (i < ct.count) {
+    GnssSat& s = ct.sats[i];
+    if (!(s.seen & bit)) s.snr[slot] = GNSS_SNR_NONE;
+    bool any = (s.seen != 0);
+    if (!any) { ct.sats[i] = ct.sats[--ct.count]; continue; }
+    ++i;
+  }
+}
+
+bool gnssApplyGsv(GnssSatTable& tab, const NmeaField* t, int n, bool& cycleDone) {
+  cycleDone = false;
+  if (n < 4) return false;
+  int numMsg = nmeaToInt(t[1], 0);
+  int msgNum = nmeaToInt(t[2], 0);
+  if (numMsg <= 0 || msgNum <= 0 || msgNum > numMsg) return false;
+  // Blocs de 4 champs après numSV; un champ restant = identifiant de signal (NMEA 4.1)
+  int blocks = (n - 4) / 4;
+  uint8_t sigId = ((n - 4) % 4 == 1) ? (uint8_t)nmeaToInt(t[n - 1], 0) : 0;
+
+  GnssConst gc = gnssConstFromTalker(t[0]);
+  if (gc == GNSS_UNKNOWN && blocks > 0) gc = gnssConstFromPrn(nmeaToInt(t[4], 0));
+  if (gc == GNSS_UNKNOWN) return blocks == 0;
+  GnssConstTable& ct = tab.c[gc];
+  int slot = sigSlot(ct, sigId);
+  if (slot < 0) return false;
+  uint8_t bit = (uint8_t)(1u << slot);
+
+  if (msgNum == 1) {
+    for (uint8_t i = 0; i < ct.count; ++i) ct.sats[i].seen &= (uint8_t)~bit;
+  }
+  for (int b = 0; b < blocks; ++b) {
+    const NmeaField* f = &t[4 + b * 4];
+    int prn = nmeaToInt(f[0], 0);
+    if (prn <= 0 || prn > 255) continue;
+    GnssSat* s = findSat(ct, (uint8_t)prn, true);
+    if (!s) continue;
+    if (f[1].len) s->elevDeg = (int8_t)nmeaToInt(f[1], -128);
+    if (f[2].len) s->azDeg = (uint16_t)nmeaToInt(f[2], 0xFFFF);
+    s->snr[slot] = f[3].len ? (uint8_t)nmeaToInt(f[3], GNSS_SNR_NONE) : GNSS_SNR_NONE;
+    s->seen |= bit;
+  }
+  if (msgNum == numMsg) {
+    endCycle(ct, slot);
+    cycleDone = true;
+  }
+  return true;
+}
+
+bool gnssApplyGsa(GnssSatTable& tab, const NmeaField* t, int n) {
+  if (n < 18) return false;
+  // Constellation: identifiant système (NMEA 4.11), sinon talker, sinon 1er PRN
+  GnssConst gc = GNSS_UNKNOWN;
+  if (n >= 19 && t[18].len) {
+    int id = nmeaToInt(t[18], 0);
+    if (id >= 1 && id <= 5) gc = (GnssConst)(id - 1);
+  }
+  if (gc == GNSS_UNKNOWN) gc = gnssConstFromTalker(t[0]);
+  if (gc == GNSS_UNKNOWN) gc = gnssConstFromPrn(nmeaToInt(t[3], 0));
+  if (gc == GNSS_UNKNOWN) return true; // aucun satellite utilisé
+  GnssConstTable& ct = tab.c[gc];
+  ct.usedCount = 0;
+  for (int i = 3; i < 15 && ct.usedCount < GNSS_MAX_USED; ++i) {
+    int prn = nmeaToInt(t[i], 0);
+    if (prn <= 0 || prn > 255) continue;
+    ct.used[ct.usedCount++] = (uint8_t)prn;
+  }
+  return true;
+}
+
+void gnssSatSummarize(const GnssSatTable& tab, GnssSatSummary& out) {
+  for (int c = 0; c < GNSS_CONST_COUNT; ++c) {
+    const GnssConstTable& ct = tab.c[c];
+    GnssConstSummary& s = out.c[c];
+    uint32_t sum = 0;
+    s.inView = ct.count;
+    s.tracked = 0;
+    s.snrMax = 0;
+    s.used = ct.usedCount;
+    for (uint8_t i = 0; i < ct.count; ++i) {
+      uint8_t v = ct.sats[i].snr[0];
+      if (v == GNSS_SNR_NONE) continue;
+      s.tracked++;
+      sum += v;
+      if (v > s.snrMax) s.snrMax = v;
+    }
+    s.snrMean = s.tracked ? (uint8_t)((sum + s.tracked / 2) / s.tracked) : 0;
+  }
+}
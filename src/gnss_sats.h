@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "nmea_parse.h"
+
+// Table des satellites en mémoire fixe (GSV/GSA), reprise de la logique de
+// SkyTraqNmeaParser (docs/PX1172RH-HAT-*): un tableau par constellation,
+// deux signaux par satellite (L1 + L2/L5/B2...), mise à jour incrémentale
+// message par message et retrait des satellites absents d'un cycle GSV.
+// Module sans dépendance Arduino.
+
+enum GnssConst {
+  GNSS_GPS,
+  GNSS_GLO,
+  GNSS_GAL,
+  GNSS_BDS,
+  GNSS_QZSS,
+  GNSS_CONST_COUNT,
+  GNSS_UNKNOWN = 0xFF,
+};
+
+static const int GNSS_MAX_SATS = 32;    // par constellation
+static const int GNSS_SIG_SLOTS = 2;    // signaux suivis par satellite
+static const int GNSS_MAX_USED = 24;    // PRN utilisés (GSA) par constellation
+static const uint8_t GNSS_SNR_NONE = 0xFF;
+
+struct GnssSat {
+  uint8_t prn;
+  int8_t elevDeg;                 // -128 si inconnue
+  uint16_t azDeg;                 // 0xFFFF si inconnu
+  uint8_t snr[GNSS_SIG_SLOTS];    // dB-Hz, GNSS_SNR_NONE si non suivi
+  uint8_t seen;                   // bit par slot: vu dans le cycle GSV courant
+};
+
+struct GnssConstTable {
+  GnssSat sats[GNSS_MAX_SATS];
+  uint8_t count;
+  uint8_t sigIds[GNSS_SIG_SLOTS]; // signal NMEA 4.1 associé à chaque slot (0xFF libre)
+  uint8_t used[GNSS_MAX_USED];
+  uint8_t usedCount;
+};
+
+struct GnssSatTable {
+  GnssConstTable c[GNSS_CONST_COUNT];
+};
+
+// Résumé publié (télémétrie): par constellation
+struct GnssConstSummary {
+  uint8_t inView;   // satellites listés par GSV
+  uint8_t tracked;  // avec SNR sur le 1er signal
+  uint8_t used;     // utilisés dans la solution (GSA)
+  uint8_t snrMean;  // dB-Hz, 1er signal, 0 si aucun
+  uint8_t snrMax;
+};
+
+struct GnssSatSummary {
+  GnssConstSummary c[GNSS_CONST_COUNT];
+};
+
+void gnssSatInit(GnssSatTable& tab);
+
+const char* gnssConstName(GnssConst c);
+// Constellation d'après le talker (GP, GL, GA, GB/BD, GQ); GNSS_UNKNOWN pour GN
+GnssConst gnssConstFromTalker(const NmeaField& sentence);
+// Constellation d'après le PRN NMEA (talker GN)
+GnssConst gnssConstFromPrn(int prn);
+
+// $xxGSV,numMsg,msgNum,numSV,{prn,elev,az,snr}x1..4[,signalId]
+// Retourne vrai si la phrase est exploitable; 'cycleDone' indique le dernier message du cycle.
+bool gnssApplyGsv(GnssSatTable& tab, const NmeaField* t, int n, bool& cycleDone);
+
+// $xxGSA,mode,fix,prn x12,pdop,hdop,vdop[,systemId]: remplace la liste des PRN utilisés
+bool gnssApplyGsa(GnssSatTable& tab, const NmeaField* t, int n);
+
+void gnssSatSummarize(const GnssSatTable& tab, GnssSatSummary& out);
@@ -1,179 +1,558 @@
 #include "gps_skytraq.h"
 #include "web_server.h"
+#include "nmea_parse.h"
+#include "nmea_dispatch.h"
+#include "nmea_writer.h"
+#include "ws_binary.h"
+#include "line_ring.h"
+#include "seqlock.h"
+#include "skytraq_bin.h"
+#include "gnss_sats.h"
+#include "time_base.h"
+#include "target_fusion.h"
+#include <driver/uart.h>
 
+// Longueur max d'une ligne NMEA (82 selon la norme, marge pour PSTI/PASHR)
+static const size_t GPS_LINE_MAX = 256;
+// Silence après lequel la rafale d'une époque est considérée terminée
+static const uint32_t GPS_EPOCH_IDLE_MS = 20;
+// Écart GPS-UTC (s) pour dater les trames binaires (TOW en temps GPS): valeur par
+// défaut, remplacée par celle du récepteur (0x64/0x8E) dès qu'il la connaît
+static const int8_t GPS_LEAP_SECONDS_DEFAULT = 18;
+// Cap vrai (HDT/THS/PASHR/PSTI036) considéré présent s'il a été reçu dans cet intervalle
+static const uint32_t GPS_TRUE_HDG_RECENT_MS = 10000;
 
-static HardwareSerial* gpsSerial = nullptr;
-static String rawBuffer;
-static GpsFix lastFix;
+// UART GPS piloté directement par le driver ESP-IDF
+static const int GPS_UART_RX_RING = 8192;
+static const int GPS_UART_TX_RING = 1024;
+static const int GPS_UART_QUEUE_LEN = 32;
+static uart_port_t gpsPort = UART_NUM_1;
+static QueueHandle_t gpsUartQueue = nullptr;
+static TaskHandle_t gpsTaskHandle = nullptr;
+static bool gpsReady = false;
+static GpsUartStats gpsUartStats;
+static LineRing rawRing; // historique NMEA brut (commande r, /api/gps/raw)
+// Fix en construction (tâche gps_rx uniquement) et dernier fix publié.
+// Les lecteurs (loop, ntripTask core 0, handlers web) copient sans verrou.
+static GpsFix workFix;
+static SeqLock<GpsFix> pubFix;
+static portMUX_TYPE pubFixMux = portMUX_INITIALIZER_UNLOCKED;
 static int gpsCurRx = -1, gpsCurTx = -1;
 static bool mockEnabled = false;
+static uint32_t mockLastMs = 0;
+// Cadence du fix simulé sans cadence demandée au récepteur (Hz)
+static const uint8_t GPS_MOCK_RATE_HZ = 10;
 static GpsFix mockFix;
 static bool echoRaw = false;
+// Mode binaire SkyTraq: demandé par loop/web, appliqué par la tâche gps_rx
+static volatile bool binModeReq = false;
+static bool binModeCur = false;
+static volatile int8_t leapSeconds = GPS_LEAP_SECONDS_DEFAULT;
+static volatile bool leapFromReceiver = false;
+static volatile unsigned long lastTrueHdgMs = 0;   // millis() du dernier cap vrai NMEA (0: jamais)
+static uint8_t posRateHz = 0;                      // dernière cadence demandée (0: réglage du récepteur)
+static SkyRx skyRx;
+// Satellites (GSV/GSA): table de travail de la tâche gps_rx et résumé publié
+static GnssSatTable satTable;
+static SeqLock<GnssSatSummary> pubSats;
+static PoseHistory poseHist;
+static GpsPoseStats poseStats = {};
 
-static uint8_t nmeaChecksum(const String& s) {
-  uint8_t c = 0;
-  for (size_t i = 0; i < s.length(); ++i) c ^= (uint8_t)s[i];
-  return c;
+// --- Assemblage par époque ---
+// Les phrases portant la même heure UTC (GGA, RMC, PASHR, PSTI036) et celles
+// sans heure qui les suivent (VTG, HDT) complètent le même fix. L'époque est
+// publiée d'un bloc quand une autre heure apparaît ou après GPS_EPOCH_IDLE_MS
+// de silence (fin de rafale). Tâche gps_rx uniquement.
+static const NmeaField kNoUtc = { "", 0 };
+static bool epochOpen = false;
+static int32_t epochUtcMs = -1;
+static uint32_t epochRxMs = 0;
+static int64_t epochRxUs = 0;
+static uint32_t epochLastMs = 0;
+
+static void publishFix(const GpsFix& f, int64_t poseUs);
+static void publishSats();
+
+static void epochClose() {
+  if (!epochOpen) return;
+  epochOpen = false;
+  if (!workFix.epochMask) return;
+  workFix.utcMs = epochUtcMs;
+  workFix.rxMs = epochRxMs;
+  workFix.rxUs = epochRxUs;
+  if (epochUtcMs >= 0) {
+    uint32_t s = (uint32_t)epochUtcMs / 1000;
+    workFix.hour = (uint8_t)(s / 3600);
+    workFix.minute = (uint8_t)((s / 60) % 60);
+    workFix.second = (uint8_t)(s % 60);
+  }
+  // Association avec le dernier front PPS (date issue de RMC ou de la trame binaire);
+  // l'instant local retourné date la pose (mesure GNSS, pas arrivée UART)
+  int64_t poseUs = timeBaseOnGpsEpoch(workFix.year, workFix.month, workFix.day, epochUtcMs, epochRxUs);
+  publishFix(workFix, poseUs);
+  gpsUartStats.epochs++;
 }
 
-static double parseCoord(const String& token, const String& hemi) {
-  if (token.length() < 4) return NAN;
-  int dot = token.indexOf('.');
-  if (dot < 0) return NAN;
-  // Format NMEA: latitude ddmm.mmmm, longitude dddmm.mmmm
-  int degLen = (dot > 3) ? (dot - 2) : 2; // safe: assumes at least mm.mmmm
-  if (degLen < 2) degLen = 2; // fallback for malformed lat
-  if (degLen > 3) degLen = 3; // cap for lon
-  double deg = token.substring(0, degLen).toDouble();
-  double min = token.substring(degLen).toDouble();
-  double val = deg + (min / 60.0);
-  if (hemi == "S" || hemi == "W") val = -val;
-  return val;
+// Rattache la phrase courante à une époque (ouvre/ferme selon son heure UTC, -1 si absente)
+static void epochJoinUtc(int32_t t, uint8_t bits) {
+  if (epochOpen && t >= 0 && epochUtcMs >= 0 && t != epochUtcMs) epochClose();
+  uint32_t now = millis();
+  if (!epochOpen) {
+    epochOpen = true;
+    epochUtcMs = -1;
+    epochRxMs = now;
+    epochRxUs = timeLocalUs();
+    workFix.epochMask = 0;
+  }
+  if (t >= 0 && epochUtcMs < 0) epochUtcMs = t;
+  workFix.epochMask |= bits;
+  epochLastMs = now;
 }
 
-static void parseGGA(const String* t, int n) {
+static void epochJoin(const NmeaField& utc, uint8_t bits) {
+  epochJoinUtc(nmeaParseUtcMs(utc), bits);
+}
+
+static void epochCheckIdle() {
+  if (epochOpen && millis() - epochLastMs >= GPS_EPOCH_IDLE_MS) epochClose();
+}
+
+static bool parseGGA(const NmeaField* t, int n) {
   // $GxGGA,time,lat,N,lon,E,fix,sats,hdop,alt,M,geoid,M,age,ref*CS
-  if (n < 15) return;
-  lastFix.satellites = (uint16_t)t[7].toInt();
-  lastFix.hdop = t[8].toFloat();
-  lastFix.altitudeM = t[9].toFloat();
-  lastFix.geoidM = t[11].toFloat();
-  if (t[2].length()) lastFix.latitude = parseCoord(t[2], t[3]);
-  if (t[4].length()) lastFix.longitude = parseCoord(t[4], t[5]);
-  lastFix.fixQuality = (uint8_t)t[6].toInt();
-  lastFix.valid = (lastFix.fixQuality != 0);
-}
-
-static void parseRMC(const String* t, int n) {
+  if (n < 15) return false;
+  epochJoin(t[1], GPS_EPOCH_QUAL | (t[2].len && t[4].len ? GPS_EPOCH_POS : 0));
+  workFix.satellites = (uint16_t)nmeaToInt(t[7]);
+  workFix.hdop = nmeaToFloat(t[8]);
+  workFix.altitudeM = nmeaToFloat(t[9]);
+  workFix.geoidM = nmeaToFloat(t[11]);
+  if (t[2].len) workFix.latitude = nmeaParseCoord(t[2], t[3]);
+  if (t[4].len) workFix.longitude = nmeaParseCoord(t[4], t[5]);
+  workFix.fixQuality = (uint8_t)nmeaToInt(t[6]);
+  workFix.valid = (workFix.fixQuality != 0);
+  return true;
+}
+
+static bool parseRMC(const NmeaField* t, int n) {
   // $GxRMC,time,status,lat,N,lon,E,sog,cog,date,magvar,dir,mode,...*CS
-  if (n < 10) return;
-  lastFix.valid = (t[2] == "A");
+  if (n < 10) return false;
+  epochJoin(t[1], (t[3].len && t[5].len ? GPS_EPOCH_POS : 0) | (t[8].len ? GPS_EPOCH_COG : 0) |
+                  (t[9].len >= 6 ? GPS_EPOCH_DATE : 0));
+  workFix.valid = nmeaFieldEquals(t[2], "A");
   // lat/lon à indices 3..6
-  if (t[3].length() && t[4].length()) lastFix.latitude = parseCoord(t[3], t[4]);
-  if (t[5].length() && t[6].length()) lastFix.longitude = parseCoord(t[5], t[6]);
+  if (t[3].len && t[4].len) workFix.latitude = nmeaParseCoord(t[3], t[4]);
+  if (t[5].len && t[6].len) workFix.longitude = nmeaParseCoord(t[5], t[6]);
   // vitesse/route fond
-  if (t[7].length()) lastFix.speedKnots = t[7].toFloat();
-  if (t[8].length()) {
-    float newHdg = t[8].toFloat();
-    lastFix.headingDeg = newHdg;
-    Serial.printf("[GPS] RMC COG: %.1f° (speed: %.1fkn)\n", newHdg, lastFix.speedKnots);
-  }
+  if (t[7].len) workFix.speedKnots = nmeaToFloat(t[7]);
+  if (t[8].len) workFix.headingDeg = nmeaToFloat(t[8]);
   // date: ddmmyy
-  if (t[9].length() >= 6) {
-    lastFix.day = (uint8_t)t[9].substring(0,2).toInt();
-    lastFix.month = (uint8_t)t[9].substring(2,4).toInt();
-    lastFix.year = (uint16_t)(2000 + t[9].substring(4,6).toInt());
+  if (t[9].len >= 6) {
+    workFix.day = (uint8_t)nmeaFieldDigits(t[9], 0, 2);
+    workFix.month = (uint8_t)nmeaFieldDigits(t[9], 2, 2);
+    workFix.year = (uint16_t)(2000 + nmeaFieldDigits(t[9], 4, 2));
   }
+  // Indicateur de mode (NMEA 2.3+): A/D/E/N...
+  if (n >= 13 && t[12].len) workFix.navMode = t[12].p[0];
+  return true;
 }
 
-static void parseVTG(const String* t, int n) {
+static bool parseVTG(const NmeaField* t, int n) {
   // $..VTG,cog,T,,M,sog,N,,K*CS
-  if (n < 10) return;
-  if (t[1].length()) {
-    float newHdg = t[1].toFloat();
-    lastFix.headingDeg = newHdg;
-    Serial.printf("[GPS] VTG COG: %.1f°\n", newHdg);
-  }
-  if (t[5].length()) lastFix.speedKnots = t[5].toFloat();
+  if (n < 10) return false;
+  epochJoin(kNoUtc, t[1].len ? GPS_EPOCH_COG : 0);
+  if (t[1].len) workFix.headingDeg = nmeaToFloat(t[1]);
+  if (t[5].len) workFix.speedKnots = nmeaToFloat(t[5]);
+  return true;
 }
 
-static void parseHDT(const String* t, int n) {
+static bool parseHDT(const NmeaField* t, int n) {
   // $..HDT,heading,T*CS
-  if (n < 4) return;
-  if (t[1].length()) {
-    float newTrueHdg = t[1].toFloat();
-    lastFix.trueHeadingDeg = newTrueHdg;
-    Serial.printf("[GPS] HDT True Heading: %.1f°\n", newTrueHdg);
-  }
+  if (n < 3) return false;
+  epochJoin(kNoUtc, t[1].len ? GPS_EPOCH_HDG : 0);
+  if (t[1].len) { workFix.trueHeadingDeg = nmeaToFloat(t[1]); lastTrueHdgMs = millis(); }
+  return true;
 }
 
-static void parsePASHR(const String* t, int n) {
-  // $PASHR,hhmmss.sss,heading,T,pitch,roll,heave,course,spd,lat,lon,alt,ins,hdop,vn,*CS (variant)
-  if (n >= 4 && t[2].length()) {
-    float newTrueHdg = t[2].toFloat();
-    lastFix.trueHeadingDeg = newTrueHdg;
-    Serial.printf("[GPS] PASHR True Heading: %.1f°\n", newTrueHdg);
+static bool parsePASHR(const NmeaField* t, int n) {
+  // $PASHR,hhmmss.ss,heading,T,roll,pitch,heave,σroll,σpitch,σheading,qualité GNSS,état INS*CS
+  // (format Applanix/Trimble repris par les centrales et récepteurs double antenne:
+  // roulis avant tangage, en degrés)
+  if (n < 4) return false;
+  bool att = n >= 6 && t[4].len && t[5].len;
+  epochJoin(t[1], (t[2].len ? GPS_EPOCH_HDG : 0) | (att ? GPS_EPOCH_ATT : 0));
+  if (t[2].len) { workFix.trueHeadingDeg = nmeaToFloat(t[2]); lastTrueHdgMs = millis(); }
+  if (att) {
+    workFix.rollDeg = nmeaToFloat(t[4], NAN);
+    workFix.pitchDeg = nmeaToFloat(t[5], NAN);
   }
+  return true;
 }
 
-static void parsePSTI036(const String* t, int n) {
+static bool parseGSV(const NmeaField* t, int n) {
+  // $xxGSV,numMsg,msgNum,numSV,{prn,elev,az,snr}x4[,signal]*CS: mise à jour sur place, sans époque
+  bool cycleDone = false;
+  if (!gnssApplyGsv(satTable, t, n, cycleDone)) return false;
+  if (cycleDone) publishSats();
+  return true;
+}
+
+static bool parseGSA(const NmeaField* t, int n) {
+  // $xxGSA,mode,fix,prn x12,pdop,hdop,vdop[,system]*CS
+  if (!gnssApplyGsa(satTable, t, n)) return false;
+  epochJoin(kNoUtc, 0);
+  if (t[15].len) workFix.pdop = nmeaToFloat(t[15]);
+  if (t[17].len) workFix.vdop = nmeaToFloat(t[17]);
+  publishSats();
+  return true;
+}
+
+static bool parsePSTI030(const NmeaField* t, int n) {
+  // $PSTI,030,hhmmss.sss,status,lat,N,lon,E,alt,vE,vN,vU,ddmmyy,mode,age,ratio*CS
+  if (n < 16) return false;
+  epochJoin(t[2], GPS_EPOCH_RTK);
+  workFix.velE = nmeaToFloat(t[9], NAN);
+  workFix.velN = nmeaToFloat(t[10], NAN);
+  workFix.velU = nmeaToFloat(t[11], NAN);
+  if (t[13].len) workFix.navMode = t[13].p[0];
+  workFix.rtkAgeS = nmeaToFloat(t[14], NAN);
+  workFix.rtkRatio = nmeaToFloat(t[15], NAN);
+  return true;
+}
+
+static bool parsePSTI036(const NmeaField* t, int n) {
   // $PSTI,036,hhmmss.ss,x,x,heading,pitch,roll,*CS (SkyTraq proprietary)
-  if (n >= 7 && t[4].length()) {
-    float newTrueHdg = t[4].toFloat();
-    lastFix.trueHeadingDeg = newTrueHdg;
-    Serial.printf("[GPS] PSTI036 Heading: %.1f° (pitch: %s, roll: %s)\n", 
-                 newTrueHdg, 
-                 (t[5].length() ? t[5].c_str() : "nan"),
-                 (t[6].length() ? t[6].c_str() : "nan"));
+  if (n < 7) return false;
+  bool att = t[5].len && t[6].len;
+  epochJoin(t[2], (t[4].len ? GPS_EPOCH_HDG : 0) | (att ? GPS_EPOCH_ATT : 0));
+  if (att) {
+    workFix.pitchDeg = nmeaToFloat(t[5], NAN);
+    workFix.rollDeg = nmeaToFloat(t[6], NAN);
   }
+  if (t[4].len) { workFix.trueHeadingDeg = nmeaToFloat(t[4]); lastTrueHdgMs = millis(); }
+  return true;
 }
 
-static void parseLine(const String& line) {
-  if (!line.startsWith("$")) return;
-  int star = line.indexOf('*');
-  if (star < 0) return;
-  String payload = line.substring(1, star);
-  String cks = line.substring(star + 1);
-  cks.trim();
-  uint8_t want = (uint8_t)strtol(cks.c_str(), nullptr, 16);
-  if (nmeaChecksum(payload) != want) return;
+// Les handlers tournent dans gps_rx (priorité 3): pas de Serial.printf ici, l'écriture
+// série bloquante retarderait la vidange de la FIFO UART (valeurs visibles dans $GPS et /api/telemetry).
+// Table des phrases gérées: ajouter une ligne suffit pour enregistrer un handler.
+// Support pour GPS (GP) et GNSS multi-constellation (GN): le talker est ignoré.
+static constexpr NmeaHandlerEntry kGpsHandlers[] = {
+  { nmeaId3("GGA"), 0, "GGA", parseGGA },
+  { nmeaId3("RMC"), 0, "RMC", parseRMC },
+  { nmeaId3("VTG"), 0, "VTG", parseVTG },
+  { nmeaId3("HDT"), 0, "HDT", parseHDT },
+  { nmeaId3("THS"), 0, "THS", parseHDT }, // THS = True Heading same format as HDT
+  { nmeaIdP("PASHR"), 0, "PASHR", parsePASHR },
+  { nmeaIdP("PSTI"), 36, "PSTI036", parsePSTI036 },
+  { nmeaIdP("PSTI"), 30, "PSTI030", parsePSTI030 },
+  { nmeaId3("GSV"), 0, "GSV", parseGSV },
+  { nmeaId3("GSA"), 0, "GSA", parseGSA },
+};
+static const int kGpsHandlerCount = sizeof(kGpsHandlers) / sizeof(kGpsHandlers[0]);
+typedef NmeaDispatch<kGpsHandlers, kGpsHandlerCount> GpsDispatch;
+static_assert(GpsDispatch::collisionFree(), "collision dans la table NMEA: ajuster NMEA_DISPATCH_BITS");
+static constexpr NmeaSlotTable kGpsSlots = GpsDispatch::slots();
+
+static NmeaTypeStats gpsTypeStats[kGpsHandlerCount];
+
+// Écrivains sérialisés (tâche gps_rx, mock depuis loop) et non préemptés
+// pendant la copie: un lecteur du même cœur ne peut pas tourner indéfiniment.
+static void publishFix(const GpsFix& f, int64_t poseUs) {
+  PoseSample ps;
+  bool pose = f.valid && (f.epochMask & GPS_EPOCH_POS);
+  if (pose) {
+    ps.tUs = poseUs;
+    ps.latitude = f.latitude;
+    ps.longitude = f.longitude;
+    ps.headingDeg = isfinite(f.trueHeadingDeg) ? f.trueHeadingDeg : f.headingDeg;
+    // Attitude de cette époque uniquement: reportée d'une époque antérieure, elle serait
+    // déphasée de la houle (bateau considéré à plat)
+    bool att = (f.epochMask & GPS_EPOCH_ATT) != 0;
+    ps.pitchDeg = att ? f.pitchDeg : NAN;
+    ps.rollDeg = att ? f.rollDeg : NAN;
+    ps.hdop = f.hdop;
+    ps.fixQuality = f.fixQuality;
+  }
+  portENTER_CRITICAL(&pubFixMux);
+  pubFix.write(f);
+  if (pose) poseHistoryPush(poseHist, ps);
+  portEXIT_CRITICAL(&pubFixMux);
+  if (pose) targetFusionNotify(); // pings en attente d'une pose postérieure
+}
+
+PoseLookup gpsPoseAt(int64_t tUs, PoseSample& out) {
+  PoseLookup r = poseHistoryAt(poseHist, tUs, out);
+  poseStats.lookups[r]++;
+  return r;
+}
 
-  // split by comma
-  const int MAXT = 32;
-  String tokens[MAXT];
+int64_t gpsPoseNewestUs() { return poseHistoryNewestUs(poseHist); }
+
+int gpsCopyPoseHistory(PoseSample* out, int maxOut) { return poseHistoryCopy(poseHist, out, maxOut); }
+
+GpsPoseStats gpsGetPoseStats() {
+  GpsPoseStats s = poseStats;
+  s.samples = poseHist.head.load(std::memory_order_relaxed);
+  return s;
+}
+
+static void publishSats() {
+  GnssSatSummary s;
+  gnssSatSummarize(satTable, s);
+  portENTER_CRITICAL(&pubFixMux);
+  pubSats.write(s);
+  portEXIT_CRITICAL(&pubFixMux);
+}
+static NmeaDispatchTotals gpsTotals;
+
+static void parseLine(const char* line, size_t len) {
+  // Vues sur le buffer de ligne: aucune allocation
+  NmeaField tokens[NMEA_MAX_FIELDS];
   int idx = 0;
-  int start = 0;
-  for (int i = 0; i <= payload.length() && idx < MAXT; ++i) {
-    if (i == payload.length() || payload[i] == ',') {
-      tokens[idx++] = payload.substring(start, i);
-      start = i + 1;
+  NmeaTokResult r = nmeaTokenize(line, len, tokens, NMEA_MAX_FIELDS, idx);
+  if (r == NMEA_TOK_NOT_NMEA || idx == 0) { gpsTotals.notNmea++; return; }
+
+  uint32_t key; uint16_t sub;
+  int h = nmeaSentenceKey(tokens, idx, key, sub) ? GpsDispatch::find(kGpsSlots, key, sub) : -1;
+  if (h < 0) {
+    if (r == NMEA_TOK_BAD_CHECKSUM) gpsTotals.cksUnknown++; else gpsTotals.ignored++;
+    return;
+  }
+  if (r == NMEA_TOK_BAD_CHECKSUM) { gpsTypeStats[h].cksFail++; return; }
+  if (kGpsHandlers[h].handler(tokens, idx)) gpsTypeStats[h].hits++;
+  else gpsTypeStats[h].misses++;
+}
+
+// Traitement d'une ligne complète (tâche d'ingestion ou mock)
+static void handleLine(char* line, size_t len) {
+  while (len && (line[len-1] == '\r' || line[len-1] == '\n' || line[len-1] == ' ' || line[len-1] == '\t')) len--;
+  if (!len) return;
+  line[len] = '\0';
+  gpsUartStats.lines++;
+  lineRingAppend(rawRing, line, len);
+  parseLine(line, len);
+}
+
+// --- Trames binaires SkyTraq ---
+static void applyNavData(const SkyNavData& d) {
+  int32_t utcMs = -1;
+  uint16_t y = 0; uint8_t mo = 0, dd = 0;
+  if (d.week) skyGpsToUtc(d.week, d.tow10ms * 10, (uint32_t)leapSeconds, y, mo, dd, utcMs);
+  // Une trame 0xA8 est une époque complète: clôture de l'époque précédente puis publication
+  epochJoinUtc(utcMs, GPS_EPOCH_POS | GPS_EPOCH_QUAL | GPS_EPOCH_COG | (d.week ? GPS_EPOCH_DATE : 0));
+  if (d.week) { workFix.year = y; workFix.month = mo; workFix.day = dd; }
+  workFix.fixQuality = d.fixMode == 0 ? 0 : (d.fixMode == 3 ? 2 : 1);
+  workFix.valid = (d.fixMode != 0);
+  workFix.satellites = d.svs;
+  workFix.latitude = d.latE7 * 1e-7;
+  workFix.longitude = d.lonE7 * 1e-7;
+  workFix.altitudeM = d.altMslCm * 0.01f;
+  workFix.geoidM = (d.altEllCm - d.altMslCm) * 0.01f;
+  workFix.hdop = d.hdop * 0.01f;
+  workFix.pdop = d.pdop * 0.01f;
+  workFix.vdop = d.vdop * 0.01f;
+  // Route/vitesse fond dérivées de la vitesse ECEF (pas de cap vrai dans 0xA8)
+  float vN, vE;
+  skyNavVelocityNE(d, vN, vE);
+  float sog = sqrtf(vN * vN + vE * vE);
+  workFix.speedKnots = sog * 1.943844f;
+  if (sog > 0.2f) {
+    float cog = atan2f(vE, vN) * 180.0f / PI;
+    workFix.headingDeg = cog < 0 ? cog + 360.0f : cog;
+  }
+  epochClose();
+}
+
+static void handleBinFrame(const uint8_t* p, uint16_t len) {
+  gpsUartStats.binFrames++;
+  switch (p[0]) {
+    case SKYBIN_MSG_NAV_DATA: {
+      SkyNavData d;
+      if (skyDecodeNavData(p, len, d)) applyNavData(d);
+      break;
+    }
+    case SKYBIN_MSG_GNSS: {
+      SkyGpsTime t;
+      // Secondes intercalaires de l'almanach (b2); sinon la valeur du firmware reste un repli
+      if (skyDecodeGpsTime(p, len, t)) {
+        if (t.valid & 0x04) { leapSeconds = t.currentLeapS; leapFromReceiver = true; }
+        else if (!leapFromReceiver && t.defaultLeapS > 0) leapSeconds = t.defaultLeapS;
+      }
+      break;
     }
+    case SKYBIN_MSG_ACK: gpsUartStats.binAck++; break;
+    case SKYBIN_MSG_NACK: gpsUartStats.binNack++; break;
+    default: break;
   }
-  if (idx == 0) return;
-
-  String type = tokens[0];
-  // Support pour GPS (GP) et GNSS multi-constellation (GN)
-  if (type.endsWith("GGA")) parseGGA(tokens, idx);
-  else if (type.endsWith("RMC")) parseRMC(tokens, idx);
-  else if (type.endsWith("VTG")) parseVTG(tokens, idx);
-  else if (type.endsWith("HDT")) parseHDT(tokens, idx);
-  else if (type.endsWith("THS")) parseHDT(tokens, idx); // THS = True Heading same format as HDT
-  else if (type.startsWith("PASHR")) parsePASHR(tokens, idx);
-  else if (type.startsWith("PSTI") && tokens[1] == "036") parsePSTI036(tokens, idx);
-  
-  // Debug pour voir le fixQuality reçu (supprimé pour éviter flood)
-  // if (type.endsWith("GGA") && idx > 6) {
-  //   Serial.printf("[GPS] GGA fixQuality=%s (raw field 6)\n", tokens[6].c_str());
-  // }
-}
-
-void gpsBegin(HardwareSerial& serial, uint32_t baud, int rxPin, int txPin) {
-  gpsSerial = &serial;
+}
+
+// Mode binaire: lecture par blocs et machine à états (trames A0 A1 et lignes NMEA de repli)
+static void readBinaryData(size_t avail) {
+  uint8_t chunk[128];
+  while (avail) {
+    int n = uart_read_bytes(gpsPort, chunk, min(avail, sizeof(chunk)), 0);
+    if (n <= 0) break;
+    avail -= (size_t)n;
+    gpsUartStats.bytes += n;
+    if (mockEnabled) continue;
+    for (int i = 0; i < n; ++i) {
+      switch (skyRxFeed(skyRx, chunk[i])) {
+        case SKY_RX_FRAME: handleBinFrame(skyRx.payload, skyRx.len); break;
+        case SKY_RX_NMEA: handleLine(skyRx.line, skyRx.lineLen); break;
+        case SKY_RX_BAD_CKS: gpsUartStats.binCksErr++; break;
+        case SKY_RX_BAD_FRAME: gpsUartStats.binBadFrame++; break;
+        default: break;
+      }
+    }
+  }
+}
+
+// Lit 'count' octets (ligne + '\n') depuis le buffer RX du driver
+static void readPatternLine(int count) {
+  static char lineBuf[GPS_LINE_MAX + 2];
+  if (count <= 0) return;
+  if ((size_t)count > GPS_LINE_MAX + 1) {
+    // Ligne trop longue: purgée par blocs et ignorée
+    char discard[64];
+    while (count > 0) {
+      int n = uart_read_bytes(gpsPort, (uint8_t*)discard, min(count, (int)sizeof(discard)), pdMS_TO_TICKS(10));
+      if (n <= 0) break;
+      count -= n;
+    }
+    gpsUartStats.longLines++;
+    return;
+  }
+  int n = uart_read_bytes(gpsPort, (uint8_t*)lineBuf, count, pdMS_TO_TICKS(10));
+  if (n <= 0) return;
+  gpsUartStats.bytes += n;
+  if (mockEnabled) return; // en simulation, le mock publie le fix et l'historique
+  handleLine(lineBuf, (size_t)n);
+}
+
+static void resetRx() {
+  uart_flush_input(gpsPort);
+  xQueueReset(gpsUartQueue);
+}
+
+// Bascule texte/binaire côté tâche: motif '\n' inutile (et trompeur) dans un flux binaire
+static void applyBinaryMode(bool en) {
+  if (en) uart_disable_pattern_det_intr(gpsPort);
+  else uart_enable_pattern_det_baud_intr(gpsPort, '\n', 1, 9, 0, 0);
+  uart_pattern_queue_reset(gpsPort, GPS_UART_QUEUE_LEN);
+  resetRx();
+  skyRxInit(skyRx);
+  // 0xA8 ne porte pas de cap vrai: ne pas laisser un ancien HDT masquer la route fond
+  if (en) workFix.trueHeadingDeg = NAN;
+  binModeCur = en;
+  if (en) {
+    // Secondes intercalaires courantes (TOW 0xA8 en temps GPS): réponse 0x64/0x8E
+    uint8_t q[2] = { SKYBIN_MSG_GNSS, SKYBIN_SUB_QUERY_GPS_TIME };
+    uint8_t frame[16];
+    size_t n = skyBuildFrame(q, sizeof(q), frame, sizeof(frame));
+    if (n) uart_write_bytes(gpsPort, (const char*)frame, n);
+  }
+}
+
+// --- Tâche d'ingestion GPS: pilotée par la file d'événements UART (détection de motif '\n') ---
+static void gpsIngestTask(void* arg) {
+  (void)arg;
+  uart_event_t ev;
+  for (;;) {
+    // Réveil périodique pour clore l'époque en fin de rafale
+    if (xQueueReceive(gpsUartQueue, &ev, pdMS_TO_TICKS(GPS_EPOCH_IDLE_MS)) != pdTRUE) {
+      epochCheckIdle();
+      if (binModeReq != binModeCur) applyBinaryMode(binModeReq);
+      continue;
+    }
+    if (binModeReq != binModeCur) { applyBinaryMode(binModeReq); continue; }
+    switch (ev.type) {
+      case UART_DATA:
+        // Texte: lignes traitées sur UART_PATTERN_DET. Binaire: tout ce qui est bufferisé.
+        if (binModeCur) {
+          size_t avail = 0;
+          uart_get_buffered_data_len(gpsPort, &avail);
+          readBinaryData(avail);
+        }
+        break;
+      case UART_PATTERN_DET: {
+        if (binModeCur) break;
+        int pos = uart_pattern_pop_pos(gpsPort);
+        if (pos < 0) {
+          // File des positions saturée: impossible de resynchroniser proprement
+          gpsUartStats.patternOvf++;
+          resetRx();
+        } else {
+          readPatternLine(pos + 1);
+        }
+        break;
+      }
+      case UART_FIFO_OVF:
+        gpsUartStats.fifoOvf++;
+        resetRx();
+        break;
+      case UART_BUFFER_FULL:
+        gpsUartStats.bufferFull++;
+        resetRx();
+        break;
+      case UART_FRAME_ERR:
+        gpsUartStats.frameErr++;
+        break;
+      case UART_PARITY_ERR:
+        gpsUartStats.parityErr++;
+        break;
+      case UART_BREAK:
+        gpsUartStats.breaks++;
+        break;
+      default:
+        break;
+    }
+    epochCheckIdle();
+  }
+}
+
+void gpsBegin(uart_port_t port, uint32_t baud, int rxPin, int txPin) {
+  gpsPort = port;
   gpsCurRx = rxPin; gpsCurTx = txPin;
-  serial.begin(baud, SERIAL_8N1, rxPin, txPin);
-  // Timeout plus long pour laisser le temps à une ligne NMEA complète d'arriver (ex: 9600 bps)
-  serial.setTimeout(200);
-  rawBuffer.reserve(4096);
+  lineRingInit(rawRing);
+  gnssSatInit(satTable);
+  uart_config_t cfg = {};
+  cfg.baud_rate = (int)baud;
+  cfg.data_bits = UART_DATA_8_BITS;
+  cfg.parity = UART_PARITY_DISABLE;
+  cfg.stop_bits = UART_STOP_BITS_1;
+  cfg.flow_ctrl = UART_HW_FLOW_CTRL_DISABLE;
+  cfg.source_clk = UART_SCLK_APB;
+  // Grand anneau RX (~90 ms à 921600 bps) et TX pour le flux RTCM
+  if (uart_driver_install(port, GPS_UART_RX_RING, GPS_UART_TX_RING, GPS_UART_QUEUE_LEN, &gpsUartQueue, 0) != ESP_OK) {
+    Serial.println("[GPS] uart_driver_install échoué");
+    return;
+  }
+  uart_param_config(port, &cfg);
+  uart_set_pin(port, txPin, rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+  uart_enable_pattern_det_baud_intr(port, '\n', 1, 9, 0, 0);
+  uart_pattern_queue_reset(port, GPS_UART_QUEUE_LEN);
+  gpsReady = true;
+  // Priorité au-dessus de loop() (1) sur le même cœur: une requête HTTP lente ne bloque plus l'ingestion
+  xTaskCreatePinnedToCore(gpsIngestTask, "gps_rx", 4096, nullptr, 3, &gpsTaskHandle, 1);
+}
+
+// Nombre de phrases à checksum valide vues par le dispatcher (+ trames binaires valides)
+static uint32_t validSentenceCount() {
+  uint32_t n = gpsTotals.ignored;
+  for (int i = 0; i < kGpsHandlerCount; ++i) n += gpsTypeStats[i].hits + gpsTypeStats[i].misses;
+  return n + gpsUartStats.binFrames;
 }
 
 bool gpsAutoDetectBaud(uint32_t& selectedBaud) {
-  if (!gpsSerial) return false;
+  if (!gpsReady) return false;
   // Essayer d'abord les vitesses les plus courantes (115200, 9600), puis autres, puis 921600 en dernier
   const uint32_t candidates[] = {115200, 9600, 57600, 38400, 19200, 921600};
   for (uint32_t b : candidates) {
-    gpsSerial->end();
-    gpsSerial->begin(b, SERIAL_8N1, gpsCurRx, gpsCurTx);
+    uart_set_baudrate(gpsPort, b);
+    resetRx();
+    uint32_t before = validSentenceCount();
     unsigned long t0 = millis();
-    int hits = 0;
     while (millis() - t0 < 1200) { // Fenêtre plus large pour laisser passer au moins 1-2 trames à 9600 bps
-      if (gpsSerial->available()) {
-        String line = gpsSerial->readStringUntil('\n');
-        line.trim();
-        if (line.startsWith("$") && line.indexOf('*') > 0) {
-          hits++;
-          if (hits >= 1) { selectedBaud = b; return true; }
-        }
-      }
+      if (validSentenceCount() != before) { selectedBaud = b; return true; }
       delay(5);
     }
   }
@@ -181,90 +560,145 @@ bool gpsAutoDetectBaud(uint32_t& selectedBaud) {
 }
 
 void gpsPoll() {
-  if (!gpsSerial) return;
+  if (!gpsReady) return;
   if (mockEnabled) {
-    // synthèse minimale NMEA pour RAW et mise à jour lastFix
-    lastFix = mockFix;
+    // synthèse minimale NMEA pour RAW et publication du fix simulé (une époque complète),
+    // à la cadence d'un récepteur: loop() appelle gpsPoll() sans délai
+    uint32_t nowMs = millis();
+    uint32_t periodMs = 1000u / (posRateHz ? posRateHz : GPS_MOCK_RATE_HZ);
+    if (mockLastMs != 0 && nowMs - mockLastMs < periodMs) return;
+    mockLastMs = nowMs;
+    GpsFix mf = mockFix;
+    mf.rxMs = nowMs;
+    mf.rxUs = timeLocalUs();
+    mf.epochMask = GPS_EPOCH_POS | GPS_EPOCH_QUAL | GPS_EPOCH_COG | GPS_EPOCH_HDG;
+    if (isfinite(mf.pitchDeg) && isfinite(mf.rollDeg)) mf.epochMask |= GPS_EPOCH_ATT;
+    publishFix(mf, mf.rxUs);
     char latStr[16] = ""; char lonStr[16] = ""; char ns='N', ew='E';
-    double alat=lastFix.latitude, alon=lastFix.longitude;
+    double alat=mockFix.latitude, alon=mockFix.longitude;
     if (alat<0){ns='S'; alat=-alat;} if(alon<0){ew='W'; alon=-alon;}
     int latd=(int)alat; double latm=(alat-latd)*60.0; snprintf(latStr,sizeof(latStr),"%02d%07.4f",latd,latm);
     int lond=(int)alon; double lonm=(alon-lond)*60.0; snprintf(lonStr,sizeof(lonStr),"%03d%07.4f",lond,lonm);
-    char rmc[160]; snprintf(rmc,sizeof(rmc),"GPRMC,000000,A,%s,%c,%s,%c,%.1f,%.1f,010100,,",latStr,ns,lonStr,ew,(double)lastFix.speedKnots,(double)lastFix.headingDeg);
+    char rmc[160]; snprintf(rmc,sizeof(rmc),"GPRMC,000000,A,%s,%c,%s,%c,%.1f,%.1f,010100,,",latStr,ns,lonStr,ew,(double)mockFix.speedKnots,(double)mockFix.headingDeg);
     uint8_t cks=0; for(size_t i=0;i<strlen(rmc);++i) cks^=(uint8_t)rmc[i];
-    char frm[180]; snprintf(frm,sizeof(frm),"$%s*%02X\n",rmc,cks);
-    if (rawBuffer.length() > 8192) rawBuffer.remove(0, rawBuffer.length() - 4096);
-    rawBuffer += frm;
+    char frm[180]; int flen = snprintf(frm,sizeof(frm),"$%s*%02X",rmc,cks);
+    if (flen > 0) lineRingAppend(rawRing, frm, min((size_t)flen, sizeof(frm) - 1));
     return;
   }
-  // Lecture non bloquante, accumulation jusqu'à fin de ligne (\r ou \n)
-  static String lineBuf;
-  while (gpsSerial->available()) {
-    char ch = (char)gpsSerial->read();
-    if (ch == '\r' || ch == '\n') {
-      if (lineBuf.length()) {
-        String line = lineBuf; line.trim(); lineBuf = "";
-        if (!line.isEmpty()) {
-          if (rawBuffer.length() > 8192) rawBuffer.remove(0, rawBuffer.length() - 4096);
-          rawBuffer += line + "\n";
-          // Echo optionnel des trames NMEA sur le moniteur série et via WebSocket (debug)
-          if (echoRaw) {
-            Serial.println(line);
-            String esc = line; esc.replace("\\", "\\\\"); esc.replace("\"", "\\\"");
-            String js = String("{\"nmea\":\"") + esc + "\"}";
-            wsBroadcastJson(js);
-          }
-          parseLine(line);
-        }
-      }
-    } else {
-      lineBuf += ch;
-      if (lineBuf.length() > 256) lineBuf.remove(0, lineBuf.length() - 256);
+  // Echo optionnel des trames NMEA (debug): relu depuis l'historique, hors tâche d'ingestion
+  static uint32_t echoCursor = 0;
+  if (!echoRaw) { echoCursor = lineRingHead(rawRing); return; }
+  lineRingForEachSince(rawRing, echoCursor, [](const char* line, size_t len, void*){
+    Serial.write((const uint8_t*)line, len); Serial.println();
+    if (wsWantBinary(true)) {
+      uint8_t bin[NMEA_WS_HEADROOM + 1 + 120];
+      size_t n = len < 120 ? len : 120;
+      bin[NMEA_WS_HEADROOM] = WSB_NMEA;
+      memcpy(bin + NMEA_WS_HEADROOM + 1, line, n);
+      wsBroadcastBinary(bin, n + 1, true);
     }
-  }
+    if (!wsWantText()) return;
+    String esc; esc.reserve(len + 16); esc.concat(line, len);
+    esc.replace("\\", "\\\\"); esc.replace("\"", "\\\"");
+    String js = String("{\"nmea\":\"") + esc + "\"}";
+    wsBroadcastJson(js);
+  }, nullptr);
 }
 
-GpsFix gpsGetFix() {
-  return lastFix;
+uint32_t gpsReadFix(GpsFix& out) {
+  return pubFix.read(out);
 }
 
-String gpsGetRaw(int maxLines) {
-  if (maxLines <= 0) return String();
-  // return last N lines from buffer
-  int count = 0;
-  int pos = rawBuffer.length() - 1;
-  while (pos >= 0 && count < maxLines) {
-    if (rawBuffer[pos] == '\n') count++;
-    pos--;
-  }
-  int start = max(0, pos + 1);
-  return rawBuffer.substring(start);
+uint32_t gpsFixVersion() {
+  return pubFix.version();
+}
+
+int gpsForEachRawLine(int maxLines, LineRingVisitor fn, void* ctx) {
+  return lineRingForEachLast(rawRing, maxLines, fn, ctx);
 }
 
 void gpsFeedRtcm(const uint8_t* data, size_t len) {
-  if (!gpsSerial || !data || len == 0) return;
-  gpsSerial->write(data, len);
+  if (!gpsReady || !data || len == 0) return;
+  uart_write_bytes(gpsPort, (const char*)data, len);
 }
 
 void gpsSwapPins() {
-  if (!gpsSerial) return;
+  if (!gpsReady) return;
   int newRx = gpsCurTx;
   int newTx = gpsCurRx;
-  // Re-open UART with swapped pins, keep same baud
-  uint32_t baud = 115200; // default
-  // There is no direct getter; assume 115200 as used at begin.
-  gpsSerial->end();
-  gpsSerial->begin(baud, SERIAL_8N1, newRx, newTx);
+  // Re-router les broches sans réinstaller le driver: le baud courant est conservé
+  uart_set_pin(gpsPort, newTx, newRx, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+  resetRx();
   gpsCurRx = newRx; gpsCurTx = newTx;
 }
 
-void gpsSetMockEnabled(bool enabled) { mockEnabled = enabled; }
+GpsUartStats gpsGetUartStats() { return gpsUartStats; }
+
+bool gpsTrueHeadingRecent() {
+  unsigned long t = lastTrueHdgMs;
+  return t && millis() - t < GPS_TRUE_HDG_RECENT_MS;
+}
+
+bool gpsSetBinaryMode(bool enabled, bool force) {
+  if (!gpsReady) return false;
+  // Le type de sortie 0x09 est exclusif (NMEA ou binaire, pas de mélange) et 0xA8 ne porte
+  // ni cap vrai ni attitude: sur un récepteur à double antenne, le binaire ferait
+  // retomber l'azimut des pings sur la route fond (sans valeur à l'arrêt)
+  if (enabled && !binModeCur && gpsTrueHeadingRecent() && !force) {
+    Serial.println("[GPS] Binaire refusé: cap vrai NMEA (HDT/PSTI036/PASHR) présent, perdu en 0xA8");
+    return false;
+  }
+  if (enabled) Serial.println("[GPS] Binaire 0xA8: pas de cap vrai, cap = route fond (> 0,2 m/s)");
+  // Message 0x09: type de sortie, attribut 0 = SRAM (le récepteur redémarre en NMEA)
+  uint8_t cfg[3] = { SKYBIN_MSG_CFG_MSG_TYPE, enabled ? SKYBIN_OUT_BINARY : SKYBIN_OUT_NMEA, 0 };
+  uint8_t frame[16];
+  size_t n = skyBuildFrame(cfg, sizeof(cfg), frame, sizeof(frame));
+  if (n) uart_write_bytes(gpsPort, (const char*)frame, n);
+  binModeReq = enabled;
+  return true;
+}
+
+bool gpsGetBinaryMode() { return binModeCur; }
+
+bool gpsSetUpdateRate(uint8_t hz) {
+  if (!gpsReady || !skyPosRateSupported(hz)) return false;
+  // Message 0x0E: cadence de position, attribut 0 = SRAM (réappliquée au démarrage)
+  uint8_t cfg[3] = { SKYBIN_MSG_CFG_POS_RATE, hz, 0 };
+  uint8_t frame[16];
+  size_t n = skyBuildFrame(cfg, sizeof(cfg), frame, sizeof(frame));
+  if (!n) return false;
+  uart_write_bytes(gpsPort, (const char*)frame, n);
+  posRateHz = hz;
+  return true;
+}
+
+uint8_t gpsGetUpdateRate() { return posRateHz; }
+
+int8_t gpsGetLeapSeconds(bool* fromReceiver) {
+  if (fromReceiver) *fromReceiver = leapFromReceiver;
+  return leapSeconds;
+}
+
+void gpsSetMockEnabled(bool enabled) { mockEnabled = enabled; mockLastMs = 0; }
 void gpsSetMockFix(const GpsFix& fix) {
   mockFix = fix;
   if (!isfinite(mockFix.trueHeadingDeg)) mockFix.trueHeadingDeg = mockFix.headingDeg;
   mockFix.valid = true;
 }
 
+int gpsGetSentenceStats(GpsSentenceStat* out, int maxOut) {
+  int n = 0;
+  for (int i = 0; i < kGpsHandlerCount && n < maxOut; ++i, ++n) {
+    out[n].name = kGpsHandlers[i].name;
+    out[n].stats = gpsTypeStats[i];
+  }
+  return n;
+}
+
+NmeaDispatchTotals gpsGetDispatchTotals() { return gpsTotals; }
+
+void gpsReadSatSummary(GnssSatSummary& out) { pubSats.read(out); }
+
 void gpsSetEchoRaw(bool enabled) { echoRaw = enabled; }
 bool gpsGetEchoRaw() { return echoRaw; }
 
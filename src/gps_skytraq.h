@@ -1,12 +1,20 @@
 #pragma once
 #include <Arduino.h>
+#include "nmea_dispatch.h"
+#include "line_ring.h"
+#include "gnss_sats.h"
+#include "pose_history.h"
+#include <driver/uart.h>
 
+// POD uniquement (aucune String): publié par seqlock, copie sans allocation
 struct GpsFix {
   bool valid = false;
   double latitude = 0.0;
   double longitude = 0.0;
   float headingDeg = NAN;         // from VTG
   float trueHeadingDeg = NAN;     // from HDT/PASHR
+  float pitchDeg = NAN;           // from PSTI036/PASHR: tangage (étrave haute +)
+  float rollDeg = NAN;            // from PSTI036/PASHR: roulis (tribord bas +)
   float speedKnots = NAN;         // from RMC/VTG
   uint16_t satellites = 0;        // from GGA
   float hdop = NAN;               // from GGA
@@ -15,25 +23,109 @@ struct GpsFix {
   uint8_t fixQuality = 0;         // from GGA field 6 (0=invalid,1=GPS,2=DGPS,4=RTK Fix,5=RTK Float)
   float pdop = NAN;               // optional
   float vdop = NAN;               // optional
-  String navMode;                 // A/D/E
+  char navMode = 0;               // A/D/E/F/R (RMC/PSTI030 mode indicator), 0 si absent
+  float rtkAgeS = NAN;            // from PSTI030: âge des corrections (s)
+  float rtkRatio = NAN;           // from PSTI030: ratio de validation AR
+  float velE = NAN;               // from PSTI030: vitesse ENU (m/s)
+  float velN = NAN;
+  float velU = NAN;
   uint16_t year = 0;              // UTC
   uint8_t month = 0;
   uint8_t day = 0;
   uint8_t hour = 0;
   uint8_t minute = 0;
   uint8_t second = 0;
+  // Époque: toutes les phrases d'une même seconde UTC, publiées ensemble
+  int32_t utcMs = -1;             // heure UTC de l'époque (ms depuis minuit), -1 si inconnue
+  uint32_t rxMs = 0;              // millis() à l'arrivée de la 1re phrase de l'époque
+  int64_t rxUs = 0;               // idem, horloge locale µs (timeLocalUs)
+  uint8_t epochMask = 0;          // GPS_EPOCH_* rafraîchis dans cette époque (sinon reportés)
 };
 
-void gpsBegin(HardwareSerial& serial, uint32_t baud, int rxPin, int txPin);
+// Contenu d'une époque (GpsFix::epochMask)
+static const uint8_t GPS_EPOCH_POS = 0x01;   // position (GGA/RMC)
+static const uint8_t GPS_EPOCH_QUAL = 0x02;  // qualité, satellites, HDOP, altitude (GGA)
+static const uint8_t GPS_EPOCH_COG = 0x04;   // route/vitesse fond (RMC/VTG)
+static const uint8_t GPS_EPOCH_HDG = 0x08;   // cap vrai (HDT/THS/PASHR/PSTI036)
+static const uint8_t GPS_EPOCH_DATE = 0x10;  // date (RMC)
+static const uint8_t GPS_EPOCH_RTK = 0x20;   // âge/ratio RTK, vitesse ENU (PSTI030)
+static const uint8_t GPS_EPOCH_ATT = 0x40;   // tangage/roulis (PSTI036/PASHR)
+
+// Compteurs de la tâche d'ingestion UART (trames perdues visibles)
+struct GpsUartStats {
+  uint32_t lines;       // lignes complètes reçues
+  uint32_t bytes;
+  uint32_t fifoOvf;     // débordement FIFO matériel
+  uint32_t bufferFull;  // anneau RX du driver plein
+  uint32_t frameErr;
+  uint32_t parityErr;
+  uint32_t breaks;
+  uint32_t patternOvf;  // file des positions '\n' saturée
+  uint32_t longLines;   // lignes > GPS_LINE_MAX ignorées
+  uint32_t epochs;      // époques publiées
+  // Mode binaire SkyTraq
+  uint32_t binFrames;   // trames A0 A1 valides
+  uint32_t binCksErr;
+  uint32_t binBadFrame; // longueur/fin de trame invalides, lignes tronquées
+  uint32_t binAck;      // ACK / NACK de configuration
+  uint32_t binNack;
+};
+
+// Installe le driver UART (file d'événements + détection '\n') et lance la tâche d'ingestion
+void gpsBegin(uart_port_t port, uint32_t baud, int rxPin, int txPin);
+// À appeler dans loop(): mock et écho debug uniquement (l'ingestion est dans sa tâche)
 void gpsPoll();
-GpsFix gpsGetFix();
-String gpsGetRaw(int maxLines);
+GpsUartStats gpsGetUartStats();
+// Copie cohérente de la dernière époque publiée (sans verrou ni allocation, tout cœur).
+// Retourne le numéro de publication.
+uint32_t gpsReadFix(GpsFix& out);
+// Numéro de la dernière publication (détecter un nouveau fix sans copie)
+uint32_t gpsFixVersion();
+// Parcourt les maxLines dernières trames brutes (sans '\n'), copiées et revalidées une à une
+int gpsForEachRawLine(int maxLines, LineRingVisitor fn, void* ctx);
 void gpsFeedRtcm(const uint8_t* data, size_t len);
 void gpsSwapPins();
 // Simulation / Mock helpers
 void gpsSetMockEnabled(bool enabled);
 void gpsSetMockFix(const GpsFix& fix);
 
+// Statistiques de dispatch NMEA par type (hits / rejets / checksum faux)
+struct GpsSentenceStat {
+  const char* name;
+  NmeaTypeStats stats;
+};
+int gpsGetSentenceStats(GpsSentenceStat* out, int maxOut);
+NmeaDispatchTotals gpsGetDispatchTotals();
+
+// Résumé satellites par constellation (GSV/GSA), copie cohérente sans allocation
+void gpsReadSatSummary(GnssSatSummary& out);
+
+// Historique de pose (une entrée par époque valide, datée par le PPS si disponible)
+struct GpsPoseStats {
+  uint32_t samples;     // poses enregistrées depuis le boot
+  uint32_t lookups[3];  // par résultat PoseLookup (none, interp, extrap)
+};
+// Pose du bateau à l'instant local tUs (timeLocalUs); un seul lecteur (fusion cible)
+PoseLookup gpsPoseAt(int64_t tUs, PoseSample& out);
+GpsPoseStats gpsGetPoseStats();
+int64_t gpsPoseNewestUs();
+// Dernières poses, de la plus ancienne à la plus récente (trace)
+int gpsCopyPoseHistory(PoseSample* out, int maxOut);
+
+// Sortie binaire SkyTraq (0xA8, plus compacte que NMEA) ou NMEA texte.
+// Les lignes NMEA restent décodées en mode binaire (repli si le récepteur refuse).
+// 0xA8 ne porte pas de cap vrai: refusé (faux) si un cap vrai NMEA a été reçu
+// récemment, sauf 'force' (le cap devient la route fond).
+bool gpsSetBinaryMode(bool enabled, bool force = false);
+bool gpsGetBinaryMode();
+// Cap vrai NMEA (HDT/THS/PASHR/PSTI036) reçu dans les 10 dernières secondes
+bool gpsTrueHeadingRecent();
+// Cadence de position du récepteur (message 0x0E, SRAM): 1, 2, 4, 5, 8, 10 ou 20 Hz; faux si refusée
+bool gpsSetUpdateRate(uint8_t hz);
+uint8_t gpsGetUpdateRate();   // 0: jamais configurée (réglage du récepteur)
+// Écart GPS-UTC utilisé pour dater 0xA8 (lu du récepteur en mode binaire, sinon 18 s)
+int8_t gpsGetLeapSeconds(bool* fromReceiver = nullptr);
+
 // Dev/Debug helpers
 bool gpsAutoDetectBaud(uint32_t& selectedBaud);
 void gpsSetEchoRaw(bool enabled);
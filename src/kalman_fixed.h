@@ -0,0 +1,203 @@
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+// Matrices et filtre de Kalman à dimensions fixées à la compilation, en float
+// uniquement (FPU simple précision de l'ESP32). Les boucles portent sur des
+// bornes constantes: à -O2 le compilateur les déroule entièrement pour les
+// petites tailles (4x4, 2x2), sans allocation ni indirection.
+// Mise à jour en forme de Joseph, P = (I-KH) P (I-KH)' + K R K', qui reste
+// symétrique définie positive malgré les arrondis float. Les variantes
+// *Residual prennent une innovation déjà formée (EKF, résidus angulaires).
+// Module sans dépendance Arduino, en-tête seul.
+
+template<int R, int C>
+struct KMat {
+  float m[R][C];
+
+  float& operator()(int r, int c) { return m[r][c]; }
+  float operator()(int r, int c) const { return m[r][c]; }
+
+  static KMat zero() {
+    KMat z;
+    for (int r = 0; r < R; ++r) for (int c = 0; c < C; ++c) z.m[r][c] = 0.0f;
+    return z;
+  }
+  static KMat identity() {
+    KMat z = zero();
+    for (int i = 0; i < R && i < C; ++i) z.m[i][i] = 1.0f;
+    return z;
+  }
+};
+
+template<int R, int K, int C>
+inline KMat<R, C> operator*(const KMat<R, K>& a, const KMat<K, C>& b) {
+  KMat<R, C> o;
+  for (int r = 0; r < R; ++r) {
+    for (int c = 0; c < C; ++c) {
+      float s = 0.0f;
+      for (int k = 0; k < K; ++k) s += a.m[r][k] * b.m[k][c];
+      o.m[r][c] = s;
+    }
+  }
+  return o;
+}
+
+template<int R, int C>
+inline KMat<R, C> operator+(const KMat<R, C>& a, const KMat<R, C>& b) {
+  KMat<R, C> o;
+  for (int r = 0; r < R; ++r) for (int c = 0; c < C; ++c) o.m[r][c] = a.m[r][c] + b.m[r][c];
+  return o;
+}
+
+template<int R, int C>
+inline KMat<R, C> operator-(const KMat<R, C>& a, const KMat<R, C>& b) {
+  KMat<R, C> o;
+  for (int r = 0; r < R; ++r) for (int c = 0; c < C; ++c) o.m[r][c] = a.m[r][c] - b.m[r][c];
+  return o;
+}
+
+template<int R, int C>
+inline KMat<C, R> transpose(const KMat<R, C>& a) {
+  KMat<C, R> o;
+  for (int r = 0; r < R; ++r) for (int c = 0; c < C; ++c) o.m[c][r] = a.m[r][c];
+  return o;
+}
+
+// a * b' sans former la transposée
+template<int R, int K, int C>
+inline KMat<R, C> mulTransB(const KMat<R, K>& a, const KMat<C, K>& b) {
+  KMat<R, C> o;
+  for (int r = 0; r < R; ++r) {
+    for (int c = 0; c < C; ++c) {
+      float s = 0.0f;
+      for (int k = 0; k < K; ++k) s += a.m[r][k] * b.m[c][k];
+      o.m[r][c] = s;
+    }
+  }
+  return o;
+}
+
+// Symétrisation (moyenne des termes croisés)
+template<int N>
+inline void symmetrize(KMat<N, N>& a) {
+  for (int r = 0; r < N; ++r) {
+    for (int c = r + 1; c < N; ++c) {
+      float v = 0.5f * (a.m[r][c] + a.m[c][r]);
+      a.m[r][c] = v; a.m[c][r] = v;
+    }
+  }
+}
+
+// Déterminant des petites matrices d'innovation
+inline float det(const KMat<1, 1>& s) { return s.m[0][0]; }
+inline float det(const KMat<2, 2>& s) { return s.m[0][0] * s.m[1][1] - s.m[0][1] * s.m[1][0]; }
+
+// Inverse des petites matrices symétriques (innovation S); faux si singulière
+inline bool invertSym(const KMat<1, 1>& s, KMat<1, 1>& inv) {
+  if (!(s.m[0][0] > 0.0f)) return false;
+  inv.m[0][0] = 1.0f / s.m[0][0];
+  return true;
+}
+
+inline bool invertSym(const KMat<2, 2>& s, KMat<2, 2>& inv) {
+  float det = s.m[0][0] * s.m[1][1] - s.m[0][1] * s.m[1][0];
+  if (!(det > 0.0f)) return false;
+  float id = 1.0f / det;
+  inv.m[0][0] = s.m[1][1] * id;
+  inv.m[1][1] = s.m[0][0] * id;
+  inv.m[0][1] = -s.m[0][1] * id;
+  inv.m[1][0] = -s.m[1][0] * id;
+  return true;
+}
+
+// Factorisation de Cholesky P = L L' (L triangulaire inférieure); faux si P non définie positive
+template<int N>
+inline bool cholesky(const KMat<N, N>& a, KMat<N, N>& L) {
+  L = KMat<N, N>::zero();
+  for (int c = 0; c < N; ++c) {
+    float d = a.m[c][c];
+    for (int k = 0; k < c; ++k) d -= L.m[c][k] * L.m[c][k];
+    if (!(d > 0.0f)) return false;
+    float lc = sqrtf(d);
+    L.m[c][c] = lc;
+    float il = 1.0f / lc;
+    for (int r = c + 1; r < N; ++r) {
+      float v = a.m[r][c];
+      for (int k = 0; k < c; ++k) v -= L.m[r][k] * L.m[c][k];
+      L.m[r][c] = v * il;
+    }
+  }
+  return true;
+}
+
+// Résout L L' X = B (L issue de cholesky), par substitutions avant puis arrière
+template<int N, int C>
+inline KMat<N, C> cholSolve(const KMat<N, N>& L, const KMat<N, C>& B) {
+  KMat<N, C> X;
+  for (int c = 0; c < C; ++c) {
+    for (int r = 0; r < N; ++r) {
+      float v = B.m[r][c];
+      for (int k = 0; k < r; ++k) v -= L.m[r][k] * X.m[k][c];
+      X.m[r][c] = v / L.m[r][r];
+    }
+    for (int r = N - 1; r >= 0; --r) {
+      float v = X.m[r][c];
+      for (int k = r + 1; k < N; ++k) v -= L.m[k][r] * X.m[k][c];
+      X.m[r][c] = v / L.m[r][r];
+    }
+  }
+  return X;
+}
+
+// Filtre linéaire à N états, mesures de dimension M (M = 1 ou 2)
+template<int N, int M>
+struct KalmanFixed {
+  KMat<N, 1> x;
+  KMat<N, N> P;
+
+  void predict(const KMat<N, N>& F, const KMat<N, N>& Q) {
+    x = F * x;
+    P = mulTransB(F * P, F) + Q;
+    symmetrize(P);
+  }
+
+  // Innovation y = z - Hx et sa covariance S = HPH' + R
+  void innovation(const KMat<M, N>& H, const KMat<M, 1>& z, const KMat<M, M>& Rm,
+                  KMat<M, 1>& y, KMat<M, M>& S) const {
+    y = z - H * x;
+    S = mulTransB(H * P, H) + Rm;
+  }
+
+  // Distance de Mahalanobis au carré de la mesure (sans mise à jour); <0 si S singulière.
+  // detS (optionnel): déterminant de S, pour la vraisemblance de la mesure
+  float mahalanobis2(const KMat<M, N>& H, const KMat<M, 1>& z, const KMat<M, M>& Rm, float* detS = nullptr) const {
+    return mahalanobis2Residual(H, z - H * x, Rm, detS);
+  }
+
+  // Variante sur une innovation déjà formée (modèle linéarisé: y = z - h(x), angles repliés)
+  float mahalanobis2Residual(const KMat<M, N>& H, const KMat<M, 1>& y, const KMat<M, M>& Rm, float* detS = nullptr) const {
+    KMat<M, M> S = mulTransB(H * P, H) + Rm, Si;
+    if (detS) *detS = det(S);
+    if (!invertSym(S, Si)) return -1.0f;
+    return (transpose(y) * Si * y).m[0][0];
+  }
+
+  // Mise à jour (forme de Joseph); retourne la distance de Mahalanobis au carré, <0 si rejetée
+  float update(const KMat<M, N>& H, const KMat<M, 1>& z, const KMat<M, M>& Rm) {
+    return updateResidual(H, z - H * x, Rm);
+  }
+
+  // Mise à jour EKF: H jacobienne de h en x, y = z - h(x)
+  float updateResidual(const KMat<M, N>& H, const KMat<M, 1>& y, const KMat<M, M>& Rm) {
+    KMat<M, M> S = mulTransB(H * P, H) + Rm, Si;
+    if (!invertSym(S, Si)) return -1.0f;
+    KMat<N, M> PHt = mulTransB(P, H);
+    KMat<N, M> K = PHt * Si;
+    x = x + K * y;
+    KMat<N, N> IKH = KMat<N, N>::identity() - K * H;
+    P = mulTransB(IKH * P, IKH) + mulTransB(K * Rm, K);
+    symmetrize(P);
+    return (transpose(y) * Si * y).m[0][0];
+  }
+};
@@ -0,0 +1,93 @@
+#include "line_ring.h"
+#include <string.h>
+
+static inline bool lineStillValid(const LineRing& r, const LineRingEntry& e, uint32_t seq) {
+  if (e.seq.load(std::memory_order_acquire) != seq) return false;
+  // Octets non réécrits depuis: l'écrivain n'a pas fait un tour complet
+  return (r.writeAbs.load(std::memory_order_acquire) - e.abs) <= LINE_RING_BYTES;
+}
+
+void lineRingInit(LineRing& r) {
+  r.head.store(0, std::memory_order_relaxed);
+  r.writeAbs.store(0, std::memory_order_relaxed);
+  for (uint32_t i = 0; i < LINE_RING_LINES; ++i) {
+    // Numéro impossible pour l'emplacement i tant qu'aucune ligne n'y est écrite
+    r.lines[i].seq.store(i + 1, std::memory_order_relaxed);
+    r.lines[i].abs = 0;
+    r.lines[i].len = 0;
+  }
+}
+
+void lineRingAppend(LineRing& r, const char* line, size_t len) {
+  if (len > LINE_RING_MAX_LINE) len = LINE_RING_MAX_LINE;
+  uint32_t abs = r.writeAbs.load(std::memory_order_relaxed);
+  uint32_t off = abs & (LINE_RING_BYTES - 1);
+  // Garder chaque ligne contiguë: sauter la fin de l'anneau si nécessaire
+  if (off + len > LINE_RING_BYTES) {
+    abs += LINE_RING_BYTES - off;
+    off = 0;
+  }
+  uint32_t seq = r.head.load(std::memory_order_relaxed);
+  LineRingEntry& e = r.lines[seq & (LINE_RING_LINES - 1)];
+  // Invalider l'entrée avant de réécrire les octets
+  e.seq.store(seq - LINE_RING_LINES + 1, std::memory_order_release);
+  // Publier l'avancée avant d'écraser les octets: les lecteurs voient l'invalidation
+  r.writeAbs.store(abs + (uint32_t)len, std::memory_order_release);
+  memcpy(&r.data[off], line, len);
+  e.abs = abs;
+  e.len = (uint16_t)len;
+  e.seq.store(seq, std::memory_order_release);
+  r.head.store(seq + 1, std::memory_order_release);
+}
+
+// Copie la ligne 'seq' dans 'out' (lecture de type seqlock): validée avant et
+// après la copie, l'écrivain (gps_rx, prioritaire) pouvant réécrire les octets
+// pendant la copie. Retourne la longueur, -1 si la ligne a été écrasée.
+static int copyLine(const LineRing& r, uint32_t seq, char* out) {
+  const LineRingEntry& e = r.lines[seq & (LINE_RING_LINES - 1)];
+  if (!lineStillValid(r, e, seq)) return -1;
+  uint32_t abs = e.abs;
+  uint16_t len = e.len;
+  if (len > LINE_RING_MAX_LINE) return -1;
+  memcpy(out, &r.data[abs & (LINE_RING_BYTES - 1)], len);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (!lineStillValid(r, e, seq)) return -1;
+  out[len] = '\0';
+  return len;
+}
+
+int lineRingForEachLast(const LineRing& r, int maxLines, LineRingVisitor fn, void* ctx) {
+  if (maxLines <= 0 || !fn) return 0;
+  uint32_t head = r.head.load(std::memory_order_acquire);
+  uint32_t n = (uint32_t)maxLines;
+  if (n > LINE_RING_LINES) n = LINE_RING_LINES;
+  if (n > head) n = head;
+  int visited = 0;
+  char buf[LINE_RING_MAX_LINE + 1];
+  for (uint32_t seq = head - n; seq != head; ++seq) {
+    int len = copyLine(r, seq, buf);
+    if (len < 0) continue;
+    fn(buf, (size_t)len, ctx);
+    visited++;
+  }
+  return visited;
+}
+
+uint32_t lineRingHead(const LineRing& r) {
+  return r.head.load(std::memory_order_acquire);
+}
+
+int lineRingForEachSince(const LineRing& r, uint32_t& cursor, LineRingVisitor fn, void* ctx) {
+  uint32_t head = r.head.load(std::memory_order_acquire);
+  uint32_t pending = head - cursor;
+  if (pending > LINE_RING_LINES) cursor = head - LINE_RING_LINES;
+  int visited = 0;
+  char buf[LINE_RING_MAX_LINE + 1];
+  for (; cursor != head; ++cursor) {
+    int len = copyLine(r, cursor, buf);
+    if (len < 0) continue;
+    if (fn) fn(buf, (size_t)len, ctx);
+    visited++;
+  }
+  return visited;
+}
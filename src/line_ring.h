@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Anneau d'octets à capacité fixe + index de lignes (historique NMEA brut).
+// Un seul écrivain, lecteurs sans verrou: append en O(1), "N dernières
+// lignes" en O(N). Chaque ligne (contiguë en mémoire) est copiée dans un
+// tampon de pile du lecteur puis revalidée avant d'être passée au visiteur:
+// l'écrivain peut la réécrire pendant que le visiteur travaille (Serial, HTTP).
+// Module sans dépendance Arduino.
+
+static const uint32_t LINE_RING_BYTES = 8192;  // puissance de 2
+static const uint32_t LINE_RING_LINES = 128;   // puissance de 2
+static const uint32_t LINE_RING_MAX_LINE = 255;
+
+struct LineRingEntry {
+  std::atomic<uint32_t> seq;   // numéro de ligne (validation côté lecteur)
+  uint32_t abs;                // position absolue du 1er octet
+  uint16_t len;
+};
+
+struct LineRing {
+  char data[LINE_RING_BYTES];
+  LineRingEntry lines[LINE_RING_LINES];
+  std::atomic<uint32_t> head;      // numéro de la prochaine ligne
+  std::atomic<uint32_t> writeAbs;  // position absolue d'écriture (inclut les pertes en fin d'anneau)
+};
+
+typedef void (*LineRingVisitor)(const char* line, size_t len, void* ctx);
+
+void lineRingInit(LineRing& r);
+
+// Ajoute une ligne (sans '\n'). Tronquée à LINE_RING_MAX_LINE.
+void lineRingAppend(LineRing& r, const char* line, size_t len);
+
+// Visite les 'maxLines' dernières lignes, de la plus ancienne à la plus récente.
+// Le visiteur reçoit une copie terminée par NUL, valable pendant l'appel; les
+// lignes écrasées pendant la copie sont sautées. Retourne le nombre visité.
+int lineRingForEachLast(const LineRing& r, int maxLines, LineRingVisitor fn, void* ctx);
+
+// Numéro de la prochaine ligne écrite
+uint32_t lineRingHead(const LineRing& r);
+
+// Visite les lignes ajoutées depuis 'cursor' puis avance le curseur.
+// Si l'écrivain a pris trop d'avance, les lignes perdues sont sautées.
+int lineRingForEachSince(const LineRing& r, uint32_t& cursor, LineRingVisitor fn, void* ctx);
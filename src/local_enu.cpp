@@ -0,0 +1,64 @@
+#include "local_enu.h"
+#include <math.h>
+
+static const double WGS84_A = 6378137.0;
+static const double WGS84_F = 1.0 / 298.257223563;
+static const double WGS84_E2 = WGS84_F * (2.0 - WGS84_F);
+static const double DEG = M_PI / 180.0;
+
+static float wrapLonDelta(double d) {
+  if (d > 180.0) d -= 360.0;
+  else if (d < -180.0) d += 360.0;
+  return (float)d;
+}
+
+void localEnuInit(LocalEnu& p, double latDeg, double lonDeg) {
+  double s = sin(latDeg * DEG), c = cos(latDeg * DEG);
+  double w2 = 1.0 - WGS84_E2 * s * s;
+  double w = sqrt(w2);
+  double N = WGS84_A / w;                        // rayon du premier vertical
+  double M = WGS84_A * (1.0 - WGS84_E2) / (w2 * w); // rayon méridien
+  double dM = 3.0 * M * WGS84_E2 * s * c / w2;  // dM/dlat (par radian)
+  p.lat0Deg = latDeg;
+  p.lon0Deg = lonDeg;
+  p.mN = (float)(M * DEG);
+  p.mE = (float)(N * c * DEG);
+  p.dmN = (float)(0.5 * dM * DEG * DEG);
+  p.dmE = (float)(-M * s * DEG * DEG);          // d(N cos lat)/dlat = -M sin lat
+  p.sag = (float)(0.5 * N * s * c * DEG * DEG);
+  p.sinLat0 = (float)s;
+  p.valid = true;
+}
+
+bool localEnuNeedsReanchor(const LocalEnu& p, double latDeg, double lonDeg, float radiusM) {
+  if (!p.valid) return true;
+  float dn = (float)(latDeg - p.lat0Deg) * p.mN;
+  float de = wrapLonDelta(lonDeg - p.lon0Deg) * p.mE;
+  return dn * dn + de * de > radiusM * radiusM;
+}
+
+void localEnuForward(const LocalEnu& p, double latDeg, double lonDeg, float& east, float& north) {
+  float dLat = (float)(latDeg - p.lat0Deg);
+  float dLon = wrapLonDelta(lonDeg - p.lon0Deg);
+  north = dLat * (p.mN + p.dmN * dLat) + p.sag * dLon * dLon;
+  east = dLon * (p.mE + p.dmE * dLat);
+}
+
+void localEnuInverse(const LocalEnu& p, float east, float north, double& latDeg, double& lonDeg) {
+  // Point fixe: deux itérations suffisent (termes du 2e ordre < 1e-3 du 1er sur quelques km)
+  float dLat = north / p.mN;
+  float dLon = east / p.mE;
+  for (int i = 0; i < 2; ++i) {
+    dLon = east / (p.mE + p.dmE * dLat);
+    dLat = (north - p.sag * dLon * dLon - p.dmN * dLat * dLat) / p.mN;
+  }
+  latDeg = p.lat0Deg + (double)dLat;
+  lonDeg = p.lon0Deg + (double)dLon;
+  if (lonDeg > 180.0) lonDeg -= 360.0;
+  else if (lonDeg < -180.0) lonDeg += 360.0;
+}
+
+float localEnuGridAzimuth(const LocalEnu& p, double lonDeg, float trueAzDeg) {
+  // Le méridien local est tourné de dLon*sin(lat0) vers le méridien de l'ancrage
+  return trueAzDeg - wrapLonDelta(lonDeg - p.lon0Deg) * p.sinLat0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+
+// Projection plane locale Est/Nord autour d'un point d'ancrage (WGS84).
+// Les rayons de courbure et leurs dérivées sont calculés une fois à
+// l'ancrage (seuls sin/cos/sqrt de la projection); chaque conversion ne
+// coûte ensuite que quelques multiplications-additions en float (FPU simple
+// précision de l'ESP32), seule la soustraction lat/lon reste en double.
+// Développement au 2e ordre en (dLat, dLon): azimuts rapportés au nord vrai
+// de l'ancrage, sans convergence des méridiens ni facteur d'échelle UTM.
+//
+// Précision (tools/enu_accuracy.cpp: cible à 50..1500 m du bateau, bateau
+// dans le rayon autour de l'ancrage, référence = problème direct de Vincenty,
+// latitudes 0..70°):
+//   rayon 2 km: max 1,5 mm, rms 0,2 mm
+//   rayon 5 km: max 5 mm,   rms 0,8 mm
+// Même calcul par utm.cpp (azimut vrai appliqué sur la grille, sans
+// correction de convergence): max 1,6 m à l'équateur, 50 m à 40°, 73 m à 70°
+// en bord de fuseau.
+// Le réancrage (LOCAL_ENU_REANCHOR_M) borne l'erreur sur de longs trajets.
+// Module sans dépendance Arduino.
+
+static const float LOCAL_ENU_REANCHOR_M = 2000.0f;
+
+struct LocalEnu {
+  double lat0Deg;     // ancrage
+  double lon0Deg;
+  float mN;           // m par degré de latitude (rayon méridien M0)
+  float mE;           // m par degré de longitude (N0 cos lat0)
+  float dmN;          // dérivées pour les termes du 2e ordre (m/deg²)
+  float dmE;
+  float sag;          // terme de flèche du parallèle (m/deg²)
+  float sinLat0;      // convergence des méridiens
+  bool valid;
+};
+
+void localEnuInit(LocalEnu& p, double latDeg, double lonDeg);
+
+// Vrai si le point est à plus de 'radiusM' de l'ancrage (ou ancrage invalide)
+bool localEnuNeedsReanchor(const LocalEnu& p, double latDeg, double lonDeg, float radiusM = LOCAL_ENU_REANCHOR_M);
+
+void localEnuForward(const LocalEnu& p, double latDeg, double lonDeg, float& east, float& north);
+void localEnuInverse(const LocalEnu& p, float east, float north, double& latDeg, double& lonDeg);
+
+// Azimut dans le plan local d'une direction d'azimut vrai 'trueAzDeg' issue du point donné
+// (correction de convergence des méridiens loin de l'ancrage)
+float localEnuGridAzimuth(const LocalEnu& p, double lonDeg, float trueAzDeg);
@@ -10,23 +10,28 @@
 #include "runtime_config.h"
 #include "utm.h"
 #include "console_broadcast.h"
+#include "target_fusion.h"
 #include "target_filter.h"
+#include "target_smoother.h"
 #include "web_server.h"
 #include "telemetry_state.h"
 #include "power.h"
 #include "demo_sim.h"
+#include "time_base.h"
+#include "svp_table.h"
+#include "nmea_writer.h"
+#include "ws_binary.h"
+#include "ws_publisher.h"
+#include "nmea_parse.h"
+#include "alloc_stats.h"
 
 // 🏷️ Version firmware
 const char* FIRMWARE_VERSION = "2.2.2";
 const char* BUILD_DATE = __DATE__ " " __TIME__;
 
 // Forward decls (helpers defined later in file)
-static float estimateGpsPosStd(const GpsFix& f);
-static float estimateSeakerPosStd(float distanceM);
-static void printTargetFilteredFrame(double tgtLat, double tgtLon, float posStd);
-static TargetFilterState gTf; static unsigned long gTfLastMs = 0;
+static void printTargetFilteredFrame(uint8_t beaconId, double tgtLat, double tgtLon, float posStd);
 
-static HardwareSerial& GPS = Serial1; // UART1
 static HardwareSerial& SEAKER = Serial2; // UART2
 static Adafruit_INA219 gIna219;
 static bool gInaReady = false;
@@ -39,10 +44,13 @@ enum LogLevel { LOG_ERROR=0, LOG_WARN=1, LOG_LOW=2, LOG_INFO=3, LOG_DEBUG=4 };
 volatile LogLevel gLogLevel = LOG_LOW; // réduit par défaut
 static void logMsg(LogLevel lvl, const char* tag, const char* fmt, ...) {
   if (lvl > gLogLevel) return;
-  char buf[192];
-  va_list ap; va_start(ap, fmt); vsnprintf(buf, sizeof(buf), fmt, ap); va_end(ap);
+  // Ligne complète sur la pile (Serial.printf alloue au-delà de 64 octets)
+  char buf[224];
   const char* lvls = (lvl==LOG_ERROR?"E": (lvl==LOG_WARN?"W": (lvl==LOG_INFO?"I":"D")));
-  Serial.printf("[%s][%s] %s\n", lvls, tag, buf);
+  int n = snprintf(buf, sizeof(buf), "[%s][%s] ", lvls, tag);
+  va_list ap; va_start(ap, fmt); vsnprintf(buf + n, sizeof(buf) - n - 1, fmt, ap); va_end(ap);
+  n = strlen(buf); buf[n++] = '\n';
+  Serial.write((const uint8_t*)buf, n);
 }
 
 // Tentative de recovery I2C si SDA reste bloquée à LOW (esclave figé)
@@ -90,12 +98,6 @@ static int gWifiRetryCount = 0;
 static const char* kApSsid = "SeakerESP-Config";
 static const char* kApPassword = "seaker123";
 
-// Configuration de correction de distance SEAKER
-enum SeakerMode { SEAKER_NORMAL, SEAKER_OFFSET, SEAKER_TRANSPONDER };
-SeakerMode gSeakerMode = SEAKER_NORMAL;
-float gSeakerDistOffset = 0.0f; // Offset en mètres
-float gSeakerTransponderDelay = 0.0f; // Délai transpondeur en millisecondes
-
 // NTRIP client minimal (TCP) pour flux RTCM -> UART GPS
 static TaskHandle_t ntripTaskHandle = nullptr;
 static void ntripTask(void* arg) {
@@ -129,7 +131,7 @@ static void ntripTask(void* arg) {
       }
       if (gNtripReconnectRequested) { break; }
       if (millis() - lastGga > 10000) {
-        GpsFix f = gpsGetFix();
+        GpsFix f; gpsReadFix(f);
         char latStr[16] = ""; char lonStr[16] = ""; char ns='N', ew='E';
         double alat=f.latitude, alon=f.longitude;
         if (alat<0){ns='S'; alat=-alat;} if(alon<0){ew='W'; alon=-alon;}
@@ -161,10 +163,8 @@ bool readPower(float& voltageV, float& current_mA){
   return true;
 }
 
-// Fonction pour calculer le checksum NMEA
-static uint8_t nmeaChecksum(const String& s) {
-  uint8_t c = 0; for (size_t i=0;i<s.length();++i) c ^= (uint8_t)s[i]; return c;
-}
+// Trames périodiques/cibles: écrites une fois sur la pile (nmea_writer)
+static const size_t NMEA_FRAME_MAX = 256;
 
 // Créer une trame GPGGA avec la position TARGET
 static void sendTargetAsGGA() {
@@ -174,13 +174,12 @@ static void sendTargetAsGGA() {
   // Format GPGGA: $GPGGA,hhmmss.ss,llll.ll,a,yyyyy.yy,a,x,xx,x.x,x.x,M,x.x,M,x.x,xxxx*hh
   // Exemple: $GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47
   
-  // Utiliser millis pour créer un timestamp simple
-  unsigned long ms = millis();
-  int hours = (ms / 3600000) % 24;
-  int minutes = (ms / 60000) % 60;
-  int seconds = (ms / 1000) % 60;
-  char timeStr[10];
-  sprintf(timeStr, "%02d%02d%02d.00", hours, minutes, seconds);
+  // Heure UTC de la base de temps GPS/PPS; à défaut (pas encore de fix daté), horloge locale
+  char timeStr[12];
+  if (!timeFormatNmeaUtc(timeNowUtcUs(), timeStr, sizeof(timeStr))) {
+    unsigned long ms = millis();
+    snprintf(timeStr, sizeof(timeStr), "%02d%02d%02d.00", (int)((ms / 3600000) % 24), (int)((ms / 60000) % 60), (int)((ms / 1000) % 60));
+  }
   
   // Convertir lat/lon en format NMEA (ddmm.mmmm)
   double latAbs = fabs(gTargetFLat);
@@ -202,7 +201,7 @@ static void sendTargetAsGGA() {
   );
   
   // Calculer et ajouter le checksum
-  uint8_t cks = nmeaChecksum(String(gga));
+  uint8_t cks = nmeaChecksumBuf(gga, strlen(gga));
   char fullMsg[220];
   snprintf(fullMsg, sizeof(fullMsg), "$%s*%02X\r\n", gga, cks);
   
@@ -214,21 +213,37 @@ static void sendTargetAsGGA() {
                 isfinite(gTargetFR95) ? gTargetFR95 : 0.0f);
 }
 
-// Diffuse une trame NMEA-like sur Serial + TCP + WS
-static void broadcastNmea(const String& payload) {
-  uint8_t cks = nmeaChecksum(payload);
-  char cksHex[3]; snprintf(cksHex, sizeof(cksHex), "%02X", cks);
-  Serial.print("$"); Serial.print(payload); Serial.print("*"); Serial.print(cksHex); Serial.print("\r\n");
-  String line = String("$") + payload + String("*") + String(cksHex);
-  consoleBroadcastLine(line);
-  // WS
-  String js = String("{\"nmea\":\"") + line + "\"}";
-  wsBroadcastJson(js);
+// Diffuse une trame NMEA-like sur Serial + TCP + WS: la ligne "$...*CS" et son
+// enveloppe {"nmea":"..."} sont les mêmes octets du tampon, sans recopie
+static void broadcastFrame(NmeaWriter& w) {
+  size_t n = nmeaFrameEnd(w);
+  const char* line = nmeaFrameLine(w);
+  Serial.write((const uint8_t*)line, n); Serial.write((const uint8_t*)"\r\n", 2);
+  consoleBroadcastLine(line, n);
+  if (wsWantText()) wsBroadcastText(w.buf, nmeaTextLen(w));
+  if (wsWantBinary(true)) {
+    // Enregistrement WSB_NMEA sur place: l'octet de type remplace le '"' de l'enveloppe,
+    // la réserve d'en-tête WS est prise dans la réserve + "{"nmea":" qui précèdent
+    static_assert(NMEA_WS_PREFIX_LEN >= 1, "enveloppe NMEA");
+    uint8_t* rec = (uint8_t*)w.buf + w.lineStart - 1;
+    rec[0] = WSB_NMEA;
+    wsBroadcastBinary(rec - NMEA_WS_HEADROOM, n + 1, true);
+  }
   
   // Ne pas forward les messages GPS normaux quand GPS Forward est activé
   // On va créer nos propres messages avec la position TARGET
 }
 
+static void broadcastNmea(const char* payload) {
+  char buf[NMEA_FRAME_MAX];
+  NmeaWriter w;
+  nmeaFrameBegin(w, buf, sizeof(buf), payload);
+  broadcastFrame(w);
+}
+
+// Allocations de loop() pendant le dernier cycle d'état (HEAP_ALLOC_STATS)
+static uint32_t gStatusCycleAllocs = 0;
+
 static void printHelp() {
   Serial.println("=== CLI Seaker (Serial) ===");
   Serial.println("h: help");
@@ -237,6 +252,7 @@ static void printHelp() {
   Serial.println("e: toggle echo RAW -> Serial");
   Serial.println("s: toggle echo SEAKER RAW -> Serial");
   Serial.println("b: auto-détection baud GPS");
+  Serial.println("B: basculer sortie GPS binaire SkyTraq / NMEA");
   Serial.println("V: augmenter verbosité (DEBUG max)");
   Serial.println("v: diminuer verbosité (ERROR min)");
   Serial.println("(Niveaux: ERROR < WARN < LOW < INFO < DEBUG)");
@@ -248,100 +264,102 @@ static void printHelp() {
   Serial.println("R: définir erreur relative distance SEAKER (ex: 0.005)");
   Serial.println("K: définir bruit process Kalman aStd (m/s^2)");
   Serial.println("G: définir seuil gating Kalman (sigma)");
+  Serial.println("F: mesure du filtre (0=cart, 1=EKF polaire, 2=UKF polaire)");
+  Serial.println("S: retard du lisseur RTS $TARGETS en pings (0=off, max 16)");
+  Serial.println("T: basculer pistage IMM (immobile/CV/manoeuvre) / modèle unique");
+  Serial.println("Y: balise active (id des pings suivants; mis à jour par chaque CONFIG envoyé)");
 }
 
 static void printSysFrame() {
   unsigned long now = millis();
   unsigned long ageRtcm = (gRtcmLastMs==0)? 0 : (now - gRtcmLastMs);
-  String payload = "SYS,";
-  payload += "uptime=" + String(now/1000);
-  payload += ",rtcm_rx=" + String((unsigned long)gRtcmRxBytes);
-  payload += ",rtcm_fwd=" + String((unsigned long)gRtcmFwdBytes);
-  payload += ",rtcm_age_ms=" + String((unsigned long)ageRtcm);
+  char buf[NMEA_FRAME_MAX];
+  NmeaWriter w;
+  nmeaFrameBegin(w, buf, sizeof(buf), "SYS");
+  nmeaPutStr(w, ",uptime="); nmeaPutU32(w, now/1000);
+  nmeaPutKey(w, "rtcm_rx"); nmeaPutU32(w, gRtcmRxBytes);
+  nmeaPutKey(w, "rtcm_fwd"); nmeaPutU32(w, gRtcmFwdBytes);
+  nmeaPutKey(w, "rtcm_age_ms"); nmeaPutU32(w, ageRtcm);
   
   // État WiFi selon le WiFi Manager
-  String wifiStatus;
-  String ipAddress;
+  const char* wifiStatus;
+  IPAddress ip((uint32_t)0);
   int rssi = 0;
   
   switch(gWifiState) {
     case WIFI_CONNECTED:
       wifiStatus = "STA";
-      ipAddress = WiFi.localIP().toString();
+      ip = WiFi.localIP();
       rssi = WiFi.RSSI();
       break;
     case WIFI_AP_MODE:
       wifiStatus = gWifiApFallback ? "AP-FALLBACK" : "AP";
-      ipAddress = WiFi.softAPIP().toString();
-      rssi = 0;
+      ip = WiFi.softAPIP();
       break;
     case WIFI_CONNECTING:
       wifiStatus = "CONNECTING";
-      ipAddress = "0.0.0.0";
-      rssi = 0;
       break;
     default:
       wifiStatus = "DISCONNECTED";
-      ipAddress = "0.0.0.0";
-      rssi = 0;
       break;
   }
   
-  payload += ",wifi=" + wifiStatus;
-  payload += ",ip=" + ipAddress;
-  payload += ",rssi=" + String(rssi) + "dBm";
-  broadcastNmea(payload);
+  nmeaPutKey(w, "wifi"); nmeaPutStr(w, wifiStatus);
+  nmeaPutKey(w, "ip");
+  for (int i = 0; i < 4; ++i) { if (i) nmeaPutChar(w, '.'); nmeaPutU32(w, ip[i]); }
+  nmeaPutKey(w, "rssi"); nmeaPutI32(w, rssi); nmeaPutStr(w, "dBm");
+  if (allocStatsEnabled()) { nmeaPutKey(w, "alloc"); nmeaPutU32(w, gStatusCycleAllocs); }
+  broadcastFrame(w);
 }
 
 static void printNtripFrame() {
   unsigned long now = millis();
   unsigned long ageRtcm = (gRtcmLastMs==0)? 0 : (now - gRtcmLastMs);
   bool streaming = (gRtcmLastMs != 0) && (now - gRtcmLastMs < 5000);
-  String payload = "NTRIP,";
-  payload += "enabled=" + String(gNtripEnabled ? 1 : 0);
-  payload += ",host=" + gNtripHost;
-  payload += ",port=" + String((unsigned)gNtripPort);
-  payload += ",mount=" + gNtripMount;
-  payload += ",streaming=" + String(streaming ? 1 : 0);
-  payload += ",rtcm_rx=" + String((unsigned long)gRtcmRxBytes);
-  payload += ",rtcm_fwd=" + String((unsigned long)gRtcmFwdBytes);
-  payload += ",rtcm_age_ms=" + String((unsigned long)ageRtcm);
-  broadcastNmea(payload);
+  char buf[NMEA_FRAME_MAX];
+  NmeaWriter w;
+  nmeaFrameBegin(w, buf, sizeof(buf), "NTRIP");
+  nmeaPutStr(w, ",enabled="); nmeaPutU32(w, gNtripEnabled ? 1 : 0);
+  nmeaPutKey(w, "host"); nmeaPutStr(w, gNtripHost.c_str());
+  nmeaPutKey(w, "port"); nmeaPutU32(w, gNtripPort);
+  nmeaPutKey(w, "mount"); nmeaPutStr(w, gNtripMount.c_str());
+  nmeaPutKey(w, "streaming"); nmeaPutU32(w, streaming ? 1 : 0);
+  nmeaPutKey(w, "rtcm_rx"); nmeaPutU32(w, gRtcmRxBytes);
+  nmeaPutKey(w, "rtcm_fwd"); nmeaPutU32(w, gRtcmFwdBytes);
+  nmeaPutKey(w, "rtcm_age_ms"); nmeaPutU32(w, ageRtcm);
+  broadcastFrame(w);
 }
 
 static void printGpsSummaryFrame() {
-  GpsFix f = gpsGetFix();
+  GpsFix f; gpsReadFix(f);
   float hdg = isfinite(f.trueHeadingDeg) ? f.trueHeadingDeg : f.headingDeg;
   
-  // DEBUG: Afficher les valeurs brutes de heading
-  Serial.printf("[DEBUG] Raw heading values - trueHeadingDeg: %.1f, headingDeg: %.1f, final hdg: %.1f\n", 
-                f.trueHeadingDeg, f.headingDeg, hdg);
-  
   if (isfinite(hdg)) {
     while (hdg < 0) hdg += 360.0f;
     while (hdg >= 360.0f) hdg -= 360.0f;
-    Serial.printf("[DEBUG] Normalized heading: %.1f°\n", hdg);
-  } else {
-    Serial.printf("[DEBUG] Heading is NOT finite!\n");
   }
+  // DEBUG: valeurs brutes de heading (printf > 64 octets: alloue, donc niveau DEBUG seulement)
+  logMsg(LOG_DEBUG, "GPS", "heading true=%.1f cog=%.1f final=%.1f", f.trueHeadingDeg, f.headingDeg, hdg);
   
   // Déterminer le statut GPS
-  String gpsStatus = "NAT"; // Natural
+  const char* gpsStatus = "NAT"; // Natural
   if (f.fixQuality == 4) gpsStatus = "FIX"; // RTK Fix
   else if (f.fixQuality == 5) gpsStatus = "FLT"; // RTK Float
   else if (f.fixQuality == 2) gpsStatus = "DGP"; // DGPS
   
-  String payload = "GPS,";
-  payload += "valid=" + String(f.valid ? 1 : 0);
-  payload += ",status=" + gpsStatus;
-  payload += ",sats=" + String((unsigned)f.satellites);
-  payload += ",hdop=" + String(isfinite(f.hdop) ? String(f.hdop,1) : String("nan"));
-  payload += ",lat=" + String(isfinite(f.latitude) ? String(f.latitude,6) : String("nan"));
-  payload += ",lon=" + String(isfinite(f.longitude) ? String(f.longitude,6) : String("nan"));
-  payload += ",alt=" + String(isfinite(f.altitudeM) ? String(f.altitudeM,1) : String("nan"));
-  payload += ",hdg=" + String(isfinite(hdg) ? String(hdg,1) : String("nan"));
-  payload += ",kn=" + String(isfinite(f.speedKnots) ? String(f.speedKnots,1) : String("nan"));
-  broadcastNmea(payload);
+  char buf[NMEA_FRAME_MAX];
+  NmeaWriter w;
+  nmeaFrameBegin(w, buf, sizeof(buf), "GPS");
+  nmeaPutStr(w, ",valid="); nmeaPutU32(w, f.valid ? 1 : 0);
+  nmeaPutKey(w, "status"); nmeaPutStr(w, gpsStatus);
+  nmeaPutKey(w, "sats"); nmeaPutU32(w, f.satellites);
+  nmeaPutKey(w, "hdop"); nmeaPutFixed(w, f.hdop, 1);
+  nmeaPutKey(w, "lat"); nmeaPutFixed(w, f.latitude, 6);
+  nmeaPutKey(w, "lon"); nmeaPutFixed(w, f.longitude, 6);
+  nmeaPutKey(w, "alt"); nmeaPutFixed(w, f.altitudeM, 1);
+  nmeaPutKey(w, "hdg"); nmeaPutFixed(w, hdg, 1);
+  nmeaPutKey(w, "kn"); nmeaPutFixed(w, f.speedKnots, 1);
+  broadcastFrame(w);
 }
 
 // --- SEAKER contrôle & TARGET ---
@@ -350,127 +368,61 @@ static void seakerSendGoStop()  { sendSEAKERCommand("GOSEAK,4,1,1500,0"); }
 
 static int parseSeakerStatus() {
   // gSeaker.lastStatus peut contenir "0/1/2/3" ou texte
-  const String& s = gSeaker.lastStatus;
-  if (!s.length()) return -1;
-  if (s == "MOCK") return 2;
+  const char* s = gSeaker.lastStatus;
+  if (!s[0]) return -1;
+  if (strcmp(s, "MOCK") == 0) return 2;
   char c = s[0]; if (c>='0' && c<='9') return (int)(c-'0');
   return -1;
 }
 
-// Fonction pour corriger la distance selon le mode configuré
-static float correctSeakerDistance(float rawDistance) {
-  switch(gSeakerMode) {
-    case SEAKER_OFFSET:
-      // Mode offset simple : soustraire une distance fixe
-      return rawDistance - gSeakerDistOffset;
-      
-    case SEAKER_TRANSPONDER: {
-      // Mode transpondeur : 
-      // 1. Convertir le délai ms en distance (vitesse du son = 1500 m/s)
-      float delayDistance = (gSeakerTransponderDelay / 1000.0f) * 1500.0f;
-      // 2. Soustraire cette distance
-      float remainingDistance = rawDistance - delayDistance;
-      // 3. Diviser par 2 (aller-retour)
-      return remainingDistance / 2.0f;
-    }
-    
-    case SEAKER_NORMAL:
-    default:
-      return rawDistance;
-  }
-}
-
-static void printTargetFrame() {
-  GpsFix fix = gpsGetFix();
-  if (!fix.valid || !isfinite(gSeaker.lastAngle) || !isfinite(gSeaker.lastDistance)) return;
-  double platformAz = isfinite(fix.trueHeadingDeg) ? fix.trueHeadingDeg : fix.headingDeg;
-  if (!isfinite(platformAz)) return;
-  // Appliquer inversion/offset SEAKER
-  double rel = gSeaker.lastAngle;
-  if (gSeakerInvertAngle) rel = -rel;
-  rel += (double)gSeakerAngleOffsetDeg;
-  while (rel < 0) rel += 360.0; while (rel >= 360.0) rel -= 360.0;
-  double az = platformAz + rel;
-  while (az < 0) az += 360.0; while (az >= 360.0) az -= 360.0;
-  // Appliquer la correction de distance selon le mode
-  double d = correctSeakerDistance(gSeaker.lastDistance); // mètres corrigés
-
-  // Calcul en UTM
-  int zone; bool north; double e0,n0;
-  if (!wgs84ToUtm(fix.latitude, fix.longitude, zone, north, e0, n0)) return;
-  double brg = az * (M_PI/180.0);
-  double de = d * sin(brg);
-  double dn = d * cos(brg);
-  double e1 = e0 + de;
-  double n1 = n0 + dn;
-  double tgtLat, tgtLon;
-  if (!utmToWgs84(zone, north, e1, n1, tgtLat, tgtLon)) return;
-  // Estimation d'incertitude (écart-type) et r95
-  float gpsStd = estimateGpsPosStd(fix);
-  float seakerStd = estimateSeakerPosStd((float)d);
-  float measStd = sqrtf(gpsStd*gpsStd + seakerStd*seakerStd);
-  String payload = "TARGET,";
-  payload += String(tgtLat, 7) + "," + String(tgtLon, 7);
-  payload += ",az=" + String(az,1) + ",dist_m=" + String(d,1);
-  payload += ",r95_m=" + String(measStd * 2.45f, 2);
-  broadcastNmea(payload);
-
-  // Toujours envoyer la position TARGET brute calculée via WebSocket
-  {
-    // Mise à jour globale pour l'API et WebSocket
-    telemetrySetTargetF(tgtLat, tgtLon, measStd * 2.45f);
-    String js = String("{\"targetf\":{\"lat\":") + String(tgtLat,7) + ",\"lon\":" + String(tgtLon,7) + ",\"r95_m\":" + String(measStd*2.45f,2) + "}}";
-    wsBroadcastJson(js);
-    
-    // Position TARGET mise à jour - sera envoyée par le timer à 1Hz
-    
-    // Debug: log chaque mise à jour target
-    Serial.printf("[TARGET] Raw: lat=%.7f lon=%.7f az=%.1f dist=%.1f r95=%.2f\n", 
-                  tgtLat, tgtLon, az, d, measStd * 2.45f);
+// Sortie des résultats de la tâche fusion (NMEA, WebSocket, télémétrie): loop uniquement
+static void emitTargetOutput(const TargetOutput& o) {
+  char buf[NMEA_FRAME_MAX];
+  NmeaWriter w;
+  if (o.kind == TARGET_OUT_RAW) {
+    nmeaFrameBegin(w, buf, sizeof(buf), "TARGET");
+    nmeaPutChar(w, ','); nmeaPutFixed(w, o.lat, 7); nmeaPutChar(w, ','); nmeaPutFixed(w, o.lon, 7);
+    nmeaPutKey(w, "az"); nmeaPutFixed(w, o.azDeg, 1);
+    nmeaPutKey(w, "dist_m"); nmeaPutFixed(w, o.distM, 1);
+    nmeaPutKey(w, "r95_m"); nmeaPutFixed(w, o.r95, 2);
+    nmeaPutKey(w, "id"); nmeaPutU32(w, o.beaconId);
+    broadcastFrame(w);
+    // Toujours publier la position TARGET brute calculée via WebSocket (tick suivant)
+    telemetrySetTargetF(o.lat, o.lon, o.r95, o.beaconId);
+    wsPubTargetRaw(o);
+    logMsg(LOG_DEBUG, "TARGET", "Raw: id=%u lat=%.7f lon=%.7f az=%.1f dist=%.1f r95=%.2f",
+           (unsigned)o.beaconId, o.lat, o.lon, (double)o.azDeg, (double)o.distM, (double)o.r95);
+    return;
   }
-  
-  // Kalman 2D avec gating et sortie TARGETF filtré
-  static int tfZone = 0; static bool tfNorth = true;
-  unsigned long nowMs = millis(); float dt = (gTfLastMs==0)? 0.0f : (nowMs - gTfLastMs) / 1000.0f; gTfLastMs = nowMs;
-  if (!gTf.initialized) { tfZone = zone; tfNorth = north; }
-  if (dt > 0.0f) targetFilterPredict(gTf, dt, gKalmanAccelStd);
-  float innov = targetFilterUpdate(gTf, (float)e1, (float)n1, measStd);
-  if (innov < gKalmanGate) {
-    double fLat, fLon;
-    if (utmToWgs84(tfZone, tfNorth, gTf.x, gTf.y, fLat, fLon)) {
-      float posStdF = sqrtf(max(0.0f, (gTf.Pxx + gTf.Pyy) * 0.5f));
-      printTargetFilteredFrame(fLat, fLon, posStdF);
-      // Mettre à jour avec la version filtrée si acceptée
-      telemetrySetTargetF(fLat, fLon, posStdF * 2.45f);
-      // Push la version filtrée
-      String js = String("{\"targetf\":{\"lat\":") + String(fLat,7) + ",\"lon\":" + String(fLon,7) + ",\"r95_m\":" + String(posStdF*2.45f,2) + ",\"filtered\":true}}";
-      wsBroadcastJson(js);
-    }
+  if (o.kind == TARGET_OUT_SMOOTHED) {
+    // Sortie différée de 'lag' pings: l'heure UTC du ping lissé accompagne la position
+    char t[12] = "";
+    timeFormatNmeaUtc(timeLocalToUtcUs(o.pingUs), t, sizeof(t));
+    nmeaFrameBegin(w, buf, sizeof(buf), "TARGETS");
+    nmeaPutChar(w, ','); nmeaPutU32(w, o.beaconId);
+    nmeaPutChar(w, ','); nmeaPutFixed(w, o.lat, 7); nmeaPutChar(w, ','); nmeaPutFixed(w, o.lon, 7);
+    nmeaPutKey(w, "r95_m"); nmeaPutFixed(w, o.r95, 2);
+    nmeaPutKey(w, "t"); nmeaPutStr(w, t);
+    nmeaPutKey(w, "lag"); nmeaPutU32(w, o.lag);
+    broadcastFrame(w);
+    return;
   }
+  printTargetFilteredFrame(o.beaconId, o.lat, o.lon, o.r95 / 2.45f);
+  // Mettre à jour avec la version filtrée si acceptée (cible unique + table par balise)
+  telemetrySetTarget(o);
+  // Publie la version filtrée, avec l'ensemble des pistes
+  wsPubTargetFiltered(o);
+  targetFusionNoteSink(o);
 }
 
-// --- Cible filtrée (Kalman) ---
-// moved to top-level forward declaration
-static float estimateGpsPosStd(const GpsFix& f){
-  // Estimation grossière en mètres selon fixQuality/hdop
-  if (f.fixQuality == 4) return 0.03f;      // RTK Fix ~3cm
-  if (f.fixQuality == 5) return 0.1f;       // RTK Float ~10cm
-  if (isfinite(f.hdop)) return max(1.0f, f.hdop * 1.5f);
-  return 3.0f; // fallback
-}
-static float estimateSeakerPosStd(float distanceM){
-  // Erreur angulaire configurable (deg)
-  const float angRadStd = gSeakerAngleSigmaDeg * (M_PI/180.0f);
-  float lateral = fabs(distanceM) * angRadStd;
-  // Erreur relative de distance configurable
-  float rangeErr = max(0.1f, gSeakerRangeRel * fabs(distanceM));
-  return sqrtf(lateral*lateral + rangeErr*rangeErr);
-}
-static void printTargetFilteredFrame(double tgtLat, double tgtLon, float posStd){
-  String payload = "TARGETF,";
-  payload += String(tgtLat, 7) + "," + String(tgtLon, 7);
-  payload += ",r95_m=" + String(posStd * 2.45f, 2); // ~2.45*std pour r95 2D approximé
-  broadcastNmea(payload);
+static void printTargetFilteredFrame(uint8_t beaconId, double tgtLat, double tgtLon, float posStd){
+  char buf[NMEA_FRAME_MAX];
+  NmeaWriter w;
+  nmeaFrameBegin(w, buf, sizeof(buf), "TARGETF");
+  nmeaPutChar(w, ','); nmeaPutU32(w, beaconId);
+  nmeaPutChar(w, ','); nmeaPutFixed(w, tgtLat, 7); nmeaPutChar(w, ','); nmeaPutFixed(w, tgtLon, 7);
+  nmeaPutKey(w, "r95_m"); nmeaPutFixed(w, posStd * 2.45f, 2); // ~2.45*std pour r95 2D approximé
+  broadcastFrame(w);
 }
 
 static void seakerControllerStep() {
@@ -642,6 +594,7 @@ static void wifiManagerStep() {
 }
 
 void setup() {
+  allocStatsWatchCurrentTask(); // loopTask (setup et loop)
   Serial.begin(115200);
   delay(200);
   Serial.println("Booting Seaker ESP32");
@@ -680,7 +633,8 @@ void setup() {
 
   // UARTs
   startSEAKER(SEAKER, 115200, SONAR_RX_PIN, SONAR_TX_PIN);
-  gpsBegin(GPS, 921600, GPS_RX_PIN, GPS_TX_PIN);
+  timeBaseBegin(GPS_PPS_PIN); // PPS -> base de temps UTC µs
+  gpsBegin(UART_NUM_1, 921600, GPS_RX_PIN, GPS_TX_PIN); // UART1 + tâche gps_rx (core 1)
   // Forcer l'écho NMEA GPS et tenter une auto-détection du baud au boot
   gpsSetEchoRaw(true);
   {
@@ -698,6 +652,14 @@ void setup() {
   loadSeakerCalibFromPrefs();
   loadSeakerConfigsFromPrefs(); // Charger les profils CONFIG SEAKER
   loadDemoFromPrefs();
+  loadGpsPrefs();
+  loadVesselPrefs(); // appliquée au démarrage de la tâche fusion
+  loadWsPrefs();
+  loadSvpPrefs();
+  svpBegin(); // profil /svp.csv, grille construite en tâche de fond
+  if (gGpsRateHz) gpsSetUpdateRate(gGpsRateHz);
+  // Choix persisté seulement s'il a été accepté (ou forcé): NMEA reste décodé en repli
+  if (gGpsBinaryMode) gpsSetBinaryMode(true, true);
 
   // Démarrer le WiFi Manager (gestion automatique STA/AP)
   Serial.println("[WiFi] Démarrage WiFi Manager...");
@@ -707,6 +669,7 @@ void setup() {
   // Lancer la tâche NTRIP sur core 0 (réseau), pour libérer le core 1 (loop)
   xTaskCreatePinnedToCore(ntripTask, "ntrip", 8192, nullptr, 1, &ntripTaskHandle, 0);
   // Lancer la tâche SEAKER sur core 1
+  targetFusionBegin(); // avant la tâche seaker qui la notifie
   static TaskHandle_t seakerTaskHandle = nullptr;
   xTaskCreatePinnedToCore(seakerTask, "seaker", 4096, nullptr, 1, &seakerTaskHandle, 1);
 
@@ -732,16 +695,9 @@ void loop() {
   // SEAKER handled in its own task
   // Mise à jour immédiate sur nouvel écho SEAKER (sans attendre la fenêtre 2s)
   {
-    static unsigned long lastPingSeenLive = 0;
-    static unsigned long lastTargetPushMs = 0;
-    if (gSeaker.pingCounter != lastPingSeenLive) {
-      unsigned long nowEv = millis();
-      if (nowEv - lastTargetPushMs > 250) { // limiter le débit
-        printTargetFrame();
-        lastTargetPushMs = nowEv;
-      }
-      lastPingSeenLive = gSeaker.pingCounter;
-    }
+    // Résultats de la tâche fusion (chaque ping y est fusionné une fois, dans l'ordre)
+    TargetOutput out;
+    while (targetFusionPopOutput(out)) emitTargetOutput(out);
   }
   
   // WiFi Manager - surveillance continue et reconnexion automatique
@@ -749,6 +705,7 @@ void loop() {
   
   consoleLoop();
   webLoop();
+  wsPubLoop();
   
   // Gérer les connexions GPS Forward TCP
   if (gGpsForwardEnabled) {
@@ -780,12 +737,10 @@ void loop() {
   static unsigned long lastGpsWsMs = 0;
   static unsigned long lastRssiPushMs = 0;
   
-  // Push RSSI toutes les 2 secondes via WebSocket
+  // RSSI toutes les 2 secondes via WebSocket (publié si modifié)
   unsigned long nowRssi = millis();
   if (nowRssi - lastRssiPushMs > 2000) {
-    int rssi = WiFi.RSSI();
-    String rssiJson = "{\"rssi\":" + String(rssi) + "}";
-    wsBroadcastJson(rssiJson);
+    wsPubRssi(WiFi.RSSI());
     // Suppression log RSSI périodique pour éviter flood série
     // Serial.printf("[RSSI] WiFi signal: %d dBm\n", rssi);
     lastRssiPushMs = nowRssi;
@@ -822,9 +777,10 @@ void loop() {
         printFixSummary();
         break;
       case 'r': {
-        String raw = gpsGetRaw(50);
         Serial.println("--- RAW ---");
-        Serial.print(raw);
+        gpsForEachRawLine(50, [](const char* line, size_t len, void*){
+          Serial.write((const uint8_t*)line, len); Serial.write('\n');
+        }, nullptr);
         Serial.println("--- END ---");
         break;
       }
@@ -859,6 +815,16 @@ void loop() {
         }
         break;
       }
+      case 'B': {
+        if (!gpsSetBinaryMode(!gGpsBinaryMode)) {
+          Serial.println("GPS sortie: NMEA conservé (forcer: POST /api/gps/mode binary=1&force=1)");
+          break;
+        }
+        gGpsBinaryMode = !gGpsBinaryMode;
+        saveGpsPrefs();
+        Serial.printf("GPS sortie: %s\n", gGpsBinaryMode ? "BINAIRE (0xA8, cap = route fond)" : "NMEA");
+        break;
+      }
       case 'x':
       case 'X': {
         // Inversion rapide des pins RX/TX du GPS pour diagnostiquer un croisement
@@ -987,75 +953,84 @@ void loop() {
         if (s.length()) { gKalmanGate = s.toFloat(); saveFilterPrefs(); Serial.printf("Kalman gate=%.1f sigma\n", (double)gKalmanGate);} else { Serial.println("Inchangé."); }
         break;
       }
+      case 'F': {
+        Serial.printf("Mesure du filtre actuelle: %s. Entrez 0=cart, 1=ekf, 2=ukf et validez (CR):\n", targetMeasModeName(gKalmanMeasMode));
+        unsigned long tstart = millis(); String s;
+        while (millis()-tstart < 5000) { if (Serial.available()) { char ch=(char)Serial.read(); if (ch=='\r'||ch=='\n'){ if(s.length()) break; else continue;} s+=ch;} delay(1);} s.trim();
+        if (s.length() && s.toInt() >= 0 && s.toInt() <= 2) { gKalmanMeasMode = (uint8_t)s.toInt(); saveFilterPrefs(); Serial.printf("Kalman mesure=%s\n", targetMeasModeName(gKalmanMeasMode));} else { Serial.println("Inchangé."); }
+        break;
+      }
+      case 'T': {
+        gKalmanImm = !gKalmanImm; saveFilterPrefs();
+        Serial.printf("Pistage %s\n", gKalmanImm ? "IMM" : "modèle unique");
+        break;
+      }
+      case 'S': {
+        Serial.printf("Retard lisseur actuel: %u pings. Entrez 0..%u et validez (CR):\n", (unsigned)gKalmanSmoothLag, (unsigned)TARGET_SMOOTH_MAX_LAG);
+        unsigned long tstart = millis(); String s;
+        while (millis()-tstart < 5000) { if (Serial.available()) { char ch=(char)Serial.read(); if (ch=='\r'||ch=='\n'){ if(s.length()) break; else continue;} s+=ch;} delay(1);} s.trim();
+        if (s.length() && s.toInt() >= 0 && s.toInt() <= TARGET_SMOOTH_MAX_LAG) { gKalmanSmoothLag = (uint8_t)s.toInt(); saveFilterPrefs(); Serial.printf("Lisseur lag=%u\n", (unsigned)gKalmanSmoothLag);} else { Serial.println("Inchangé."); }
+        break;
+      }
+      case 'Y': {
+        Serial.printf("Balise active: %u. Entrez l'id 0..255 et validez (CR):\n", (unsigned)seakerActiveBeacon());
+        unsigned long tstart = millis(); String s;
+        while (millis()-tstart < 5000) { if (Serial.available()) { char ch=(char)Serial.read(); if (ch=='\r'||ch=='\n'){ if(s.length()) break; else continue;} s+=ch;} delay(1);} s.trim();
+        if (s.length() && s.toInt() >= 0 && s.toInt() <= 255) { seakerSetActiveBeacon((uint8_t)s.toInt()); Serial.printf("Balise active=%u\n", (unsigned)seakerActiveBeacon());} else { Serial.println("Inchangé."); }
+        break;
+      }
       default:
         break;
     }
   }
 
   static unsigned long lastFixOut = 0;
-  static unsigned long lastPingSeen = 0;
   if (millis() - lastFixOut > 2000) {
-    // Trame système NMEA-like: $SYS,...*CS\r\n
+    uint32_t allocs0 = allocStatsCount();
+    // Trame système NMEA-like: $SYS,...*CS\r\n (alloc= du cycle précédent)
     printSysFrame();
     // Trame NTRIP/RTCM: $NTRIP,...*CS\r\n
     printNtripFrame();
     // Trame GPS synthétique: $GPS,...*CS\r\n
     printGpsSummaryFrame();
-    // Trame TARGET uniquement si un nouveau DTPING a été reçu
-    if (gSeaker.pingCounter != lastPingSeen) {
-      printTargetFrame();
-      lastPingSeen = gSeaker.pingCounter;
-    }
     if (gInaReady) {
       float busV = gIna219.getBusVoltage_V();
       float shuntV = gIna219.getShuntVoltage_mV() / 1000.0f;
       float current = gIna219.getCurrent_mA();
       float loadV = busV + shuntV;
-      String payload = "PWR,";
-      payload += String(loadV,2) + "," + String(current,1) + ",busV=" + String(busV,2);
-      uint8_t cks = nmeaChecksum(payload);
-      char buf[8]; snprintf(buf, sizeof(buf), "*%02X\r\n", cks);
-      Serial.print("$"); Serial.print(payload); Serial.print(buf);
+      char buf[NMEA_FRAME_MAX];
+      NmeaWriter w;
+      nmeaFrameBegin(w, buf, sizeof(buf), "PWR");
+      nmeaPutChar(w, ','); nmeaPutFixed(w, loadV, 2); nmeaPutChar(w, ','); nmeaPutFixed(w, current, 1);
+      nmeaPutKey(w, "busV"); nmeaPutFixed(w, busV, 2);
+      size_t n = nmeaFrameEnd(w);
+      Serial.write((const uint8_t*)nmeaFrameLine(w), n); Serial.write((const uint8_t*)"\r\n", 2);
       // Suppression log INA219 périodique pour éviter flood série
       // logMsg(LOG_DEBUG, "INA219", "V=%.2fV I=%.1fmA", (double)loadV, (double)current);
     }
-  // Push GPS et TargetF via WS avec throttle
+  // Publie GPS via WS (trame regroupée du tick suivant)
   {
     unsigned long nowMs = millis();
-    if (nowMs - lastGpsWsMs >= 120) {
-      GpsFix f = gpsGetFix();
+    static uint32_t lastGpsWsVersion = 0;
+    if (nowMs - lastGpsWsMs >= 120 && gpsFixVersion() != lastGpsWsVersion) {
+      GpsFix f; lastGpsWsVersion = gpsReadFix(f);
       static double prevLat = 0, prevLon = 0; static float prevHdg = -999; static bool have=false;
       float currentHdg = isfinite(f.trueHeadingDeg) ? f.trueHeadingDeg : f.headingDeg;
       
-      // Push GPS si position OU heading a changé
+      // Publie GPS si position OU heading a changé (valeurs non finies → null / absent)
       if (!have || f.latitude!=prevLat || f.longitude!=prevLon || fabs(currentHdg - prevHdg) > 0.1) {
-        // Sanitize: valeurs non finies → null dans JSON
-        auto num = [](double v, int d){ return isfinite(v) ? String(v, d) : String("null"); };
-        String js = String("{\"gps\":{\"valid\":") + String(f.valid?1:0) + 
-                   ",\"lat\":" + num(f.latitude,7) + 
-                   ",\"lon\":" + num(f.longitude,7) +
-                   ",\"hdg\":" + num(currentHdg,1) + "}}";
-        wsBroadcastJson(js);
+        wsPubGps(f.valid, f.latitude, f.longitude, currentHdg);
         prevLat=f.latitude; prevLon=f.longitude; prevHdg=currentHdg; have=true;
         lastGpsWsMs = nowMs;
-        Serial.printf("[GPS WS] Heading: %.1f° (true: %.1f, cog: %.1f)\n", currentHdg, 
-                     isfinite(f.trueHeadingDeg) ? f.trueHeadingDeg : -999.0f, 
-                     isfinite(f.headingDeg) ? f.headingDeg : -999.0f);
-      }
-      
-      // Push aussi le dernier targetF connu périodiquement
-      if (!isnan(gTargetFLat) && !isnan(gTargetFLon) && !isnan(gTargetFR95)) {
-        static unsigned long lastTargetFWsMs = 0;
-        if (nowMs - lastTargetFWsMs >= 250) { // Plus fréquent: toutes les 250ms
-          auto num2 = [](double v, int d){ return isfinite(v) ? String(v, d) : String("null"); };
-          String js = String("{\"targetf\":{\"lat\":") + num2(gTargetFLat,7) + ",\"lon\":" + num2(gTargetFLon,7) + ",\"r95_m\":" + num2(gTargetFR95,2) + "}}";
-          wsBroadcastJson(js);
-          lastTargetFWsMs = nowMs;
-        }
+        logMsg(LOG_DEBUG, "GPS WS", "heading %.1f (true %.1f, cog %.1f)", currentHdg,
+               isfinite(f.trueHeadingDeg) ? f.trueHeadingDeg : -999.0f,
+               isfinite(f.headingDeg) ? f.headingDeg : -999.0f);
       }
+      // Les pistes (et leurs âges) sont republiées périodiquement par ws_publisher
     }
   }
     // résumé [GPS] supprimé (doublon avec $GPS)
+    gStatusCycleAllocs = allocStatsCount() - allocs0;
     lastFixOut = millis();
   }
 }
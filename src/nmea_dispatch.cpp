@@ -0,0 +1,20 @@
+#include "nmea_dispatch.h"
+
+bool nmeaSentenceKey(const NmeaField* t, int n, uint32_t& key, uint16_t& sub) {
+  if (n < 1 || t[0].len < 3) return false;
+  const NmeaField& f = t[0];
+  sub = 0;
+  if (f.p[0] == 'P') {
+    // Propriétaire: mnémonique sur 4 lettres + sous-type numérique court (PSTI,036)
+    if (f.len < 4) return false;
+    key = nmeaIdP(f.p);
+    if (n > 1 && t[1].len >= 1 && t[1].len <= 3) {
+      int v = nmeaFieldDigits(t[1], 0, t[1].len);
+      if (v >= 0) sub = (uint16_t)v;
+    }
+    return true;
+  }
+  // Standard: 3 dernières lettres (GPGGA, GNGGA -> GGA)
+  key = nmeaId3(f.p + f.len - 3);
+  return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "nmea_parse.h"
+
+// Table de dispatch NMEA à accès constant, générée à la compilation.
+// Clé: identifiant sans talker (GGA, RMC...) ou mnémonique propriétaire
+// sur 4 lettres (PSTI, PASH) + sous-type numérique éventuel (PSTI,036).
+// Un type ignoré (GSV, TXT...) est rejeté après une seule comparaison de clé.
+
+typedef bool (*NmeaHandler)(const NmeaField* t, int n);
+
+struct NmeaHandlerEntry {
+  uint32_t key;
+  uint16_t sub;
+  const char* name;
+  NmeaHandler handler;
+};
+
+// Compteurs par type: accepté / rejeté par le handler (trop court...) / checksum faux
+struct NmeaTypeStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t cksFail;
+};
+
+// Compteurs globaux (phrases sans handler)
+struct NmeaDispatchTotals {
+  uint32_t ignored;      // type inconnu ou non géré
+  uint32_t cksUnknown;   // checksum faux sur un type non géré
+  uint32_t notNmea;      // ligne sans '$' ou sans '*'
+};
+
+static const int NMEA_DISPATCH_BITS = 6;
+static const int NMEA_DISPATCH_SLOTS = 1 << NMEA_DISPATCH_BITS;
+
+// Identifiant standard (talker retiré): "GGA" -> 0x00474741
+constexpr uint32_t nmeaId3(const char* s) {
+  return ((uint32_t)(uint8_t)s[0] << 16) | ((uint32_t)(uint8_t)s[1] << 8) | (uint32_t)(uint8_t)s[2];
+}
+// Identifiant propriétaire: 4 premières lettres, 'P' inclus ("PSTI")
+constexpr uint32_t nmeaIdP(const char* s) {
+  return ((uint32_t)(uint8_t)s[0] << 24) | nmeaId3(s + 1);
+}
+constexpr uint32_t nmeaDispatchSlot(uint32_t key, uint16_t sub) {
+  return (((key ^ ((uint32_t)sub * 0x9E37u)) * 0x045D9F3Bu) >> (32 - NMEA_DISPATCH_BITS));
+}
+
+// Calcule (key, sub) d'une phrase à partir de ses premiers champs
+bool nmeaSentenceKey(const NmeaField* t, int n, uint32_t& key, uint16_t& sub);
+
+// --- Génération de la table des slots à la compilation (C++11) ---
+template<int... I> struct NmeaIntSeq {};
+template<int N, int... I> struct NmeaMakeSeq : NmeaMakeSeq<N - 1, N - 1, I...> {};
+template<int... I> struct NmeaMakeSeq<0, I...> { typedef NmeaIntSeq<I...> type; };
+
+struct NmeaSlotTable {
+  int8_t idx[NMEA_DISPATCH_SLOTS]; // index dans la table des handlers, -1 si vide
+};
+
+template<const NmeaHandlerEntry* T, int N>
+struct NmeaDispatch {
+  static constexpr int slotOwner(int slot, int i) {
+    return (i >= N) ? -1 : ((int)nmeaDispatchSlot(T[i].key, T[i].sub) == slot ? i : slotOwner(slot, i + 1));
+  }
+  static constexpr int placed(int slot) {
+    return (slot >= NMEA_DISPATCH_SLOTS) ? 0 : ((slotOwner(slot, 0) >= 0 ? 1 : 0) + placed(slot + 1));
+  }
+  template<int... S>
+  static constexpr NmeaSlotTable build(NmeaIntSeq<S...>) {
+    return NmeaSlotTable{{ (int8_t)slotOwner(S, 0)... }};
+  }
+  static constexpr NmeaSlotTable slots() {
+    return build(typename NmeaMakeSeq<NMEA_DISPATCH_SLOTS>::type());
+  }
+  // Vrai si chaque entrée a son propre slot (sinon: changer la graine ou NMEA_DISPATCH_BITS)
+  static constexpr bool collisionFree() { return placed(0) == N; }
+
+  // Index du handler pour (key, sub), -1 si non géré
+  static int find(const NmeaSlotTable& s, uint32_t key, uint16_t sub) {
+    int i = s.idx[nmeaDispatchSlot(key, sub)];
+    return (i >= 0 && T[i].key == key && T[i].sub == sub) ? i : -1;
+  }
+};
@@ -0,0 +1,166 @@
+#include "nmea_parse.h"
+#include <math.h>
+
+static const double kPow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+  1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+};
+
+static inline int hexVal(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+uint8_t nmeaChecksumBuf(const char* p, size_t len) {
+  uint8_t c = 0;
+  for (size_t i = 0; i < len; ++i) c ^= (uint8_t)p[i];
+  return c;
+}
+
+NmeaTokResult nmeaTokenize(const char* line, size_t len, NmeaField* fields, int maxFields, int& count) {
+  count = 0;
+  // Ignorer les blancs de tête (équivalent du trim() précédent)
+  while (len && (*line == ' ' || *line == '\t')) { ++line; --len; }
+  if (len < 2 || line[0] != '$') return NMEA_TOK_NOT_NMEA;
+
+  // Découpage et checksum en une seule passe
+  const char* payload = line + 1;
+  size_t i = 0, start = 0, plen = len - 1;
+  uint8_t got = 0;
+  bool star = false;
+  for (; i < plen; ++i) {
+    char c = payload[i];
+    if (c == '*') { star = true; break; }
+    got ^= (uint8_t)c;
+    if (c == ',') {
+      if (count < maxFields) { fields[count].p = payload + start; fields[count].len = (uint8_t)(i - start); count++; }
+      start = i + 1;
+    }
+  }
+  if (!star) { count = 0; return NMEA_TOK_NOT_NMEA; }
+  if (count < maxFields) { fields[count].p = payload + start; fields[count].len = (uint8_t)(i - start); count++; }
+
+  // Checksum: deux chiffres hexadécimaux après '*'
+  int h = (i + 1 < plen) ? hexVal(payload[i + 1]) : -1;
+  int l = (i + 2 < plen) ? hexVal(payload[i + 2]) : -1;
+  if (h < 0) return NMEA_TOK_BAD_CHECKSUM;
+  uint8_t want = (l < 0) ? (uint8_t)h : (uint8_t)((h << 4) | l);
+  return (got == want) ? NMEA_TOK_OK : NMEA_TOK_BAD_CHECKSUM;
+}
+
+bool nmeaFieldEquals(const NmeaField& f, const char* s) {
+  uint8_t i = 0;
+  for (; i < f.len; ++i) {
+    if (s[i] == '\0' || s[i] != f.p[i]) return false;
+  }
+  return s[i] == '\0';
+}
+
+bool nmeaFieldToInt(const NmeaField& f, int32_t& out) {
+  uint8_t i = 0;
+  bool neg = false;
+  if (i < f.len && (f.p[i] == '-' || f.p[i] == '+')) { neg = (f.p[i] == '-'); ++i; }
+  if (i >= f.len) return false;
+  int32_t v = 0;
+  bool any = false;
+  for (; i < f.len; ++i) {
+    char c = f.p[i];
+    if (c < '0' || c > '9') break; // tolère une partie décimale (ex: "07.0")
+    v = v * 10 + (c - '0');
+    any = true;
+  }
+  if (!any) return false;
+  out = neg ? -v : v;
+  return true;
+}
+
+bool nmeaFieldToDouble(const NmeaField& f, double& out) {
+  uint8_t i = 0;
+  bool neg = false;
+  if (i < f.len && (f.p[i] == '-' || f.p[i] == '+')) { neg = (f.p[i] == '-'); ++i; }
+  // Mantisse entière sur 64 bits puis une seule division: exact pour ddmm.mmmmmmm
+  uint64_t mant = 0;
+  int digits = 0, frac = 0;
+  bool dot = false;
+  for (; i < f.len; ++i) {
+    char c = f.p[i];
+    if (c == '.') { if (dot) return false; dot = true; continue; }
+    if (c < '0' || c > '9') return false;
+    if (digits < 18) {
+      mant = mant * 10 + (uint64_t)(c - '0');
+      digits++;
+      if (dot) frac++;
+    } else if (!dot) {
+      return false; // dépassement de la partie entière
+    }
+  }
+  if (!digits) return false;
+  double v = (double)mant / kPow10[frac];
+  out = neg ? -v : v;
+  return true;
+}
+
+int32_t nmeaToInt(const NmeaField& f, int32_t def) {
+  int32_t v;
+  return nmeaFieldToInt(f, v) ? v : def;
+}
+
+float nmeaToFloat(const NmeaField& f, float def) {
+  double v;
+  return nmeaFieldToDouble(f, v) ? (float)v : def;
+}
+
+double nmeaToDouble(const NmeaField& f, double def) {
+  double v;
+  return nmeaFieldToDouble(f, v) ? v : def;
+}
+
+double nmeaParseCoord(const NmeaField& value, const NmeaField& hemi) {
+  if (value.len < 4) return NAN;
+  int dot = -1;
+  for (uint8_t i = 0; i < value.len; ++i) { if (value.p[i] == '.') { dot = i; break; } }
+  if (dot < 0) return NAN;
+  // Format NMEA: latitude ddmm.mmmm, longitude dddmm.mmmm
+  int degLen = (dot > 3) ? (dot - 2) : 2;
+  if (degLen < 2) degLen = 2;
+  if (degLen > 3) degLen = 3;
+  NmeaField degF = { value.p, (uint8_t)degLen };
+  NmeaField minF = { value.p + degLen, (uint8_t)(value.len - degLen) };
+  int32_t deg;
+  double min;
+  if (!nmeaFieldToInt(degF, deg) || !nmeaFieldToDouble(minF, min)) return NAN;
+  double val = (double)deg + (min / 60.0);
+  if (hemi.len == 1 && (hemi.p[0] == 'S' || hemi.p[0] == 'W')) val = -val;
+  return val;
+}
+
+int nmeaFieldDigits(const NmeaField& f, int offset, int n) {
+  if (offset < 0 || offset + n > f.len) return -1;
+  int v = 0;
+  for (int i = 0; i < n; ++i) {
+    char c = f.p[offset + i];
+    if (c < '0' || c > '9') return -1;
+    v = v * 10 + (c - '0');
+  }
+  return v;
+}
+
+int32_t nmeaParseUtcMs(const NmeaField& f) {
+  int hh = nmeaFieldDigits(f, 0, 2);
+  int mm = nmeaFieldDigits(f, 2, 2);
+  int ss = nmeaFieldDigits(f, 4, 2);
+  if (hh < 0 || mm < 0 || ss < 0 || hh > 23 || mm > 59 || ss > 60) return -1;
+  int32_t ms = ((int32_t)hh * 3600 + mm * 60 + ss) * 1000;
+  // Fraction optionnelle: 1 à 3 chiffres significatifs
+  if (f.len > 6 && f.p[6] == '.') {
+    int32_t scale = 100;
+    for (uint8_t i = 7; i < f.len && scale > 0; ++i, scale /= 10) {
+      char c = f.p[i];
+      if (c < '0' || c > '9') return -1;
+      ms += (c - '0') * scale;
+    }
+  }
+  return ms;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Tokenizer NMEA sans allocation: travaille sur un buffer de ligne existant
+// et renvoie des vues (pointeur + longueur) sur chaque champ.
+// Module sans dépendance Arduino (compilable sur hôte).
+
+struct NmeaField {
+  const char* p;
+  uint8_t len;
+};
+
+// Nombre max de champs conservés par phrase (au-delà: ignorés)
+static const int NMEA_MAX_FIELDS = 32;
+
+// Résultat du découpage d'une ligne
+enum NmeaTokResult {
+  NMEA_TOK_OK = 0,
+  NMEA_TOK_NOT_NMEA,     // pas de '$' ou pas de '*'
+  NMEA_TOK_BAD_CHECKSUM, // checksum présent mais faux
+};
+
+// XOR de tous les octets de [p, p+len)
+uint8_t nmeaChecksumBuf(const char* p, size_t len);
+
+// Découpe "$payload*CS" en champs (le '$' et le checksum sont exclus).
+// Les vues pointent dans 'line', qui doit rester valide pendant l'utilisation.
+// 'count' reçoit le nombre de champs (même si le checksum est faux, pour statistiques).
+NmeaTokResult nmeaTokenize(const char* line, size_t len, NmeaField* fields, int maxFields, int& count);
+
+// Comparaisons / conversions sur vues
+bool nmeaFieldEquals(const NmeaField& f, const char* s);
+bool nmeaFieldToInt(const NmeaField& f, int32_t& out);
+bool nmeaFieldToDouble(const NmeaField& f, double& out);
+
+// Variantes avec valeur par défaut si champ vide ou invalide
+int32_t nmeaToInt(const NmeaField& f, int32_t def = 0);
+float nmeaToFloat(const NmeaField& f, float def = 0.0f);
+double nmeaToDouble(const NmeaField& f, double def = 0.0);
+
+// Coordonnée NMEA (ddmm.mmmm / dddmm.mmmm) + hémisphère -> degrés décimaux (NAN si invalide)
+double nmeaParseCoord(const NmeaField& value, const NmeaField& hemi);
+
+// Entier sur 'n' chiffres à partir de 'offset' (ex: hhmmss, ddmmyy). -1 si invalide.
+int nmeaFieldDigits(const NmeaField& f, int offset, int n);
+
+// Heure UTC hhmmss[.sss] -> millisecondes depuis minuit. -1 si vide ou invalide.
+int32_t nmeaParseUtcMs(const NmeaField& f);
@@ -0,0 +1,103 @@
+#include "nmea_writer.h"
+#include <math.h>
+#include <string.h>
+
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+static const uint32_t POW10[8] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+
+void nmeaWriterInit(NmeaWriter& w, char* buf, size_t cap, uint8_t headroom) {
+  w.buf = buf;
+  w.cap = (uint16_t)(cap > 0xFFFF ? 0xFFFF : cap);
+  if (headroom >= w.cap) headroom = 0;
+  w.len = headroom;
+  w.start = headroom;
+  w.lineStart = headroom;
+  w.lineLen = 0;
+  w.cks = 0;
+  w.inFrame = false;
+  w.overflow = false;
+  if (w.cap) w.buf[w.len] = 0;
+}
+
+void nmeaFrameBegin(NmeaWriter& w, char* buf, size_t cap, const char* type) {
+  nmeaWriterInit(w, buf, cap, NMEA_WS_HEADROOM);
+  nmeaPutChars(w, NMEA_WS_PREFIX, NMEA_WS_PREFIX_LEN);
+  w.lineStart = w.len;
+  nmeaPutChar(w, '$');
+  w.inFrame = true;
+  nmeaPutStr(w, type);
+}
+
+size_t nmeaFrameEnd(NmeaWriter& w) {
+  // La place de la fin est réservée par nmeaPutChars
+  w.inFrame = false;
+  char* p = w.buf + w.len;
+  p[0] = '*';
+  p[1] = HEX_DIGITS[w.cks >> 4];
+  p[2] = HEX_DIGITS[w.cks & 0x0F];
+  w.lineLen = (uint16_t)(w.len + 3 - w.lineStart);
+  p[3] = '"';
+  p[4] = '}';
+  p[5] = 0;
+  w.len += 5;
+  return w.lineLen;
+}
+
+void nmeaPutChars(NmeaWriter& w, const char* s, size_t n) {
+  size_t room = w.cap - w.len;
+  size_t reserve = w.inFrame ? NMEA_WRITER_TAIL : 1;
+  if (room < reserve + n) {
+    w.overflow = true;
+    n = (room > reserve) ? room - reserve : 0;
+  }
+  char* d = w.buf + w.len;
+  if (w.inFrame) {
+    uint8_t c = w.cks;
+    for (size_t i = 0; i < n; ++i) { d[i] = s[i]; c ^= (uint8_t)s[i]; }
+    w.cks = c;
+  } else {
+    memcpy(d, s, n);
+  }
+  w.len += (uint16_t)n;
+  w.buf[w.len] = 0;
+}
+
+void nmeaPutChar(NmeaWriter& w, char c) { nmeaPutChars(w, &c, 1); }
+
+void nmeaPutStr(NmeaWriter& w, const char* s) { nmeaPutChars(w, s, strlen(s)); }
+
+void nmeaPutU32(NmeaWriter& w, uint32_t v) {
+  char tmp[10];
+  int n = 0;
+  do { tmp[9 - n++] = (char)('0' + v % 10); v /= 10; } while (v);
+  nmeaPutChars(w, tmp + 10 - n, n);
+}
+
+void nmeaPutI32(NmeaWriter& w, int32_t v) {
+  if (v < 0) { nmeaPutChar(w, '-'); nmeaPutU32(w, (uint32_t)(-(int64_t)v)); }
+  else nmeaPutU32(w, (uint32_t)v);
+}
+
+void nmeaPutFixed(NmeaWriter& w, double v, uint8_t decimals, const char* nanText) {
+  if (!isfinite(v) || fabs(v) >= 4.0e9) { nmeaPutStr(w, nanText); return; }
+  if (decimals > 7) decimals = 7;
+  bool neg = v < 0.0;
+  if (neg) v = -v;
+  uint32_t ip = (uint32_t)v;
+  uint32_t scale = POW10[decimals];
+  uint32_t fp = (uint32_t)((v - ip) * scale + 0.5);
+  if (fp >= scale) { fp -= scale; ip++; }
+  if (neg) nmeaPutChar(w, '-');
+  nmeaPutU32(w, ip);
+  if (!decimals) return;
+  char tmp[8];
+  tmp[0] = '.';
+  for (int i = decimals; i >= 1; --i) { tmp[i] = (char)('0' + fp % 10); fp /= 10; }
+  nmeaPutChars(w, tmp, decimals + 1);
+}
+
+void nmeaPutKey(NmeaWriter& w, const char* key) {
+  nmeaPutChar(w, ',');
+  nmeaPutStr(w, key);
+  nmeaPutChar(w, '=');
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Écriture sans allocation de trames NMEA (et de petits JSON) dans un tampon
+// fourni par l'appelant (pile). Entiers et flottants en virgule fixe (pas de
+// printf ni de String), checksum XOR accumulé au fil de l'écriture.
+// Une trame est précédée de l'enveloppe WebSocket {"nmea":" et suivie de "}:
+// les mêmes octets partent tels quels sur Serial/TCP (ligne seule) et en WS
+// (enveloppe complète), sans recopie. Le texte peut commencer après une
+// réserve où la bibliothèque WebSocket écrit l'en-tête de trame sur place
+// (sinon elle alloue un tampon pour regrouper en-tête et données).
+// Au-delà de la capacité, l'écriture s'arrête (overflow) mais la fin de trame
+// reste valide. Module sans dépendance Arduino.
+
+// Réserve d'en-tête WebSocket (WEBSOCKETS_MAX_HEADER_SIZE)
+static const uint8_t NMEA_WS_HEADROOM = 14;
+static const char NMEA_WS_PREFIX[] = "{\"nmea\":\"";
+static const size_t NMEA_WS_PREFIX_LEN = sizeof(NMEA_WS_PREFIX) - 1;
+// "*HH" + "\"}" + NUL toujours réservés
+static const size_t NMEA_WRITER_TAIL = 6;
+
+struct NmeaWriter {
+  char* buf;
+  uint16_t cap;
+  uint16_t len;         // fin du texte (depuis buf)
+  uint16_t start;       // début du texte (après la réserve)
+  uint16_t lineStart;   // '$' de la trame
+  uint16_t lineLen;     // "$...*HH", fixé par nmeaFrameEnd
+  uint8_t cks;
+  bool inFrame;         // checksum accumulé
+  bool overflow;
+};
+
+// Texte libre (JSON...): pas d'enveloppe ni de checksum, 'headroom' octets réservés en tête
+void nmeaWriterInit(NmeaWriter& w, char* buf, size_t cap, uint8_t headroom = 0);
+
+// Trame: réserve WS + enveloppe + '$' + type (ex "SYS"), checksum à partir du type
+void nmeaFrameBegin(NmeaWriter& w, char* buf, size_t cap, const char* type);
+// Ajoute "*HH" et ferme l'enveloppe; retourne la longueur de la ligne "$...*HH"
+size_t nmeaFrameEnd(NmeaWriter& w);
+inline const char* nmeaFrameLine(const NmeaWriter& w) { return w.buf + w.lineStart; }
+
+void nmeaPutChar(NmeaWriter& w, char c);
+void nmeaPutChars(NmeaWriter& w, const char* s, size_t n);
+void nmeaPutStr(NmeaWriter& w, const char* s);
+void nmeaPutU32(NmeaWriter& w, uint32_t v);
+void nmeaPutI32(NmeaWriter& w, int32_t v);
+// 'decimals' 0..7, arrondi au plus proche; non fini -> 'nanText' ("nan" en NMEA, "null" en JSON)
+void nmeaPutFixed(NmeaWriter& w, double v, uint8_t decimals, const char* nanText = "nan");
+// ",key=" puis la valeur
+void nmeaPutKey(NmeaWriter& w, const char* key);
+
+// Texte terminé par NUL (après la réserve) et sa longueur
+inline const char* nmeaText(const NmeaWriter& w) { return w.buf + w.start; }
+inline size_t nmeaTextLen(const NmeaWriter& w) { return w.len - w.start; }
@@ -0,0 +1,120 @@
+#include "pose_history.h"
+#include <math.h>
+
+static float wrap360(float a) {
+  a = fmodf(a, 360.0f);
+  return (a < 0.0f) ? a + 360.0f : a;
+}
+
+// Écart de cap signé dans [-180, 180)
+static float headingDelta(float from, float to) {
+  float d = fmodf(to - from + 540.0f, 360.0f);
+  if (d < 0.0f) d += 360.0f;
+  return d - 180.0f;
+}
+
+// Combinaison o + a*(n-o); a hors [0,1] pour l'extrapolation
+static void blend(const PoseSample& o, const PoseSample& n, double a, int64_t tUs, PoseSample& out) {
+  const PoseSample& near = (a < 0.5) ? o : n;
+  out.tUs = tUs;
+  out.latitude = o.latitude + a * (n.latitude - o.latitude);
+  out.longitude = o.longitude + a * (n.longitude - o.longitude);
+  if (isfinite(o.headingDeg) && isfinite(n.headingDeg)) {
+    out.headingDeg = wrap360(o.headingDeg + (float)a * headingDelta(o.headingDeg, n.headingDeg));
+  } else {
+    out.headingDeg = near.headingDeg;
+  }
+  if (isfinite(o.pitchDeg) && isfinite(n.pitchDeg) && isfinite(o.rollDeg) && isfinite(n.rollDeg)) {
+    out.pitchDeg = o.pitchDeg + (float)a * (n.pitchDeg - o.pitchDeg);
+    out.rollDeg = o.rollDeg + (float)a * (n.rollDeg - o.rollDeg);
+  } else {
+    out.pitchDeg = near.pitchDeg;
+    out.rollDeg = near.rollDeg;
+  }
+  out.hdop = near.hdop;
+  out.fixQuality = near.fixQuality;
+}
+
+void poseHistoryPush(PoseHistory& h, const PoseSample& s) {
+  uint32_t n = h.head.load(std::memory_order_relaxed);
+  if (n) {
+    // Écrivain unique: la dernière case ne peut pas changer pendant cette lecture
+    PoseSample last;
+    h.slots[(n - 1) % POSE_HISTORY_LEN].read(last);
+    if (s.tUs <= last.tUs) return; // horodatage non croissant (republication, mock figé)
+  }
+  h.slots[n % POSE_HISTORY_LEN].write(s);
+  h.head.store(n + 1, std::memory_order_release);
+}
+
+PoseLookup poseHistoryAt(const PoseHistory& h, int64_t tUs, PoseSample& out) {
+  uint32_t n = h.head.load(std::memory_order_acquire);
+  if (n == 0) return POSE_NONE;
+  uint32_t avail = (n < (uint32_t)POSE_HISTORY_LEN) ? n : (uint32_t)POSE_HISTORY_LEN;
+
+  PoseSample newer;
+  h.slots[(n - 1) % POSE_HISTORY_LEN].read(newer);
+  if (tUs >= newer.tUs) {
+    if (tUs - newer.tUs > POSE_MAX_EXTRAP_US) return POSE_NONE;
+    PoseSample older;
+    if (avail < 2) { out = newer; out.tUs = tUs; return POSE_EXTRAP; }
+    h.slots[(n - 2) % POSE_HISTORY_LEN].read(older);
+    int64_t span = newer.tUs - older.tUs;
+    if (span <= 0 || span > POSE_MAX_GAP_US) { out = newer; out.tUs = tUs; return POSE_EXTRAP; }
+    blend(older, newer, (double)(tUs - older.tUs) / (double)span, tUs, out);
+    return POSE_EXTRAP;
+  }
+
+  for (uint32_t k = 2; k <= avail; ++k) {
+    PoseSample older;
+    h.slots[(n - k) % POSE_HISTORY_LEN].read(older);
+    // Case recyclée par l'écrivain pendant le parcours: historique trop court pour tUs
+    if (older.tUs >= newer.tUs) return POSE_NONE;
+    if (older.tUs <= tUs) {
+      int64_t span = newer.tUs - older.tUs;
+      if (span > POSE_MAX_GAP_US) return POSE_NONE;
+      blend(older, newer, (double)(tUs - older.tUs) / (double)span, tUs, out);
+      return POSE_INTERP;
+    }
+    newer = older;
+  }
+  return POSE_NONE;
+}
+
+int poseHistoryCopy(const PoseHistory& h, PoseSample* out, int maxOut) {
+  uint32_t n = h.head.load(std::memory_order_acquire);
+  uint32_t avail = (n < (uint32_t)POSE_HISTORY_LEN) ? n : (uint32_t)POSE_HISTORY_LEN;
+  if (maxOut <= 0) return 0;
+  if (avail > (uint32_t)maxOut) avail = (uint32_t)maxOut;
+  // Parcours du plus récent au plus ancien, arrêt sur une case recyclée pendant la copie
+  int got = 0;
+  int64_t newer = INT64_MAX;
+  for (uint32_t k = 1; k <= avail; ++k) {
+    PoseSample s;
+    h.slots[(n - k) % POSE_HISTORY_LEN].read(s);
+    if (s.tUs >= newer) break;
+    newer = s.tUs;
+    out[avail - k] = s;
+    got++;
+  }
+  if (got < (int)avail) {
+    for (int i = 0; i < got; ++i) out[i] = out[avail - got + i];
+  }
+  return got;
+}
+
+int64_t poseHistoryNewestUs(const PoseHistory& h) {
+  uint32_t n = h.head.load(std::memory_order_acquire);
+  if (n == 0) return 0;
+  PoseSample s;
+  h.slots[(n - 1) % POSE_HISTORY_LEN].read(s);
+  return s.tUs;
+}
+
+const char* poseLookupName(PoseLookup r) {
+  switch (r) {
+    case POSE_INTERP: return "interp";
+    case POSE_EXTRAP: return "extrap";
+    default: return "none";
+  }
+}
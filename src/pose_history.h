@@ -0,0 +1,53 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include "seqlock.h"
+
+// Historique horodaté de la pose du bateau (position + cap), mémoire fixe.
+// Alimenté à chaque époque GPS publiée; permet de fusionner un ping SEAKER
+// avec la pose à son instant réel plutôt qu'avec le dernier fix connu.
+// Un seul écrivain (sérialisé par l'appelant), lecteurs sans verrou: chaque
+// case est un seqlock, l'index d'écriture est atomique.
+// Module sans dépendance Arduino.
+
+static const int POSE_HISTORY_LEN = 64;                 // ~6 s à 10 Hz
+static const int64_t POSE_MAX_GAP_US = 1500000;         // pas d'interpolation au-delà d'un trou de 1,5 s
+static const int64_t POSE_MAX_EXTRAP_US = 250000;       // extrapolation bornée après la dernière pose
+
+struct PoseSample {
+  int64_t tUs;          // instant local (timeLocalUs) de la pose
+  double latitude;
+  double longitude;
+  float headingDeg;     // azimut plateforme (cap vrai, sinon route fond), NAN si inconnu
+  float pitchDeg;       // tangage / roulis de l'époque (PSTI036/PASHR), NAN si inconnus
+  float rollDeg;
+  float hdop;
+  uint8_t fixQuality;
+};
+
+enum PoseLookup : uint8_t {
+  POSE_NONE = 0,        // hors historique, trou trop long ou extrapolation hors borne
+  POSE_INTERP,          // encadrée par deux poses
+  POSE_EXTRAP,          // après la dernière pose, dans POSE_MAX_EXTRAP_US
+};
+
+struct PoseHistory {
+  SeqLock<PoseSample> slots[POSE_HISTORY_LEN];
+  std::atomic<uint32_t> head;   // nombre total de poses écrites
+
+  PoseHistory() : head(0) {}
+};
+
+void poseHistoryPush(PoseHistory& h, const PoseSample& s);
+
+// Pose à l'instant tUs (interpolation linéaire, cap par le plus court arc, attitude
+// interpolée si connue aux deux bornes)
+PoseLookup poseHistoryAt(const PoseHistory& h, int64_t tUs, PoseSample& out);
+
+// Copie les 'maxOut' dernières poses, de la plus ancienne à la plus récente
+int poseHistoryCopy(const PoseHistory& h, PoseSample* out, int maxOut);
+
+// Instant de la pose la plus récente, 0 si historique vide
+int64_t poseHistoryNewestUs(const PoseHistory& h);
+
+const char* poseLookupName(PoseLookup r);
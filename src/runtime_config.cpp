@@ -22,7 +22,17 @@ volatile float gSeakerAngleSigmaDeg = 3.0f;
 volatile float gSeakerRangeRel = 0.005f; // 0.5%
 volatile float gKalmanAccelStd = 0.5f;
 volatile float gKalmanGate = 4.0f;
+volatile uint8_t gKalmanMeasMode = 0; // point cartésien; EKF/UKF polaires sur demande (CLI 'F')
+volatile uint8_t gKalmanSmoothLag = 0;
+volatile bool gKalmanImm = false; // modèle unique; IMM sur demande (CLI 'T')
 volatile bool gTatFilterEnabled = true;
+volatile bool gGpsBinaryMode = false;
+volatile uint8_t gGpsRateHz = 0;
+VesselGeometry gVessel = {0, 0, 0, 0, 0, 0, 0, 0, true};
+volatile bool gSvpEnabled = true;
+volatile float gSvpHeadDepth = 1.0f;
+volatile float gSvpBeaconDepth = NAN;
+volatile uint16_t gWsTickMs = 100;
 
 // UDP target streaming removed
 
@@ -112,6 +122,9 @@ void loadFilterPrefs(){
   if (prefs.isKey("rngrel")) gSeakerRangeRel = prefs.getFloat("rngrel");
   if (prefs.isKey("aStd")) gKalmanAccelStd = prefs.getFloat("aStd");
   if (prefs.isKey("gate")) gKalmanGate = prefs.getFloat("gate");
+  if (prefs.isKey("mmode")) gKalmanMeasMode = prefs.getUChar("mmode");
+  if (prefs.isKey("slag")) gKalmanSmoothLag = prefs.getUChar("slag");
+  if (prefs.isKey("imm")) gKalmanImm = prefs.getBool("imm");
   if (prefs.isKey("tatEn")) gTatFilterEnabled = prefs.getBool("tatEn");
   prefs.end();
 }
@@ -122,10 +135,83 @@ void saveFilterPrefs(){
   prefs.putFloat("rngrel", gSeakerRangeRel);
   prefs.putFloat("aStd", gKalmanAccelStd);
   prefs.putFloat("gate", gKalmanGate);
+  prefs.putUChar("mmode", gKalmanMeasMode);
+  prefs.putUChar("slag", gKalmanSmoothLag);
+  prefs.putBool("imm", gKalmanImm);
   prefs.putBool("tatEn", gTatFilterEnabled);
   prefs.end();
 }
 
+void loadVesselPrefs(){
+  prefs.begin("vessel", false);
+  if (prefs.isKey("antX")) gVessel.antX = prefs.getFloat("antX");
+  if (prefs.isKey("antY")) gVessel.antY = prefs.getFloat("antY");
+  if (prefs.isKey("antZ")) gVessel.antZ = prefs.getFloat("antZ");
+  if (prefs.isKey("hdX")) gVessel.headX = prefs.getFloat("hdX");
+  if (prefs.isKey("hdY")) gVessel.headY = prefs.getFloat("hdY");
+  if (prefs.isKey("hdZ")) gVessel.headZ = prefs.getFloat("hdZ");
+  if (prefs.isKey("mPitch")) gVessel.mountPitchDeg = prefs.getFloat("mPitch");
+  if (prefs.isKey("mRoll")) gVessel.mountRollDeg = prefs.getFloat("mRoll");
+  if (prefs.isKey("att")) gVessel.attitude = prefs.getBool("att");
+  prefs.end();
+}
+
+void saveVesselPrefs(){
+  prefs.begin("vessel", false);
+  prefs.putFloat("antX", gVessel.antX);
+  prefs.putFloat("antY", gVessel.antY);
+  prefs.putFloat("antZ", gVessel.antZ);
+  prefs.putFloat("hdX", gVessel.headX);
+  prefs.putFloat("hdY", gVessel.headY);
+  prefs.putFloat("hdZ", gVessel.headZ);
+  prefs.putFloat("mPitch", gVessel.mountPitchDeg);
+  prefs.putFloat("mRoll", gVessel.mountRollDeg);
+  prefs.putBool("att", gVessel.attitude);
+  prefs.end();
+}
+
+void loadSvpPrefs(){
+  prefs.begin("svp", false);
+  if (prefs.isKey("en")) gSvpEnabled = prefs.getBool("en");
+  if (prefs.isKey("hd")) gSvpHeadDepth = prefs.getFloat("hd");
+  if (prefs.isKey("bd")) gSvpBeaconDepth = prefs.getFloat("bd");
+  prefs.end();
+}
+
+void saveSvpPrefs(){
+  prefs.begin("svp", false);
+  prefs.putBool("en", gSvpEnabled);
+  prefs.putFloat("hd", gSvpHeadDepth);
+  prefs.putFloat("bd", gSvpBeaconDepth);
+  prefs.end();
+}
+
+void loadWsPrefs(){
+  prefs.begin("ws", false);
+  if (prefs.isKey("tick")) gWsTickMs = prefs.getUShort("tick");
+  prefs.end();
+}
+
+void saveWsPrefs(){
+  prefs.begin("ws", false);
+  prefs.putUShort("tick", gWsTickMs);
+  prefs.end();
+}
+
+void loadGpsPrefs(){
+  prefs.begin("gps", false);
+  if (prefs.isKey("bin")) gGpsBinaryMode = prefs.getBool("bin");
+  if (prefs.isKey("hz")) gGpsRateHz = prefs.getUChar("hz");
+  prefs.end();
+}
+
+void saveGpsPrefs(){
+  prefs.begin("gps", false);
+  prefs.putBool("bin", gGpsBinaryMode);
+  prefs.putUChar("hz", gGpsRateHz);
+  prefs.end();
+}
+
 // loadTargetUdpFromPrefs/saveTargetUdpToPrefs removed
 
 uint8_t loadLogLevelFromPrefs(){
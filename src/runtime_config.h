@@ -1,5 +1,6 @@
 #pragma once
 #include <Arduino.h>
+#include "vessel_geometry.h"
 
 // NTRIP configuration shared between modules
 extern String gNtripHost;
@@ -31,13 +32,32 @@ void saveDemoToPrefs();
 extern volatile bool gSeakerInvertAngle;     // inverser l'angle (miroir)
 extern volatile float gSeakerAngleOffsetDeg; // offset en degrés (ajouté après inversion)
 
+// GPS: sortie binaire SkyTraq au lieu de NMEA texte
+extern volatile bool gGpsBinaryMode;
+// GPS: cadence de position (Hz, message 0x0E), 0 = réglage du récepteur
+extern volatile uint8_t gGpsRateHz;
+
 // Filtrage / incertitudes
 extern volatile float gSeakerAngleSigmaDeg; // écart-type angulaire SEAKER (deg)
 extern volatile float gSeakerRangeRel;      // erreur relative de distance (fraction, ex 0.005 = 0.5%)
 extern volatile float gKalmanAccelStd;      // bruit process (m/s^2)
 extern volatile float gKalmanGate;          // seuil d'innovation pour rejet (en sigma)
+extern volatile uint8_t gKalmanMeasMode;    // mesure du filtre: 0 = point cartésien, 1 = EKF polaire, 2 = UKF polaire
+extern volatile bool gKalmanImm;            // pistage IMM (immobile / vitesse constante / manœuvrant) au lieu du modèle unique
+extern volatile uint8_t gKalmanSmoothLag;   // retard du lisseur RTS ($TARGETS), en pings; 0 = désactivé
 extern volatile bool gTatFilterEnabled;     // activation du filtre TAT
 
+// Géométrie du bateau (bras de levier antenne -> tête SEAKER, montage, attitude)
+extern VesselGeometry gVessel;              // appliquée via targetFusionSetVessel()
+
+// Profil de célérité (svp_table): correction de réfraction de la distance SEAKER
+extern volatile bool gSvpEnabled;           // appliquer la grille si un profil est chargé
+extern volatile float gSvpHeadDepth;        // profondeur de la tête SEAKER (m), grille reconstruite si modifiée
+extern volatile float gSvpBeaconDepth;      // profondeur de la balise (m), NAN = à la profondeur de la tête
+
+// WebSocket: intervalle de publication de l'état regroupé (ws_publisher)
+extern volatile uint16_t gWsTickMs;         // ms, 20..2000
+
 // Persistence helpers (Preferences)
 void loadWifiFromPrefs();
 void saveWifiToPrefs();
@@ -47,6 +67,14 @@ void loadSeakerCalibFromPrefs();
 void saveSeakerCalibToPrefs();
 void loadFilterPrefs();
 void saveFilterPrefs();
+void loadGpsPrefs();
+void saveGpsPrefs();
+void loadVesselPrefs();
+void saveVesselPrefs();
+void loadSvpPrefs();
+void saveSvpPrefs();
+void loadWsPrefs();
+void saveWsPrefs();
 
 // SEAKER configuration frames (payload without '$' and checksum)
 extern String gSeakerConfig[4];
@@ -2,23 +2,40 @@
 #include "config.h"
 #include "runtime_config.h"
 #include "console_broadcast.h"
+#include "seaker_proto.h"
+#include "nmea_parse.h"
+#include "time_base.h"
+#include "spsc_queue.h"
+#include "target_fusion.h"
+
+static const size_t SEAKER_LINE_MAX = 256;
 
 static HardwareSerial* seakerSerial = nullptr;
+static uint32_t seakerBaud = 0;
 SeakerState gSeaker;
 static bool mockOn = false;
 static float mockBaseAngle = 0.0f, mockBaseDist = 10.0f, mockNoiseAng = 3.0f, mockNoiseDist = 1.5f;
 static bool mockSweep = false; static float mockSweepRate = 0.0f; static unsigned long mockLastMs = 0;
 static float mockAngleAccum = 0.0f; static unsigned long mockStartMs = 0;
 static bool echoSeaker = false;
+static const unsigned long MOCK_PING_PERIOD_MS = 250;
+static SpscQueue<SeakerPing, SEAKER_PING_QUEUE_LEN> pingQueue;
+static volatile uint8_t activeBeacon = 0;   // écrit par loop/web, lu par la tâche seaker
+
+bool seakerPopPing(SeakerPing& out) { return pingQueue.pop(out); }
+bool seakerPeekPing(SeakerPing& out) { return pingQueue.peek(out); }
 
-static uint8_t nmeaChecksum(const String& s) {
-  uint8_t c = 0;
-  for (size_t i = 0; i < s.length(); ++i) c ^= (uint8_t)s[i];
-  return c;
+SeakerQueueStats seakerGetQueueStats() {
+  SeakerQueueStats s;
+  s.enqueued = pingQueue.enqueued();
+  s.consumed = pingQueue.consumed();
+  s.overflow = pingQueue.dropped();
+  return s;
 }
 
 void startSEAKER(HardwareSerial& serial, uint32_t baud, int rxPin, int txPin) {
   seakerSerial = &serial;
+  seakerBaud = baud;
   serial.begin(baud, SERIAL_8N1, rxPin, txPin);
   serial.setTimeout(2); // réduire pour limiter les blocages
 }
@@ -26,58 +43,47 @@ void startSEAKER(HardwareSerial& serial, uint32_t baud, int rxPin, int txPin) {
 bool sendSEAKERCommand(const String& payload) {
   if (!seakerSerial) return false;
   String frame = "$" + payload;
-  uint8_t cks = nmeaChecksum(payload);
+  uint8_t cks = nmeaChecksumBuf(payload.c_str(), payload.length());
   char buf[8];
   snprintf(buf, sizeof(buf), "*%02X\r\n", cks);
   frame += buf;
   size_t n = seakerSerial->print(frame);
+  // Changement de canal: les pings suivants sont routés vers la piste de cette balise
+  int ch = seakerCommandChannel(payload.c_str(), payload.length());
+  if (ch > 0 && n == frame.length()) activeBeacon = (uint8_t)ch;
   return n == frame.length();
 }
 
-static void parseSTATUS(const String* t, int n) {
-  // $STATUS,<status>,freq,snr,etx,erx,...*CS (format adaptatif)
-  if (n >= 2) gSeaker.lastStatus = t[1];
-  if (n >= 3 && t[2].length()) gSeaker.rxFrequency = t[2].toFloat();
-  if (n >= 4 && t[3].length()) gSeaker.snr = t[3].toFloat();
-  if (n >= 5 && t[4].length()) gSeaker.energyTx = t[4].toFloat();
-  if (n >= 6 && t[5].length()) gSeaker.energyRx = t[5].toFloat();
-}
+uint8_t seakerActiveBeacon() { return activeBeacon; }
+void seakerSetActiveBeacon(uint8_t id) { activeBeacon = id; }
 
-static void parseDTPING(const String* t, int n) {
-  // Formats observés:
-  // 1) $DTPING,<TOF>,<TAT_ms>,<angle_deg>,<distance_dm>,...*CS
-  // 2) $DTPING,<angle_deg>,<distance_m>,...*CS (legacy)
-  float angleDeg = NAN;
-  float distanceM = NAN;
-  int tatMs = -1;
-  if (n >= 5 && t[3].length() && t[4].length()) {
-    // Nouveau format avec TAT en millisecondes
-    if (t[2].length()) tatMs = t[2].toInt();
-    angleDeg = t[3].toFloat();
-    // Distance exprimée en décimètres -> convertir en mètres
-    distanceM = t[4].toFloat() / 10.0f;
-  } else if (n >= 3 && t[1].length() && t[2].length()) {
-    // Format legacy sans TAT
-    angleDeg = t[1].toFloat();
-    distanceM = t[2].toFloat();
-  }
+static void applyStatus(const SeakerStatusRec& st) {
+  memcpy(gSeaker.lastStatus, st.status, sizeof(gSeaker.lastStatus));
+  if (isfinite(st.rxFrequency)) gSeaker.rxFrequency = st.rxFrequency;
+  if (isfinite(st.snr)) gSeaker.snr = st.snr;
+  if (isfinite(st.energyTx)) gSeaker.energyTx = st.energyTx;
+  if (isfinite(st.energyRx)) gSeaker.energyRx = st.energyRx;
+}
 
-  bool hasUseful = (isfinite(angleDeg) || isfinite(distanceM));
+static void applyPing(const SeakerPing& p) {
+  bool hasUseful = (isfinite(p.angleDeg) || isfinite(p.distanceM));
   bool accept = hasUseful;
   // Validation TAT: accepter uniquement si TAT est proche d'un multiple de 2000 ms
   // Tolérance par défaut: ±100 ms
-  if (accept && tatMs >= 0 && gTatFilterEnabled) {
-    const int expectedMs = 2000;
-    const int tolMs = 100;
-    int r = tatMs % expectedMs;
-    if (!(r <= tolMs || r >= expectedMs - tolMs)) {
-      accept = false;
-      gSeaker.rejectedTat++;
-    }
+  if (accept && gTatFilterEnabled && !seakerTatAccepted(p.tatMs, 2000, 100)) {
+    accept = false;
+    gSeaker.rejectedTat++;
   }
   if (accept) {
-    if (isfinite(angleDeg)) gSeaker.lastAngle = angleDeg;
-    if (isfinite(distanceM)) gSeaker.lastDistance = distanceM;
+    gSeaker.lastPing = p;
+    gSeaker.lastPing.beaconId = activeBeacon;
+    if (isfinite(p.angleDeg)) gSeaker.lastAngle = p.angleDeg;
+    if (isfinite(p.distanceM)) gSeaker.lastDistance = p.distanceM;
+    // Enregistrement complet: un champ absent reprend la dernière valeur connue
+    SeakerPing q = gSeaker.lastPing;
+    q.angleDeg = gSeaker.lastAngle;
+    q.distanceM = gSeaker.lastDistance;
+    if (pingQueue.push(q)) targetFusionNotify();
     gSeaker.pingCounter++;
     gSeaker.acceptedPings++;
   }
@@ -96,43 +102,37 @@ static void parseDTPING(const String* t, int n) {
     lastRej = gSeaker.rejectedTat;
     lastReportMs = now;
     // Construire une trame $SEAK,TATSTAT,acc2s=..,rej2s=..
-    String payload = String("SEAK,TATSTAT,acc2s=") + String(acc2s) + ",rej2s=" + String(rej2s);
-    uint8_t cks = nmeaChecksum(payload);
-    char buf[8]; snprintf(buf, sizeof(buf), "*%02X", cks);
-    String line = String("$") + payload + String(buf);
+    char line[64];
+    int n = snprintf(line, sizeof(line), "$SEAK,TATSTAT,acc2s=%lu,rej2s=%lu", acc2s, rej2s);
+    uint8_t cks = nmeaChecksumBuf(line + 1, n - 1);
+    n += snprintf(line + n, sizeof(line) - n, "*%02X", cks);
     Serial.println(line);
-    consoleBroadcastLine(line);
+    consoleBroadcastLine(line, (size_t)n);
   }
 }
 
-void parseSeakerNMEA(const String& line) {
-  if (!line.startsWith("$")) return;
-  int star = line.indexOf('*');
-  if (star < 0) return;
-  String payload = line.substring(1, star);
-  String cks = line.substring(star + 1);
-  cks.trim();
-  uint8_t want = (uint8_t)strtol(cks.c_str(), nullptr, 16);
-  uint8_t got = 0; for (size_t i=0;i<payload.length();++i) got ^= (uint8_t)payload[i];
-  if (got != want) return;
-
-  const int MAXT = 32;
-  String tokens[MAXT];
-  int idx = 0, start = 0;
-  for (int i = 0; i <= payload.length() && idx < MAXT; ++i) {
-    if (i == payload.length() || payload[i] == ',') {
-      tokens[idx++] = payload.substring(start, i);
-      start = i + 1;
-    }
+void parseSeakerNMEA(const char* line, size_t len) {
+  SeakerPing ping;
+  SeakerStatusRec st;
+  // Appelé dès la fin de ligne. L'instant utile est l'arrivée de la réponse acoustique
+  // sur la tête (gisement mesuré à cet instant), qui précède l'envoi de la phrase:
+  // on retranche sa durée de transmission série (CR LF compris, 10 bits par octet).
+  // Le temps de vol et le TAT s'écoulent avant cette arrivée et ne sont pas retranchés;
+  // le traitement interne du SEAKER, inconnu, n'est pas compensé.
+  int64_t rxUs = timeLocalUs();
+  if (seakerBaud) rxUs -= (int64_t)(len + 2) * 10000000LL / seakerBaud;
+  switch (seakerDecodeLine(line, len, millis(), ping, st)) {
+    case SEAKER_SENT_STATUS: applyStatus(st); break;
+    case SEAKER_SENT_DTPING: ping.rxUs = rxUs; applyPing(ping); break;
+    default: break;
   }
-  if (idx == 0) return;
-  if (tokens[0] == "STATUS") { parseSTATUS(tokens, idx); }
-  else if (tokens[0] == "DTPING") { parseDTPING(tokens, idx); }
 }
 
 void pollSEAKER() {
   if (mockOn) {
     unsigned long now = millis();
+    // Cadence des pings simulés (la tâche tourne à 100 Hz, chaque ping est désormais fusionné)
+    if (mockLastMs != 0 && now - mockLastMs < MOCK_PING_PERIOD_MS) return;
     double dt = (mockLastMs==0)? 0.0 : (now - mockLastMs) / 1000.0; 
     mockLastMs = now;
     if (mockSweep) {
@@ -142,30 +142,39 @@ void pollSEAKER() {
     }
     float ang = mockBaseAngle + (mockSweep ? mockAngleAccum : 0.0f) + ((float)random(-100,101)/100.0f)*mockNoiseAng;
     float dist = max(0.0f, mockBaseDist + ((float)random(-100,101)/100.0f)*mockNoiseDist);
-    gSeaker.lastAngle = ang; gSeaker.lastDistance = dist; gSeaker.lastStatus = "MOCK";
+    gSeaker.lastAngle = ang; gSeaker.lastDistance = dist; strcpy(gSeaker.lastStatus, "MOCK");
+    gSeaker.lastPing.tof = NAN; gSeaker.lastPing.tatMs = -1;
+    gSeaker.lastPing.angleDeg = ang; gSeaker.lastPing.distanceM = dist; gSeaker.lastPing.rxMs = now;
+    gSeaker.lastPing.rxUs = timeLocalUs();
+    gSeaker.lastPing.beaconId = activeBeacon;
     // Générer un "ping" pour déclencher l'update des frames TARGET/TARGETF
+    if (pingQueue.push(gSeaker.lastPing)) targetFusionNotify();
     gSeaker.pingCounter++;
     gSeaker.acceptedPings++;
     return;
   }
   if (!seakerSerial) return;
-  static String lineBuf;
+  static char lineBuf[SEAKER_LINE_MAX + 1];
+  static size_t lineLen = 0;
+  static bool lineOverflow = false;
   int guard = 0; // éviter de monopoliser trop longtemps
   while (seakerSerial->available() && guard++ < 256) {
     char ch = (char)seakerSerial->read();
     if (ch == '\r' || ch == '\n') {
-      if (lineBuf.length()) {
-        String line = lineBuf; line.trim(); lineBuf = "";
-        if (!line.isEmpty()) {
-          // Suppression echo SEAKER pour éviter flood série
-          // if (echoSeaker) Serial.println(line);
-          consoleBroadcastLine(line);
-          parseSeakerNMEA(line);
-        }
-      }
+      size_t len = lineLen;
+      bool drop = lineOverflow;
+      lineLen = 0; lineOverflow = false;
+      while (len && (lineBuf[len-1] == ' ' || lineBuf[len-1] == '\t')) len--;
+      if (!len || drop) continue;
+      lineBuf[len] = '\0';
+      // Suppression echo SEAKER pour éviter flood série
+      // if (echoSeaker) Serial.println(lineBuf);
+      consoleBroadcastLine(lineBuf, len);
+      parseSeakerNMEA(lineBuf, len);
+    } else if (lineLen < SEAKER_LINE_MAX) {
+      lineBuf[lineLen++] = ch;
     } else {
-      lineBuf += ch;
-      if (lineBuf.length() > 256) lineBuf.remove(0, lineBuf.length() - 256);
+      lineOverflow = true;
     }
   }
 }
@@ -1,10 +1,12 @@
 #pragma once
 #include <Arduino.h>
+#include "seaker_proto.h"
 
 struct SeakerState {
   float lastAngle = NAN;
   float lastDistance = NAN;
-  String lastStatus;
+  char lastStatus[SEAKER_STATUS_MAX] = "";
+  SeakerPing lastPing = {NAN, -1, NAN, NAN, 0, 0, 0}; // dernier ping accepté
   volatile unsigned long pingCounter = 0; // incrémenté à chaque $DTPING valide
   volatile unsigned long acceptedPings = 0; // pings acceptés (après filtrage TAT)
   volatile unsigned long rejectedTat = 0;   // pings rejetés par le filtre TAT
@@ -19,10 +21,27 @@ struct SeakerState {
 
 extern SeakerState gSeaker;
 
+// File des pings acceptés (tâche seaker -> fusion cible), chaque ping livré une fois, dans l'ordre
+static const uint32_t SEAKER_PING_QUEUE_LEN = 16;
+
+struct SeakerQueueStats {
+  uint32_t enqueued;
+  uint32_t consumed;
+  uint32_t overflow;   // pings perdus, file pleine
+};
+
+// Consommateur unique: retire le plus ancien ping en attente
+bool seakerPopPing(SeakerPing& out);
+bool seakerPeekPing(SeakerPing& out);
+SeakerQueueStats seakerGetQueueStats();
+
 void startSEAKER(HardwareSerial& serial, uint32_t baud, int rxPin, int txPin);
-void parseSeakerNMEA(const String& line);
+void parseSeakerNMEA(const char* line, size_t len);
 void pollSEAKER();
 bool sendSEAKERCommand(const String& payload);
+// Balise interrogée: canal du dernier CONFIG envoyé, attribué aux pings reçus ensuite
+uint8_t seakerActiveBeacon();
+void seakerSetActiveBeacon(uint8_t id);
 
 // Dev/Debug
 void seakerSetEchoRaw(bool enable);
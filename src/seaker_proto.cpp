@@ -0,0 +1,76 @@
+#include "seaker_proto.h"
+#include "nmea_parse.h"
+#include <math.h>
+#include <string.h>
+
+static void decodeSTATUS(const NmeaField* t, int n, SeakerStatusRec& st) {
+  // $STATUS,<status>,freq,snr,etx,erx,...*CS (format adaptatif)
+  st.status[0] = '\0';
+  if (n >= 2) {
+    size_t l = t[1].len < SEAKER_STATUS_MAX - 1 ? t[1].len : SEAKER_STATUS_MAX - 1;
+    for (size_t i = 0; i < l; ++i) st.status[i] = t[1].p[i];
+    st.status[l] = '\0';
+  }
+  st.rxFrequency = (n >= 3) ? nmeaToFloat(t[2], NAN) : NAN;
+  st.snr = (n >= 4) ? nmeaToFloat(t[3], NAN) : NAN;
+  st.energyTx = (n >= 5) ? nmeaToFloat(t[4], NAN) : NAN;
+  st.energyRx = (n >= 6) ? nmeaToFloat(t[5], NAN) : NAN;
+}
+
+static void decodeDTPING(const NmeaField* t, int n, SeakerPing& p) {
+  // Formats observés:
+  // 1) $DTPING,<TOF>,<TAT_ms>,<angle_deg>,<distance_dm>,...*CS
+  // 2) $DTPING,<angle_deg>,<distance_m>,...*CS (legacy)
+  p.tof = NAN;
+  p.tatMs = -1;
+  p.angleDeg = NAN;
+  p.distanceM = NAN;
+  if (n >= 5 && t[3].len && t[4].len) {
+    // Nouveau format avec TAT en millisecondes
+    p.tof = nmeaToFloat(t[1], NAN);
+    if (t[2].len) p.tatMs = nmeaToInt(t[2], -1);
+    p.angleDeg = nmeaToFloat(t[3], NAN);
+    // Distance exprimée en décimètres -> convertir en mètres
+    p.distanceM = nmeaToFloat(t[4], NAN) / 10.0f;
+  } else if (n >= 3 && t[1].len && t[2].len) {
+    // Format legacy sans TAT
+    p.angleDeg = nmeaToFloat(t[1], NAN);
+    p.distanceM = nmeaToFloat(t[2], NAN);
+  }
+}
+
+SeakerSentenceType seakerDecodeLine(const char* line, size_t len, uint32_t rxMs,
+                                    SeakerPing& ping, SeakerStatusRec& status) {
+  NmeaField t[NMEA_MAX_FIELDS];
+  int n = 0;
+  if (nmeaTokenize(line, len, t, NMEA_MAX_FIELDS, n) != NMEA_TOK_OK || n == 0) return SEAKER_SENT_NONE;
+  if (nmeaFieldEquals(t[0], "DTPING")) {
+    decodeDTPING(t, n, ping);
+    ping.rxMs = rxMs;
+    ping.rxUs = 0;
+    ping.beaconId = 0;
+    return SEAKER_SENT_DTPING;
+  }
+  if (nmeaFieldEquals(t[0], "STATUS")) {
+    decodeSTATUS(t, n, status);
+    return SEAKER_SENT_STATUS;
+  }
+  return SEAKER_SENT_NONE;
+}
+
+int seakerCommandChannel(const char* payload, size_t len) {
+  static const char kHead[] = "CONFIG,";
+  const size_t hl = sizeof(kHead) - 1;
+  if (len <= hl || memcmp(payload, kHead, hl) != 0) return -1;
+  int ch = 0;
+  size_t i = hl;
+  for (; i < len && payload[i] >= '0' && payload[i] <= '9' && i < hl + 3; ++i) ch = ch * 10 + (payload[i] - '0');
+  if (i == hl || (i < len && payload[i] != ',') || ch <= 0 || ch > 255) return -1;
+  return ch;
+}
+
+bool seakerTatAccepted(int32_t tatMs, int32_t expectedMs, int32_t tolMs) {
+  if (tatMs < 0 || expectedMs <= 0) return true; // pas de TAT: rien à valider
+  int32_t r = tatMs % expectedMs;
+  return (r <= tolMs || r >= expectedMs - tolMs);
+}
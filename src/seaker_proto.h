@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Décodage sans allocation des phrases du lien SEAKER ($DTPING, $STATUS).
+// Module sans dépendance Arduino (compilable et testable sur hôte).
+
+// Enregistrement d'un ping (POD, copiable tel quel entre tâches)
+struct SeakerPing {
+  float tof;          // temps de vol brut (champ 1, format avec TAT), NAN sinon
+  int32_t tatMs;      // turn-around time en ms, -1 si absent (format legacy)
+  float angleDeg;     // angle relatif tête SEAKER (deg), NAN si absent
+  float distanceM;    // distance (m), NAN si absente
+  uint32_t rxMs;      // horodatage de réception de la ligne (millis)
+  int64_t rxUs;       // idem, horloge locale µs (timeLocalUs), 0 si inconnu
+  uint8_t beaconId;   // balise (canal SEAKER actif à la réception), 0 si inconnu
+};
+
+static const size_t SEAKER_STATUS_MAX = 12;
+
+// Contenu d'une phrase $STATUS (champs absents -> NAN)
+struct SeakerStatusRec {
+  char status[SEAKER_STATUS_MAX];
+  float rxFrequency;
+  float snr;
+  float energyTx;
+  float energyRx;
+};
+
+enum SeakerSentenceType {
+  SEAKER_SENT_NONE = 0,     // ligne non NMEA, checksum faux ou phrase ignorée
+  SEAKER_SENT_STATUS,
+  SEAKER_SENT_DTPING,
+};
+
+// Décode une ligne "$...*CS". Remplit 'ping' (DTPING) ou 'status' (STATUS).
+SeakerSentenceType seakerDecodeLine(const char* line, size_t len, uint32_t rxMs,
+                                    SeakerPing& ping, SeakerStatusRec& status);
+
+// Canal sélectionné par une commande sortante "CONFIG,<canal>,...", -1 sinon
+// (la charge utile sans '$' ni checksum, telle que passée à sendSEAKERCommand)
+int seakerCommandChannel(const char* payload, size_t len);
+
+// Validation TAT: accepté si proche (±tolMs) d'un multiple de expectedMs
+bool seakerTatAccepted(int32_t tatMs, int32_t expectedMs, int32_t tolMs);
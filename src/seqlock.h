@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+// Verrou séquentiel (seqlock) pour publier une petite structure POD.
+// Un seul écrivain à la fois (à sérialiser par l'appelant), lecteurs sans
+// verrou ni allocation: la lecture recommence si une écriture l'a chevauchée.
+// Numéro impair = écriture en cours. Module sans dépendance Arduino.
+
+template<typename T>
+struct SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock: type POD requis");
+
+  std::atomic<uint32_t> seq;
+  T data;
+
+  SeqLock() : seq(0), data() {}
+
+  void write(const T& v) {
+    uint32_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&data, &v, sizeof(T));
+    seq.store(s + 2, std::memory_order_release);
+  }
+
+  // Copie cohérente de la dernière valeur publiée; retourne son numéro de publication
+  uint32_t read(T& out) const {
+    uint32_t s1, s2;
+    do {
+      s1 = seq.load(std::memory_order_acquire);
+      if (s1 & 1u) continue;
+      memcpy(&out, &data, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      s2 = seq.load(std::memory_order_relaxed);
+      if (s1 == s2) break;
+    } while (true);
+    return s1 >> 1;
+  }
+
+  // Nombre de publications (détection de changement sans copie)
+  uint32_t version() const { return seq.load(std::memory_order_acquire) >> 1; }
+};
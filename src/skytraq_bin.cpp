@@ -0,0 +1,170 @@
+#include "skytraq_bin.h"
+#include <math.h>
+
+enum {
+  SKY_ST_IDLE,
+  SKY_ST_SYNC2,
+  SKY_ST_LEN_HI,
+  SKY_ST_LEN_LO,
+  SKY_ST_PAYLOAD,
+  SKY_ST_CKS,
+  SKY_ST_END1,
+  SKY_ST_END2,
+  SKY_ST_NMEA,
+};
+
+void skyRxInit(SkyRx& r) {
+  r.state = SKY_ST_IDLE;
+  r.len = 0;
+  r.idx = 0;
+  r.cks = 0;
+  r.lineLen = 0;
+}
+
+SkyRxEvent skyRxFeed(SkyRx& r, uint8_t b) {
+  switch (r.state) {
+    case SKY_ST_IDLE:
+      if (b == 0xA0) r.state = SKY_ST_SYNC2;
+      else if (b == '$') { r.line[0] = '$'; r.lineLen = 1; r.state = SKY_ST_NMEA; }
+      return SKY_RX_NONE;
+    case SKY_ST_SYNC2:
+      if (b == 0xA1) r.state = SKY_ST_LEN_HI;
+      else if (b != 0xA0) r.state = SKY_ST_IDLE;
+      return SKY_RX_NONE;
+    case SKY_ST_LEN_HI:
+      r.len = (uint16_t)b << 8;
+      r.state = SKY_ST_LEN_LO;
+      return SKY_RX_NONE;
+    case SKY_ST_LEN_LO:
+      r.len |= b;
+      if (r.len == 0 || r.len > SKYBIN_MAX_PAYLOAD) { r.state = SKY_ST_IDLE; return SKY_RX_BAD_FRAME; }
+      r.idx = 0;
+      r.cks = 0;
+      r.state = SKY_ST_PAYLOAD;
+      return SKY_RX_NONE;
+    case SKY_ST_PAYLOAD:
+      r.payload[r.idx++] = b;
+      r.cks ^= b;
+      if (r.idx == r.len) r.state = SKY_ST_CKS;
+      return SKY_RX_NONE;
+    case SKY_ST_CKS:
+      if (b != r.cks) { r.state = SKY_ST_IDLE; return SKY_RX_BAD_CKS; }
+      r.state = SKY_ST_END1;
+      return SKY_RX_NONE;
+    case SKY_ST_END1:
+      if (b != 0x0D) { r.state = SKY_ST_IDLE; return SKY_RX_BAD_FRAME; }
+      r.state = SKY_ST_END2;
+      return SKY_RX_NONE;
+    case SKY_ST_END2:
+      r.state = SKY_ST_IDLE;
+      return (b == 0x0A) ? SKY_RX_FRAME : SKY_RX_BAD_FRAME;
+    case SKY_ST_NMEA:
+      if (b == '\n') {
+        r.line[r.lineLen] = '\0';
+        r.state = SKY_ST_IDLE;
+        return SKY_RX_NMEA;
+      }
+      if (b == 0xA0) { r.state = SKY_ST_SYNC2; return SKY_RX_BAD_FRAME; } // ligne interrompue par une trame
+      if (r.lineLen >= SKYBIN_LINE_MAX) { r.state = SKY_ST_IDLE; return SKY_RX_BAD_FRAME; }
+      r.line[r.lineLen++] = (char)b;
+      return SKY_RX_NONE;
+    default:
+      r.state = SKY_ST_IDLE;
+      return SKY_RX_NONE;
+  }
+}
+
+size_t skyBuildFrame(const uint8_t* payload, uint16_t len, uint8_t* out, size_t cap) {
+  size_t total = (size_t)len + 7;
+  if (!payload || !out || len == 0 || cap < total) return 0;
+  uint8_t cks = 0;
+  out[0] = 0xA0;
+  out[1] = 0xA1;
+  out[2] = (uint8_t)(len >> 8);
+  out[3] = (uint8_t)(len & 0xFF);
+  for (uint16_t i = 0; i < len; ++i) { out[4 + i] = payload[i]; cks ^= payload[i]; }
+  out[4 + len] = cks;
+  out[5 + len] = 0x0D;
+  out[6 + len] = 0x0A;
+  return total;
+}
+
+static inline uint16_t rdU16(const uint8_t* p) { return (uint16_t)(((uint16_t)p[0] << 8) | p[1]); }
+static inline uint32_t rdU32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+static inline int32_t rdS32(const uint8_t* p) { return (int32_t)rdU32(p); }
+
+bool skyDecodeNavData(const uint8_t* p, uint16_t len, SkyNavData& d) {
+  // Champs big-endian, offsets relatifs à l'ID (p[0] = 0xA8)
+  if (!p || len < 59 || p[0] != SKYBIN_MSG_NAV_DATA) return false;
+  d.fixMode = p[1];
+  d.svs = p[2];
+  d.week = rdU16(p + 3);
+  d.tow10ms = rdU32(p + 5);
+  d.latE7 = rdS32(p + 9);
+  d.lonE7 = rdS32(p + 13);
+  d.altEllCm = rdS32(p + 17);
+  d.altMslCm = rdS32(p + 21);
+  d.gdop = rdU16(p + 25);
+  d.pdop = rdU16(p + 27);
+  d.hdop = rdU16(p + 29);
+  d.vdop = rdU16(p + 31);
+  d.tdop = rdU16(p + 33);
+  d.ecefXCm = rdS32(p + 35);
+  d.ecefYCm = rdS32(p + 39);
+  d.ecefZCm = rdS32(p + 43);
+  d.ecefVxCms = rdS32(p + 47);
+  d.ecefVyCms = rdS32(p + 51);
+  d.ecefVzCms = rdS32(p + 55);
+  return true;
+}
+
+bool skyDecodeGpsTime(const uint8_t* p, uint16_t len, SkyGpsTime& t) {
+  // 64 8E | TOW ms U32 | TOW ns S32 | semaine U16 | intercalaires défaut S8 | courant S8 | validité U8
+  if (!p || len < 15 || p[0] != SKYBIN_MSG_GNSS || p[1] != SKYBIN_SUB_GPS_TIME) return false;
+  t.towMs = rdU32(p + 2);
+  t.towNs = rdS32(p + 6);
+  t.week = rdU16(p + 10);
+  t.defaultLeapS = (int8_t)p[12];
+  t.currentLeapS = (int8_t)p[13];
+  t.valid = p[14];
+  return true;
+}
+
+bool skyPosRateSupported(uint8_t hz) {
+  switch (hz) {
+    case 1: case 2: case 4: case 5: case 8: case 10: case 20: return true;
+    default: return false;
+  }
+}
+
+void skyNavVelocityNE(const SkyNavData& d, float& vN, float& vE) {
+  const float k = (float)(M_PI / 180.0 * 1e-7);
+  float lat = (float)d.latE7 * k, lon = (float)d.lonE7 * k;
+  float sl = sinf(lat), cl = cosf(lat), so = sinf(lon), co = cosf(lon);
+  float vx = d.ecefVxCms * 0.01f, vy = d.ecefVyCms * 0.01f, vz = d.ecefVzCms * 0.01f;
+  vE = -so * vx + co * vy;
+  vN = -sl * co * vx - sl * so * vy + cl * vz;
+}
+
+void skyGpsToUtc(uint16_t week, uint32_t towMs, uint32_t leapS,
+                 uint16_t& year, uint8_t& month, uint8_t& day, int32_t& utcMs) {
+  // Jours depuis 1970-01-01 (époque GPS = 1980-01-06 = jour 3657)
+  int64_t ms = (int64_t)towMs - (int64_t)leapS * 1000;
+  int64_t days = 3657 + (int64_t)week * 7 + (ms >= 0 ? ms / 86400000 : -((-ms + 86399999) / 86400000));
+  int64_t rem = ms - (days - 3657 - (int64_t)week * 7) * 86400000;
+  utcMs = (int32_t)rem;
+  // Date civile (algorithme "days from civil" inverse, calendrier grégorien)
+  int64_t z = days + 719468;
+  int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  uint32_t doe = (uint32_t)(z - era * 146097);
+  uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  uint32_t mp = (5 * doy + 2) / 153;
+  uint32_t d = doy - (153 * mp + 2) / 5 + 1;
+  uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+  year = (uint16_t)(yoe + era * 400 + (m <= 2 ? 1 : 0));
+  month = (uint8_t)m;
+  day = (uint8_t)d;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Protocole binaire SkyTraq (Venus/Phoenix, PX1172RH):
+//   A0 A1 | longueur (2 octets, big-endian) | ID + corps | XOR du payload | 0D 0A
+// Le récepteur de trames accepte aussi les lignes NMEA ('$'...'\n') du même flux,
+// ce qui garde NMEA en repli (ACK de configuration, récepteur resté en texte).
+// Module sans dépendance Arduino.
+
+static const uint16_t SKYBIN_MAX_PAYLOAD = 256;
+static const uint16_t SKYBIN_LINE_MAX = 256;
+
+// Identifiants de messages utilisés
+static const uint8_t SKYBIN_MSG_CFG_MSG_TYPE = 0x09; // sortie NMEA / binaire
+static const uint8_t SKYBIN_MSG_CFG_POS_RATE = 0x0E; // cadence de position (Hz)
+static const uint8_t SKYBIN_MSG_GNSS = 0x64;         // messages à sous-identifiant
+static const uint8_t SKYBIN_SUB_QUERY_GPS_TIME = 0x20;
+static const uint8_t SKYBIN_SUB_GPS_TIME = 0x8E;     // réponse: TOW, semaine, secondes intercalaires
+static const uint8_t SKYBIN_MSG_ACK = 0x83;
+static const uint8_t SKYBIN_MSG_NACK = 0x84;
+static const uint8_t SKYBIN_MSG_NAV_DATA = 0xA8;     // solution de navigation (59 octets)
+
+// Types de sortie (message 0x09)
+static const uint8_t SKYBIN_OUT_NONE = 0;
+static const uint8_t SKYBIN_OUT_NMEA = 1;
+static const uint8_t SKYBIN_OUT_BINARY = 2;
+
+enum SkyRxEvent {
+  SKY_RX_NONE,       // octet consommé, rien de complet
+  SKY_RX_FRAME,      // trame binaire valide dans payload[0..len)
+  SKY_RX_NMEA,       // ligne texte complète dans line[0..lineLen) (avec '\r' éventuel)
+  SKY_RX_BAD_CKS,    // checksum XOR faux
+  SKY_RX_BAD_FRAME,  // longueur invalide, fin 0D 0A absente ou ligne trop longue
+};
+
+struct SkyRx {
+  uint8_t state;
+  uint16_t len;
+  uint16_t idx;
+  uint8_t cks;
+  uint8_t payload[SKYBIN_MAX_PAYLOAD];
+  uint16_t lineLen;
+  char line[SKYBIN_LINE_MAX + 1];
+};
+
+void skyRxInit(SkyRx& r);
+// Machine à états, un octet à la fois (aucune allocation)
+SkyRxEvent skyRxFeed(SkyRx& r, uint8_t b);
+
+// Encadre un payload (ID + corps). Retourne la taille écrite, 0 si 'cap' insuffisant.
+size_t skyBuildFrame(const uint8_t* payload, uint16_t len, uint8_t* out, size_t cap);
+
+// Message 0xA8: champs bruts, unités du protocole
+struct SkyNavData {
+  uint8_t fixMode;        // 0 aucun, 1 2D, 2 3D, 3 3D+DGNSS
+  uint8_t svs;            // satellites utilisés
+  uint16_t week;          // semaine GPS
+  uint32_t tow10ms;       // temps dans la semaine (0.01 s)
+  int32_t latE7;          // 1e-7 deg
+  int32_t lonE7;
+  int32_t altEllCm;       // hauteur ellipsoïdale (cm)
+  int32_t altMslCm;       // altitude au-dessus du géoïde (cm)
+  uint16_t gdop, pdop, hdop, vdop, tdop; // 0.01
+  int32_t ecefXCm, ecefYCm, ecefZCm;
+  int32_t ecefVxCms, ecefVyCms, ecefVzCms; // cm/s
+};
+
+bool skyDecodeNavData(const uint8_t* p, uint16_t len, SkyNavData& out);
+
+// Réponse 0x64/0x8E (GPS time): 'valid' b0 TOW, b1 semaine, b2 secondes intercalaires
+struct SkyGpsTime {
+  uint32_t towMs;
+  int32_t towNs;
+  uint16_t week;
+  int8_t defaultLeapS;    // valeur du firmware
+  int8_t currentLeapS;    // valeur reçue de l'almanach (si b2)
+  uint8_t valid;
+};
+
+bool skyDecodeGpsTime(const uint8_t* p, uint16_t len, SkyGpsTime& out);
+
+// Cadences acceptées par le message 0x0E
+bool skyPosRateSupported(uint8_t hz);
+
+// Vitesse ECEF -> nord/est locaux (m/s)
+void skyNavVelocityNE(const SkyNavData& d, float& vN, float& vE);
+
+// Semaine GPS + TOW -> date UTC et heure du jour (ms); leapS = écart GPS-UTC (s)
+void skyGpsToUtc(uint16_t week, uint32_t towMs, uint32_t leapS,
+                 uint16_t& year, uint8_t& month, uint8_t& day, int32_t& utcMs);
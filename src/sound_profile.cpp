@@ -0,0 +1,222 @@
+#include "sound_profile.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const float DEG2RAD = (float)(M_PI / 180.0);
+// Éventail de rayons de la grille: +89..-89° par pas de 0,5°, 25 pas par maille de distance (~2 m)
+static const float SVP_FAN_MAX_DEG = 89.0f;
+static const float SVP_FAN_STEP_DEG = 0.5f;
+static const int SVP_SUBSTEPS = 25;
+static const float SVP_ANGLE_DU = 2.0f / (SVP_ANGLE_NODES - 1);
+
+static inline float angleNodeRad(int j) {
+  float u = -1.0f + j * SVP_ANGLE_DU;
+  return 90.0f * u * fabsf(u) * DEG2RAD;
+}
+
+bool soundProfileParse(const char* text, size_t len, SoundProfile& p) {
+  p.n = 0;
+  size_t i = 0;
+  while (i < len) {
+    size_t e = i;
+    while (e < len && text[e] != '\n' && text[e] != '\r') ++e;
+    char line[64];
+    size_t n = e - i;
+    if (n >= sizeof(line)) n = sizeof(line) - 1;
+    memcpy(line, text + i, n);
+    line[n] = 0;
+    i = e + 1;
+    const char* s = line;
+    while (*s == ' ' || *s == '\t') ++s;
+    if (!*s || *s == '#') continue;
+    char* end;
+    float z = strtof(s, &end);
+    if (end == s) continue;   // en-tête
+    s = end;
+    while (*s == ',' || *s == ';' || *s == ' ' || *s == '\t') ++s;
+    float c = strtof(s, &end);
+    if (end == s) return false;
+    if (!isfinite(z) || !isfinite(c) || z < 0.0f || c < 1350.0f || c > 1700.0f) return false;
+    if (p.n && z <= p.depth[p.n - 1]) return false;
+    if (p.n >= SVP_MAX_POINTS) return false;
+    p.depth[p.n] = z;
+    p.speed[p.n] = c;
+    p.n++;
+  }
+  return p.n >= 2;
+}
+
+// Célérité et gradient à la profondeur z; 'seg' garde le segment courant
+// (le rayon se déplace peu d'un pas à l'autre)
+static inline void profileAt(const SoundProfile& p, float z, int& seg, float& c, float& g) {
+  if (z <= p.depth[0]) { c = p.speed[0]; g = 0.0f; seg = 0; return; }
+  if (z >= p.depth[p.n - 1]) { c = p.speed[p.n - 1]; g = 0.0f; seg = p.n - 2; return; }
+  while (seg < p.n - 2 && z > p.depth[seg + 1]) ++seg;
+  while (seg > 0 && z < p.depth[seg]) --seg;
+  g = (p.speed[seg + 1] - p.speed[seg]) / (p.depth[seg + 1] - p.depth[seg]);
+  c = p.speed[seg] + g * (z - p.depth[seg]);
+}
+
+float soundProfileSpeedAt(const SoundProfile& p, float depthM) {
+  int seg = 0; float c, g;
+  profileAt(p, depthM, seg, c, g);
+  return c;
+}
+
+float soundProfileHarmonicMean(const SoundProfile& p, float z1, float z2) {
+  float a = fminf(z1, z2), b = fmaxf(z1, z2);
+  if (b - a < 1e-3f) return soundProfileSpeedAt(p, a);
+  // Intégrale de dz/c, exacte sur chaque segment linéaire: ln(c1/c0)/g
+  double t = 0.0;
+  float z = a;
+  while (z < b) {
+    float zEnd = b;
+    int i = 0;
+    while (i < p.n && p.depth[i] <= z) ++i;
+    if (i < p.n && p.depth[i] < zEnd) zEnd = p.depth[i];
+    float c0 = soundProfileSpeedAt(p, z), c1 = soundProfileSpeedAt(p, zEnd);
+    float dz = zEnd - z;
+    if (fabsf(c1 - c0) < 1e-4f) t += dz / c0;
+    else t += (double)dz * log((double)c1 / c0) / (c1 - c0);
+    z = zEnd;
+  }
+  return (float)((b - a) / t);
+}
+
+// Rayon: position (x horizontale, z profondeur) et direction unitaire (ux, uz), z vers le bas.
+// Snell sous forme différentielle: du/dt = g (ux uz, -ux²), intégration au point milieu
+struct SvpRay { float x, z, ux, uz; int seg; };
+
+static inline void rayStep(const SoundProfile& p, SvpRay& r, float dt) {
+  float c, g;
+  profileAt(p, r.z, r.seg, c, g);
+  float h = 0.5f * dt;
+  float zm = r.z + c * r.uz * h;
+  float uxm = r.ux + g * r.ux * r.uz * h;
+  float uzm = r.uz - g * r.ux * r.ux * h;
+  profileAt(p, zm, r.seg, c, g);
+  r.x += c * uxm * dt;
+  r.z += c * uzm * dt;
+  float ux = r.ux + g * uxm * uzm * dt;
+  float uz = r.uz - g * uxm * uxm * dt;
+  float k = 1.0f / sqrtf(ux * ux + uz * uz);
+  r.ux = ux * k; r.uz = uz * k;
+  if (r.z < 0.0f) { r.z = -r.z; r.uz = -r.uz; }   // réflexion en surface
+}
+
+static inline void rayLaunch(SvpRay& r, float headDepth, float phiDeg) {
+  r.x = 0.0f; r.z = headDepth; r.seg = 0;
+  r.ux = cosf(phiDeg * DEG2RAD); r.uz = sinf(phiDeg * DEG2RAD);
+}
+
+void svpGridBuild(const SoundProfile& p, float headDepth, SvpGrid& g, void (*yieldFn)()) {
+  g.headDepth = headDepth;
+  float cHead = soundProfileSpeedAt(p, headDepth);
+  float sinT[SVP_ANGLE_NODES], cosT[SVP_ANGLE_NODES];
+  for (int j = 0; j < SVP_ANGLE_NODES; ++j) {
+    float th = angleNodeRad(j);
+    sinT[j] = sinf(th);
+    cosT[j] = fmaxf(1e-6f, cosf(th));   // nœuds verticaux repris du voisin en fin de construction
+    g.ratio[0][j] = cHead / SVP_NOMINAL_SPEED;
+    for (int r = 1; r < SVP_RANGE_NODES; ++r) g.ratio[r][j] = NAN;
+  }
+  // Éventail de rayons du plus plongeant au plus montant: le premier encadrement
+  // de la profondeur cible à l'instant de la maille est le trajet direct
+  float prevX[SVP_RANGE_NODES], prevZ[SVP_RANGE_NODES], curX[SVP_RANGE_NODES], curZ[SVP_RANGE_NODES];
+  float dt = SVP_RANGE_STEP_M / SVP_NOMINAL_SPEED / SVP_SUBSTEPS;
+  int rays = (int)(2.0f * SVP_FAN_MAX_DEG / SVP_FAN_STEP_DEG) + 1;
+  for (int k = 0; k < rays; ++k) {
+    SvpRay ray;
+    rayLaunch(ray, headDepth, SVP_FAN_MAX_DEG - k * SVP_FAN_STEP_DEG);
+    for (int r = 1; r < SVP_RANGE_NODES; ++r) {
+      for (int s = 0; s < SVP_SUBSTEPS; ++s) rayStep(p, ray, dt);
+      curX[r] = ray.x; curZ[r] = ray.z;
+    }
+    if (k) {
+      for (int r = 1; r < SVP_RANGE_NODES; ++r) {
+        float R = r * SVP_RANGE_STEP_M;
+        float z0 = prevZ[r], z1 = curZ[r];
+        float lo = fminf(z0, z1), hi = fmaxf(z0, z1);
+        for (int j = 0; j < SVP_ANGLE_NODES; ++j) {
+          if (!isnan(g.ratio[r][j])) continue;
+          float zt = headDepth + R * sinT[j];
+          if (zt < lo || zt > hi) continue;
+          float w = (hi > lo) ? (zt - z0) / (z1 - z0) : 0.0f;
+          g.ratio[r][j] = (prevX[r] + w * (curX[r] - prevX[r])) / (R * cosT[j]);
+        }
+      }
+    }
+    memcpy(prevX, curX, sizeof(curX));
+    memcpy(prevZ, curZ, sizeof(curZ));
+    if (yieldFn && (k & 15) == 15) yieldFn();
+  }
+  // Mailles sans trajet. Zone d'ombre: rapport de la maille précédente sur le même
+  // angle (pas de saut vers la ligne droite au bord de l'ombre, où l'interpolation
+  // mélangeait les deux). Au-dessus de la surface (hors d'atteinte): ligne droite à
+  // la célérité moyenne harmonique
+  for (int r = 1; r < SVP_RANGE_NODES; ++r) {
+    float R = r * SVP_RANGE_STEP_M;
+    for (int j = 0; j < SVP_ANGLE_NODES; ++j) {
+      if (!isnan(g.ratio[r][j])) continue;
+      float zt = headDepth + R * sinT[j];
+      if (zt >= 0.0f) { g.ratio[r][j] = g.ratio[r - 1][j]; continue; }
+      g.ratio[r][j] = soundProfileHarmonicMean(p, headDepth, 0.0f) / SVP_NOMINAL_SPEED;
+    }
+    // Verticale: cos nul, rapport repris du nœud voisin
+    g.ratio[r][0] = g.ratio[r][1];
+    g.ratio[r][SVP_ANGLE_NODES - 1] = g.ratio[r][SVP_ANGLE_NODES - 2];
+  }
+}
+
+float svpGridHorizontal(const SvpGrid& g, float slantNomM, float dzM) {
+  if (!(slantNomM > 0.0f)) return slantNomM;
+  float s = dzM / slantNomM;
+  if (s > 1.0f) s = 1.0f; else if (s < -1.0f) s = -1.0f;
+  float th = asinf(s) * (float)(2.0 / M_PI);   // -1..1
+  float u = (th < 0.0f) ? -sqrtf(-th) : sqrtf(th);
+  float fa = (u + 1.0f) / SVP_ANGLE_DU;
+  int ia = (int)fa;
+  if (ia > SVP_ANGLE_NODES - 2) ia = SVP_ANGLE_NODES - 2;
+  float wa = fa - ia;
+  float fr = slantNomM / SVP_RANGE_STEP_M;
+  int ir = (int)fr;
+  if (ir > SVP_RANGE_NODES - 2) ir = SVP_RANGE_NODES - 2;
+  float wr = fr - ir;
+  if (wr > 1.0f) wr = 1.0f;   // au-delà de la grille: rapport de la dernière maille
+  const float* r0 = g.ratio[ir];
+  const float* r1 = g.ratio[ir + 1];
+  float a = r0[ia] + wa * (r0[ia + 1] - r0[ia]);
+  float b = r1[ia] + wa * (r1[ia + 1] - r1[ia]);
+  return slantNomM * sqrtf(1.0f - s * s) * (a + wr * (b - a));
+}
+
+float svpRayTraceHorizontal(const SoundProfile& p, float headDepth, float slantNomM, float dzM) {
+  float T = slantNomM / SVP_NOMINAL_SPEED;
+  const int steps = 4000;
+  float dt = T / steps;
+  float zt = headDepth + dzM;
+  auto shoot = [&](float phiDeg, float& x) {
+    SvpRay ray;
+    rayLaunch(ray, headDepth, phiDeg);
+    for (int i = 0; i < steps; ++i) rayStep(p, ray, dt);
+    x = ray.x;
+    return ray.z - zt;
+  };
+  float x0, x1;
+  float a = 89.9f, fa = shoot(a, x0);
+  for (float b = a - 1.0f; b >= -89.9f; b -= 1.0f) {
+    float fb = shoot(b, x1);
+    if ((fa <= 0.0f) != (fb <= 0.0f)) {
+      // Bissection sur l'angle de départ
+      for (int it = 0; it < 30; ++it) {
+        float m = 0.5f * (a + b), xm;
+        float fm = shoot(m, xm);
+        if ((fa <= 0.0f) != (fm <= 0.0f)) { b = m; x1 = xm; } else { a = m; fa = fm; x0 = xm; }
+      }
+      return 0.5f * (x0 + x1);
+    }
+    a = b; fa = fb; x0 = x1;
+  }
+  return NAN;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Profil de célérité (SVP) et correction de réfraction de la distance SEAKER.
+// Le SEAKER convertit le temps de vol à célérité fixe (CONFIG champ 3, 1500 m/s)
+// en ligne droite. Le profil (profondeur, célérité), linéaire par morceaux,
+// sert à tracer des rayons (Snell, courbure dc/dz) depuis la profondeur de la
+// tête: une grille (distance nominale, angle de dépression) -> rapport
+// distance horizontale / (distance nominale x cos angle) est construite une fois
+// par profil (~0,4 M pas d'intégration, hors tâche fusion); chaque ping ne coûte
+// ensuite qu'un asin, deux racines et une interpolation bilinéaire. Le cos, exact
+// à la consultation, reste hors de l'interpolation: le rapport varie peu avec
+// l'angle, y compris aux angles raides.
+// Angle de dépression géométrique: asin((profondeur balise - profondeur tête) /
+// distance nominale); la tête ne mesurant pas l'élévation, la profondeur de la
+// balise est un réglage (balise à la profondeur de la tête si inconnue).
+// Réflexion en surface, pas de fond (célérité prolongée sous le dernier point).
+// Module sans dépendance Arduino.
+
+static const float SVP_NOMINAL_SPEED = 1500.0f;   // célérité du SEAKER (m/s)
+static const uint8_t SVP_MAX_POINTS = 64;
+static const uint8_t SVP_RANGE_NODES = 41;        // 0..2000 m
+static const float SVP_RANGE_STEP_M = 50.0f;
+// Angle de dépression -90..90° (+ vers le bas), mailles resserrées près de
+// l'horizontale (réfraction la plus variable): theta = 90° u |u|, u uniforme.
+// 61 nœuds: maille de 0,1° à l'horizontale, 6° à la verticale
+static const uint8_t SVP_ANGLE_NODES = 61;
+
+struct SoundProfile {
+  uint8_t n;
+  float depth[SVP_MAX_POINTS];   // m, strictement croissante
+  float speed[SVP_MAX_POINTS];   // m/s
+};
+
+// Grille précalculée (POD, ~10 KB)
+struct SvpGrid {
+  float headDepth;               // profondeur de la tête pour laquelle la grille est construite
+  float ratio[SVP_RANGE_NODES][SVP_ANGLE_NODES];  // distance horizontale / (distance nominale x cos angle)
+};
+
+// Texte CSV "profondeur,célérité" par ligne (',' ';' tabulation ou espaces),
+// lignes vides, '#' et en-tête non numérique ignorés. Faux si moins de 2 points,
+// plus de SVP_MAX_POINTS, profondeurs non croissantes ou célérité hors 1350..1700 m/s.
+bool soundProfileParse(const char* text, size_t len, SoundProfile& p);
+
+float soundProfileSpeedAt(const SoundProfile& p, float depthM);
+
+// Célérité moyenne harmonique entre deux profondeurs (temps de trajet vertical exact)
+float soundProfileHarmonicMean(const SoundProfile& p, float z1, float z2);
+
+// Construction de la grille (coûteux: à faire hors tâche temps réel).
+// 'yieldFn' (optionnel) est appelée entre deux rayons.
+void svpGridBuild(const SoundProfile& p, float headDepth, SvpGrid& g, void (*yieldFn)() = nullptr);
+
+// Distance horizontale (m) pour une distance oblique nominale et un écart de
+// profondeur balise - tête (m, + vers le bas)
+float svpGridHorizontal(const SvpGrid& g, float slantNomM, float dzM);
+
+// Référence par tir de rayons (bissection sur l'angle de départ, pas fin), pour le banc hôte
+float svpRayTraceHorizontal(const SoundProfile& p, float headDepth, float slantNomM, float dzM);
@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <type_traits>
+
+// File bornée sans verrou, un producteur / un consommateur (tâches sur
+// des cœurs différents). Les éléments sont copiés entiers: le consommateur
+// ne voit jamais d'enregistrement partiellement écrit. File pleine:
+// l'élément entrant est refusé et compté (le producteur ne touche pas tail).
+// Module sans dépendance Arduino.
+
+template<typename T, uint32_t N>
+struct SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue: capacité puissance de 2");
+  static_assert(std::is_trivially_copyable<T>::value, "SpscQueue: type POD requis");
+
+  T buf[N];
+  std::atomic<uint32_t> head;      // écrit par le producteur: éléments poussés
+  std::atomic<uint32_t> tail;      // écrit par le consommateur: éléments retirés
+  std::atomic<uint32_t> overflow;  // éléments refusés (file pleine)
+
+  SpscQueue() : head(0), tail(0), overflow(0) {}
+
+  // Producteur uniquement
+  bool push(const T& v) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= N) {
+      overflow.store(overflow.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    buf[h & (N - 1)] = v;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consommateur uniquement
+  bool pop(T& out) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return false;
+    out = buf[t & (N - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consommateur uniquement: lit le plus ancien élément sans le retirer
+  bool peek(T& out) const {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return false;
+    out = buf[t & (N - 1)];
+    return true;
+  }
+
+  // Compteurs (lecture depuis n'importe quelle tâche)
+  uint32_t enqueued() const { return head.load(std::memory_order_acquire); }
+  uint32_t consumed() const { return tail.load(std::memory_order_acquire); }
+  uint32_t dropped() const { return overflow.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,129 @@
+#include "svp_table.h"
+#include <LittleFS.h>
+#include <atomic>
+#include "runtime_config.h"
+
+static SoundProfile profile = {};   // écrit par loop (web), copié par la tâche svp
+static portMUX_TYPE profileMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Double tampon: activeGrid = grille publiée (-1: aucune), readingGrid = grille
+// en cours de consultation par la fusion (-1: aucune). La tâche ne réécrit
+// jamais la grille publiée, ni une ancienne grille encore lue après bascule.
+static SvpGrid grids[2];
+static std::atomic<int8_t> activeGrid(-1);
+static std::atomic<int8_t> readingGrid(-1);
+
+static TaskHandle_t svpTaskHandle = nullptr;
+static volatile bool building = false;
+static volatile uint32_t buildMs = 0;
+static volatile uint32_t builds = 0;
+
+static void svpYield() { vTaskDelay(1); }
+
+static void svpTask(void* arg) {
+  (void)arg;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    SoundProfile p;
+    portENTER_CRITICAL(&profileMux);
+    p = profile;
+    portEXIT_CRITICAL(&profileMux);
+    if (p.n < 2) { activeGrid.store(-1); continue; }
+    building = true;
+    int8_t dst = (activeGrid.load() == 0) ? 1 : 0;
+    while (readingGrid.load() == dst) vTaskDelay(1);
+    uint32_t t0 = millis();
+    svpGridBuild(p, gSvpHeadDepth, grids[dst], svpYield);
+    activeGrid.store(dst);
+    buildMs = millis() - t0;
+    builds++;
+    building = false;
+    Serial.printf("[SVP] grille %u points, tête %.1f m: %lu ms\n", (unsigned)p.n, (double)grids[dst].headDepth,
+                  (unsigned long)buildMs);
+  }
+}
+
+void svpRequestRebuild() {
+  if (svpTaskHandle) xTaskNotifyGive(svpTaskHandle);
+}
+
+void svpBegin() {
+  if (svpTaskHandle) return;
+  // LittleFS est aussi monté par webSetup, seulement une fois le WiFi connecté
+  if (LittleFS.begin(true) && LittleFS.exists(SVP_FILE)) {
+    File f = LittleFS.open(SVP_FILE, "r");
+    if (f) {
+      static char buf[SVP_MAX_POINTS * 32];
+      size_t n = f.readBytes(buf, sizeof(buf));
+      f.close();
+      SoundProfile p;
+      if (soundProfileParse(buf, n, p)) profile = p;
+      else Serial.println("[SVP] /svp.csv invalide, ignoré");
+    }
+  }
+  // Core 0 (réseau), priorité basse: la construction ne retarde ni loop ni la fusion
+  xTaskCreatePinnedToCore(svpTask, "svp", 4096, nullptr, 1, &svpTaskHandle, 0);
+  if (profile.n >= 2) svpRequestRebuild();
+}
+
+bool svpSetProfile(const char* text, size_t len) {
+  SoundProfile p;
+  if (!soundProfileParse(text, len, p)) return false;
+  File f = LittleFS.open(SVP_FILE, "w");
+  if (f) {
+    f.print("depth,speed\n");
+    for (uint8_t i = 0; i < p.n; ++i) f.printf("%.2f,%.2f\n", (double)p.depth[i], (double)p.speed[i]);
+    f.close();
+  }
+  portENTER_CRITICAL(&profileMux);
+  profile = p;
+  portEXIT_CRITICAL(&profileMux);
+  svpRequestRebuild();
+  return true;
+}
+
+void svpClearProfile() {
+  portENTER_CRITICAL(&profileMux);
+  profile.n = 0;
+  portEXIT_CRITICAL(&profileMux);
+  activeGrid.store(-1);
+  if (LittleFS.exists(SVP_FILE)) LittleFS.remove(SVP_FILE);
+  svpRequestRebuild();   // retire aussi la grille d'une construction en cours
+}
+
+float svpHorizontalRange(float slantNomM) {
+  if (!gSvpEnabled) return slantNomM;
+  int8_t g;
+  do {
+    g = activeGrid.load();
+    if (g < 0) return slantNomM;
+    readingGrid.store(g);
+  } while (activeGrid.load() != g);
+  float bd = gSvpBeaconDepth;
+  float dz = isfinite(bd) ? bd - grids[g].headDepth : 0.0f;
+  float h = svpGridHorizontal(grids[g], slantNomM, dz);
+  readingGrid.store(-1);
+  return h;
+}
+
+SvpStatus svpGetStatus() {
+  SvpStatus s = {};
+  SoundProfile p;
+  svpGetProfile(p);
+  int8_t g = activeGrid.load();
+  s.ready = g >= 0;
+  s.building = building;
+  s.points = p.n;
+  s.headDepth = s.ready ? grids[g].headDepth : (float)gSvpHeadDepth;
+  float bd = gSvpBeaconDepth;
+  s.cMean = (p.n >= 2) ? soundProfileHarmonicMean(p, s.headDepth, isfinite(bd) ? bd : s.headDepth) : NAN;
+  s.buildMs = buildMs;
+  s.builds = builds;
+  return s;
+}
+
+void svpGetProfile(SoundProfile& p) {
+  portENTER_CRITICAL(&profileMux);
+  p = profile;
+  portEXIT_CRITICAL(&profileMux);
+}
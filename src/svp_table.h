@@ -0,0 +1,39 @@
+#pragma once
+#include <Arduino.h>
+#include "sound_profile.h"
+
+// Profil de célérité persistant (LittleFS /svp.csv) et grille de correction
+// de réfraction (sound_profile) utilisée par la tâche fusion.
+// Deux grilles: la tâche "svp" (core 0, priorité basse) reconstruit celle qui
+// n'est pas publiée puis bascule l'index; la fusion n'attend jamais la
+// construction et garde l'ancienne grille pendant ce temps.
+// Réglages: gSvpEnabled, gSvpHeadDepth, gSvpBeaconDepth (runtime_config).
+
+static const char SVP_FILE[] = "/svp.csv";
+
+struct SvpStatus {
+  bool ready;          // une grille est publiée
+  bool building;       // reconstruction en cours
+  uint8_t points;      // points du profil chargé
+  float headDepth;     // profondeur de la tête de la grille publiée
+  float cMean;         // célérité moyenne harmonique tête -> balise
+  uint32_t buildMs;    // durée de la dernière construction
+  uint32_t builds;
+};
+
+// Monte LittleFS si besoin, charge /svp.csv et lance la tâche (après loadSvpPrefs)
+void svpBegin();
+
+// Valide et enregistre un profil CSV, puis demande la reconstruction; faux si invalide
+bool svpSetProfile(const char* text, size_t len);
+// Supprime le profil (plus de correction)
+void svpClearProfile();
+// Reconstruction (profondeur de la tête modifiée)
+void svpRequestRebuild();
+
+// Tâche fusion: distance horizontale pour une distance oblique à célérité nominale
+// (inchangée sans grille ou si gSvpEnabled est faux)
+float svpHorizontalRange(float slantNomM);
+
+SvpStatus svpGetStatus();
+void svpGetProfile(SoundProfile& p);
@@ -1,47 +1,261 @@
 #include "target_filter.h"
-#include <math.h>
+
+static const float VEL_INIT_VAR = 100.0f; // (10 m/s)² tant que la vitesse n'est pas observée
+static const float VEL_STATIC_VAR = 1e-4f; // (1 cm/s)² résiduel du modèle immobile
+// En deçà, le gisement est mal défini: mesure polaire convertie en point (covariance tournée)
+static const float POLAR_MIN_RANGE = 1.0f;
+// Transformée sans parfum, n = 4: alpha = 1, beta = 2, kappa = 0 => lambda = 0,
+// gamma = sqrt(n + lambda), Wm0 = 0, Wc0 = 2, Wi = 1/(2n)
+static const float UKF_GAMMA = 2.0f;
+static const float UKF_WI = 0.125f;
+static const float UKF_WC0 = 2.0f;
 
 static inline float fsq(float v){ return v*v; }
 
-void targetFilterInit(TargetFilterState& s, float x, float y, float posStd){
-  s.x = x; s.y = y; s.vx = 0.0f; s.vy = 0.0f;
+static KMat<2, 4> measModel() {
+  KMat<2, 4> H = KMat<2, 4>::zero();
+  H.m[0][0] = 1.0f;
+  H.m[1][1] = 1.0f;
+  return H;
+}
+
+static void measurement(float measX, float measY, float posStd, KMat<2, 1>& z, KMat<2, 2>& R) {
+  z.m[0][0] = measX; z.m[1][0] = measY;
   float r2 = fsq(posStd);
-  s.Pxx = r2; s.Pyy = r2; s.Pvvx = 100.0f; s.Pvvy = 100.0f;
-  s.Pxy = 0; s.Pxvx = 0; s.Pxvy = 0; s.Pyvx = 0; s.Pyvy = 0; s.Pvxvy = 0;
+  R = KMat<2, 2>::zero();
+  R.m[0][0] = r2; R.m[1][1] = r2;
+}
+
+static float wrapPi(float a) {
+  while (a >= (float)M_PI) a -= 2.0f * (float)M_PI;
+  while (a < -(float)M_PI) a += 2.0f * (float)M_PI;
+  return a;
+}
+
+static void initCov(TargetFilterState& s, float x, float y, const KMat<2, 2>& R) {
+  s.kf.x = KMat<4, 1>::zero();
+  s.kf.x.m[0][0] = x; s.kf.x.m[1][0] = y;
+  s.kf.P = KMat<4, 4>::zero();
+  s.kf.P.m[0][0] = R.m[0][0]; s.kf.P.m[0][1] = R.m[0][1];
+  s.kf.P.m[1][0] = R.m[1][0]; s.kf.P.m[1][1] = R.m[1][1];
+  s.kf.P.m[2][2] = VEL_INIT_VAR; s.kf.P.m[3][3] = VEL_INIT_VAR;
   s.initialized = true;
 }
 
+void targetFilterInit(TargetFilterState& s, float x, float y, float posStd){
+  KMat<2, 1> z; KMat<2, 2> R;
+  measurement(x, y, posStd, z, R);
+  initCov(s, x, y, R);
+}
+
+// Covariance polaire; l'erreur de position du bateau (isotrope) s'ajoute en
+// distance telle quelle et en gisement divisée par la distance
+static KMat<2, 2> polarCov(const TargetPolarMeas& m) {
+  float r = (m.range > POLAR_MIN_RANGE) ? m.range : POLAR_MIN_RANGE;
+  float o2 = fsq(m.originStd);
+  KMat<2, 2> R = KMat<2, 2>::zero();
+  R.m[0][0] = fsq(m.rangeStd) + o2;
+  R.m[1][1] = fsq(m.bearingStd) + o2 / (r * r);
+  return R;
+}
+
+// Mesure polaire convertie en point, covariance R_xy = J R J' (non isotrope)
+static void polarToCart(const TargetPolarMeas& m, KMat<2, 1>& z, KMat<2, 2>& Rc) {
+  float sb = sinf(m.bearingRad), cb = cosf(m.bearingRad);
+  z.m[0][0] = m.originX + m.range * sb;
+  z.m[1][0] = m.originY + m.range * cb;
+  KMat<2, 2> J;
+  J.m[0][0] = sb; J.m[0][1] = m.range * cb;
+  J.m[1][0] = cb; J.m[1][1] = -m.range * sb;
+  Rc = mulTransB(J * polarCov(m), J);
+  symmetrize(Rc);
+}
+
+// Linéarisation au point prédit: résidu y = z - h(x) (gisement replié), jacobienne H.
+// Faux si la cible prédite est trop proche du bateau
+static bool polarLinearize(const TargetFilterState& s, const TargetPolarMeas& m, KMat<2, 1>& y, KMat<2, 4>& H) {
+  float dx = targetFilterX(s) - m.originX, dy = targetFilterY(s) - m.originY;
+  float r2 = dx * dx + dy * dy;
+  if (r2 < fsq(POLAR_MIN_RANGE) || m.range < POLAR_MIN_RANGE) return false;
+  float r = sqrtf(r2);
+  y.m[0][0] = m.range - r;
+  y.m[1][0] = wrapPi(m.bearingRad - atan2f(dx, dy));
+  H = KMat<2, 4>::zero();
+  H.m[0][0] = dx / r;  H.m[0][1] = dy / r;
+  H.m[1][0] = dy / r2; H.m[1][1] = -dx / r2;
+  return true;
+}
+
+// Transformée sans parfum de h au point prédit: innovation y, covariance S et
+// intercovariance Pxz. h ne dépend que de la position et L (Cholesky de P) est
+// triangulaire inférieure: les points portés par les colonnes 2 et 3 ne déplacent
+// que la vitesse et valent h(x). Ils sont regroupés avec le point central (poids
+// 4 Wi), ce qui ne laisse que 5 évaluations de h au lieu de 9, sans approximation.
+static bool polarUnscented(const TargetFilterState& s, const TargetPolarMeas& m,
+                           KMat<2, 1>& y, KMat<2, 2>& S, KMat<4, 2>& Pxz) {
+  if (m.range < POLAR_MIN_RANGE) return false;
+  KMat<4, 4> L;
+  if (!cholesky(s.kf.P, L)) return false;
+  float cx = targetFilterX(s) - m.originX, cy = targetFilterY(s) - m.originY;
+  if (cx * cx + cy * cy < fsq(POLAR_MIN_RANGE)) return false;
+  float b0 = atan2f(cx, cy);
+  // Points: 0 = centre, 1..4 = ±gamma L[:,0], ±gamma L[:,1]; gisements déroulés autour de b0
+  float zr[5], zb[5];
+  float dxs[5][4];
+  zr[0] = sqrtf(cx * cx + cy * cy); zb[0] = b0;
+  for (int k = 0; k < 4; ++k) dxs[0][k] = 0.0f;
+  for (int j = 0; j < 2; ++j) {
+    for (int sg = 0; sg < 2; ++sg) {
+      int i = 1 + 2 * j + sg;
+      float g = sg ? -UKF_GAMMA : UKF_GAMMA;
+      for (int k = 0; k < 4; ++k) dxs[i][k] = g * L.m[k][j];
+      float px = cx + dxs[i][0], py = cy + dxs[i][1];
+      zr[i] = sqrtf(px * px + py * py);
+      zb[i] = b0 + wrapPi(atan2f(px, py) - b0);
+    }
+  }
+  // Moyenne: Wm0 = 0 mais le centre porte les 4 points de vitesse
+  const float wm0 = 4.0f * UKF_WI, wc0 = UKF_WC0 + 4.0f * UKF_WI;
+  float mr = wm0 * zr[0], mb = wm0 * zb[0];
+  for (int i = 1; i < 5; ++i) { mr += UKF_WI * zr[i]; mb += UKF_WI * zb[i]; }
+  S = polarCov(m);
+  Pxz = KMat<4, 2>::zero();
+  for (int i = 0; i < 5; ++i) {
+    float w = i ? UKF_WI : wc0;
+    float er = zr[i] - mr, eb = zb[i] - mb;
+    S.m[0][0] += w * er * er; S.m[0][1] += w * er * eb; S.m[1][1] += w * eb * eb;
+    for (int k = 0; k < 4; ++k) { Pxz.m[k][0] += UKF_WI * dxs[i][k] * er; Pxz.m[k][1] += UKF_WI * dxs[i][k] * eb; }
+  }
+  S.m[1][0] = S.m[0][1];
+  y.m[0][0] = m.range - mr;
+  y.m[1][0] = wrapPi(m.bearingRad - mb);
+  return true;
+}
+
+void targetFilterReset(TargetFilterState& s){
+  s.initialized = false;
+}
+
+KMat<4, 4> targetFilterTransition(float dt){
+  KMat<4, 4> F = KMat<4, 4>::identity();
+  F.m[0][2] = dt; F.m[1][3] = dt;
+  return F;
+}
+
 void targetFilterPredict(TargetFilterState& s, float dt, float aStd){
-  if (!s.initialized) return;
-  // Modèle déplacement constant
-  s.x += s.vx * dt;
-  s.y += s.vy * dt;
-  float q = sq(aStd);
-  // Mise à jour covariance (approx simple, diagonale dominante)
-  s.Pxx += s.Pvvx * fsq(dt) + q * fsq(dt*dt*0.5f);
-  s.Pyy += s.Pvvy * fsq(dt) + q * fsq(dt*dt*0.5f);
-  s.Pvvx += q * dt;
-  s.Pvvy += q * dt;
+  if (!s.initialized || !(dt > 0.0f)) return;
+  // Modèle vitesse constante, accélération blanche discrète (par axe):
+  // Q = q [dt^4/4 dt^3/2; dt^3/2 dt^2]
+  KMat<4, 4> F = targetFilterTransition(dt);
+  float q = fsq(aStd);
+  float dt2 = dt * dt;
+  float qpp = q * dt2 * dt2 * 0.25f, qpv = q * dt2 * dt * 0.5f, qvv = q * dt2;
+  KMat<4, 4> Q = KMat<4, 4>::zero();
+  Q.m[0][0] = qpp; Q.m[1][1] = qpp;
+  Q.m[0][2] = qpv; Q.m[2][0] = qpv; Q.m[1][3] = qpv; Q.m[3][1] = qpv;
+  Q.m[2][2] = qvv; Q.m[3][3] = qvv;
+  s.kf.predict(F, Q);
+}
+
+void targetFilterPredictStatic(TargetFilterState& s, float dt, float driftStd){
+  if (!s.initialized || !(dt > 0.0f)) return;
+  KMat<4, 4> F = KMat<4, 4>::identity();
+  F.m[2][2] = 0.0f; F.m[3][3] = 0.0f;
+  float qp = fsq(driftStd) * dt;
+  KMat<4, 4> Q = KMat<4, 4>::zero();
+  Q.m[0][0] = qp; Q.m[1][1] = qp;
+  Q.m[2][2] = VEL_STATIC_VAR; Q.m[3][3] = VEL_STATIC_VAR;
+  s.kf.predict(F, Q);
+}
+
+float targetFilterInnovation(const TargetFilterState& s, float measX, float measY, float posStd, float* detS){
+  if (!s.initialized) return 0.0f;
+  KMat<2, 1> z; KMat<2, 2> R;
+  measurement(measX, measY, posStd, z, R);
+  float d2 = s.kf.mahalanobis2(measModel(), z, R, detS);
+  return d2 >= 0.0f ? sqrtf(d2) : INFINITY;
 }
 
 float targetFilterUpdate(TargetFilterState& s, float measX, float measY, float posStd){
   if (!s.initialized) { targetFilterInit(s, measX, measY, posStd); return 0.0f; }
-  float r2 = fsq(posStd);
-  // Innovation
-  float yx = measX - s.x;
-  float yy = measY - s.y;
-  float Sx = s.Pxx + r2;
-  float Sy = s.Pyy + r2;
-  float Kx = s.Pxx / Sx;
-  float Ky = s.Pyy / Sy;
-  s.x += Kx * yx;
-  s.y += Ky * yy;
-  s.Pxx *= (1.0f - Kx);
-  s.Pyy *= (1.0f - Ky);
-  // Distance normalisée (approx en 2D, sans corrélation croisée)
-  float nx = yx / sqrtf(Sx);
-  float ny = yy / sqrtf(Sy);
-  return sqrtf(nx*nx + ny*ny);
+  KMat<2, 1> z; KMat<2, 2> R;
+  measurement(measX, measY, posStd, z, R);
+  float d2 = s.kf.update(measModel(), z, R);
+  return d2 >= 0.0f ? sqrtf(d2) : INFINITY;
 }
 
+float targetFilterPolarInnovation(const TargetFilterState& s, uint8_t mode, const TargetPolarMeas& m, float* detS){
+  if (!s.initialized) return 0.0f;
+  KMat<2, 1> y; KMat<2, 2> S, Si;
+  if (mode == TARGET_MEAS_UKF) {
+    KMat<4, 2> Pxz;
+    if (polarUnscented(s, m, y, S, Pxz)) {
+      if (detS) *detS = det(S);
+      if (!invertSym(S, Si)) return INFINITY;
+      return sqrtf((transpose(y) * Si * y).m[0][0]);
+    }
+  }
+  KMat<2, 4> H;
+  float d2;
+  if (polarLinearize(s, m, y, H)) {
+    d2 = s.kf.mahalanobis2Residual(H, y, polarCov(m), detS);
+  } else {
+    KMat<2, 1> z; KMat<2, 2> Rc;
+    polarToCart(m, z, Rc);
+    d2 = s.kf.mahalanobis2(measModel(), z, Rc, detS);
+  }
+  return d2 >= 0.0f ? sqrtf(d2) : INFINITY;
+}
+
+float targetFilterPolarUpdate(TargetFilterState& s, uint8_t mode, const TargetPolarMeas& m){
+  if (!s.initialized) {
+    KMat<2, 1> z; KMat<2, 2> Rc;
+    polarToCart(m, z, Rc);
+    initCov(s, z.m[0][0], z.m[1][0], Rc);
+    return 0.0f;
+  }
+  KMat<2, 1> y; KMat<2, 2> S, Si;
+  if (mode == TARGET_MEAS_UKF) {
+    KMat<4, 2> Pxz;
+    if (polarUnscented(s, m, y, S, Pxz)) {
+      if (!invertSym(S, Si)) return INFINITY;
+      // P = P - K S K' avec K = Pxz S^-1, soit P - Pxz K'
+      KMat<4, 2> K = Pxz * Si;
+      s.kf.x = s.kf.x + K * y;
+      s.kf.P = s.kf.P - mulTransB(Pxz, K);
+      symmetrize(s.kf.P);
+      return sqrtf((transpose(y) * Si * y).m[0][0]);
+    }
+    // P non définie positive ou cible sur le bateau: repli EKF
+  }
+  KMat<2, 4> H;
+  float d2;
+  if (polarLinearize(s, m, y, H)) {
+    d2 = s.kf.updateResidual(H, y, polarCov(m));
+  } else {
+    KMat<2, 1> z; KMat<2, 2> Rc;
+    polarToCart(m, z, Rc);
+    d2 = s.kf.update(measModel(), z, Rc);
+  }
+  return d2 >= 0.0f ? sqrtf(d2) : INFINITY;
+}
 
+static bool isPolar(uint8_t mode) { return mode == TARGET_MEAS_EKF || mode == TARGET_MEAS_UKF; }
+
+float targetFilterMeasInnovation(const TargetFilterState& s, const TargetMeas& m, float* detS){
+  if (isPolar(m.mode)) return targetFilterPolarInnovation(s, m.mode, m.polar, detS);
+  return targetFilterInnovation(s, m.x, m.y, m.posStd, detS);
+}
+
+float targetFilterMeasUpdate(TargetFilterState& s, const TargetMeas& m){
+  if (isPolar(m.mode)) return targetFilterPolarUpdate(s, m.mode, m.polar);
+  return targetFilterUpdate(s, m.x, m.y, m.posStd);
+}
+
+const char* targetMeasModeName(uint8_t mode){
+  switch (mode) {
+    case TARGET_MEAS_EKF: return "ekf";
+    case TARGET_MEAS_UKF: return "ukf";
+    default: return "cart";
+  }
+}
@@ -1,26 +1,80 @@
 #pragma once
-#include <Arduino.h>
+#include "kalman_fixed.h"
+
+// Kalman 2D vitesse constante: état [x, y, vx, vy] (m, m/s) dans le plan local,
+// covariance 4x4 complète. Deux formes de mesure:
+//  - position (x, y) à écart-type isotrope (mode cartésien historique);
+//  - (distance, gisement) depuis le bateau, covariance anisotrope (erreur radiale
+//    en distance, latérale croissant avec la distance), par EKF ou UKF.
+enum TargetMeasMode : uint8_t {
+  TARGET_MEAS_CART = 0,   // point converti, écart-type isotrope
+  TARGET_MEAS_EKF,        // (distance, gisement), jacobienne au point prédit
+  TARGET_MEAS_UKF,        // (distance, gisement), transformée sans parfum
+};
+
+// Mesure polaire dans le plan local
+struct TargetPolarMeas {
+  float originX, originY;   // position du bateau (m)
+  float range;              // distance (m, >= 0)
+  float bearingRad;         // gisement grille, depuis le nord, sens horaire (rad)
+  float rangeStd;           // écart-type radial (m)
+  float bearingStd;         // écart-type angulaire (rad)
+  float originStd;          // écart-type de position du bateau (m, isotrope)
+};
+
+// Mesure complète d'un ping: point converti (mode CART) et forme polaire (EKF/UKF)
+struct TargetMeas {
+  uint8_t mode;             // TargetMeasMode
+  float x, y;               // point converti (m)
+  float posStd;             // écart-type isotrope du point (m)
+  TargetPolarMeas polar;
+};
 
 struct TargetFilterState {
-  // State vector: [x, y, vx, vy] en mètres et m/s (UTM)
-  float x, y, vx, vy;
-  // Covariance 4x4 compacte (diagonale + croisements essentiels)
-  float Pxx, Pyy, Pvvx, Pvvy, Pxy, Pxvx, Pxvy, Pyvx, Pyvy, Pvxvy;
+  KalmanFixed<4, 2> kf;
   bool initialized;
 };
 
-// Initialise le filtre à partir d'une mesure (x,y) UTM
+// Initialise le filtre à partir d'une mesure (x,y) et de son écart-type (m)
 void targetFilterInit(TargetFilterState& s, float x, float y, float posStd);
 
+// Oublie l'état (la prochaine mesure réinitialise le filtre)
+void targetFilterReset(TargetFilterState& s);
+
+// Matrice de transition vitesse constante sur dt secondes
+KMat<4, 4> targetFilterTransition(float dt);
+
 // Prédiction avec dt secondes, bruit accélération std aStd (m/s^2)
 void targetFilterPredict(TargetFilterState& s, float dt, float aStd);
 
+// Prédiction d'une cible immobile: vitesse ramenée à zéro, position en marche
+// aléatoire d'écart-type driftStd (m/√s)
+void targetFilterPredictStatic(TargetFilterState& s, float dt, float driftStd);
+
+// Distance normalisée (Mahalanobis 2D, en sigma) d'une mesure, sans mise à jour; 0 si non initialisé
+float targetFilterInnovation(const TargetFilterState& s, float measX, float measY, float posStd, float* detS = nullptr);
+
 // Mise à jour avec une mesure (x,y) et écart-type posStd (m)
 // Retourne l'innovation (distance normalisée) pour détection d'outlier
 float targetFilterUpdate(TargetFilterState& s, float measX, float measY, float posStd);
 
+// Mêmes opérations en mesure polaire (mode EKF ou UKF; CART traité comme EKF).
+// Gating sur la distance de Mahalanobis 2D dans l'espace (distance, gisement).
+float targetFilterPolarInnovation(const TargetFilterState& s, uint8_t mode, const TargetPolarMeas& m, float* detS = nullptr);
+float targetFilterPolarUpdate(TargetFilterState& s, uint8_t mode, const TargetPolarMeas& m);
 
+// Répartition selon m.mode. detS (optionnel): déterminant de la covariance
+// d'innovation, dans l'espace de la mesure utilisée (vraisemblance IMM)
+float targetFilterMeasInnovation(const TargetFilterState& s, const TargetMeas& m, float* detS = nullptr);
+float targetFilterMeasUpdate(TargetFilterState& s, const TargetMeas& m);
 
+const char* targetMeasModeName(uint8_t mode);
 
-
-
+inline float targetFilterX(const TargetFilterState& s) { return s.kf.x.m[0][0]; }
+inline float targetFilterY(const TargetFilterState& s) { return s.kf.x.m[1][0]; }
+inline void targetFilterSetPos(TargetFilterState& s, float x, float y) { s.kf.x.m[0][0] = x; s.kf.x.m[1][0] = y; }
+// Écart-type de position moyen (m)
+inline float targetFilterPosStd(const TargetFilterState& s) {
+  float v = 0.5f * (s.kf.P.m[0][0] + s.kf.P.m[1][1]);
+  return v > 0.0f ? sqrtf(v) : 0.0f;
+}
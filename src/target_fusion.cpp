@@ -0,0 +1,353 @@
+#include "target_fusion.h"
+#include "config.h"
+#include "gps_skytraq.h"
+#include "seaker.h"
+#include "runtime_config.h"
+#include "target_filter.h"
+#include "target_smoother.h"
+#include "target_imm.h"
+#include "local_enu.h"
+#include "time_base.h"
+#include "spsc_queue.h"
+#include "seqlock.h"
+#include "svp_table.h"
+
+SeakerMode gSeakerMode = SEAKER_NORMAL;
+float gSeakerDistOffset = 0.0f;
+float gSeakerTransponderDelay = 0.0f;
+
+// Un ping plus récent que la dernière pose attend la suivante (interpolation
+// plutôt qu'extrapolation), au plus ce délai après sa réception
+static const int64_t PING_HOLD_US = 150000;
+// Un vidage des lisseurs (réinitialisation, réancrage de toutes les pistes) publie jusqu'à
+// TARGET_MAX_BEACONS * TARGET_SMOOTH_MAX_LAG sorties d'un coup
+static const uint32_t TARGET_OUT_QUEUE_LEN = 64;
+// Réinitialisation du filtre: silence trop long, ou mesures rejetées en série (cible déplacée)
+static const float FILTER_MAX_GAP_S = 30.0f;
+static const uint32_t FILTER_MAX_GATED = 5;
+
+static TaskHandle_t fusionTaskHandle = nullptr;
+static SpscQueue<TargetOutput, TARGET_OUT_QUEUE_LEN> outQueue;
+static TargetFusionStats stats = {};
+
+// Piste d'une balise: filtre(s), compteurs de gating et lisseur, sans allocation
+struct TargetTrack {
+  bool used;
+  uint8_t id;
+  bool immActive;
+  uint32_t gatedStreak;
+  int64_t lastUs;
+  TargetFilterState tf;
+  TargetImmState imm;   // pistage IMM (gKalmanImm), à la place de tf
+  TargetSmoothStep smoothSteps[TARGET_SMOOTH_MAX_LAG + 1];
+  TargetSmoother smoother;
+};
+
+static TargetTrack tracks[TARGET_MAX_BEACONS];
+static SeqLock<VesselMount> vesselMount;   // écrit par setup/web (targetFusionSetVessel)
+static portMUX_TYPE vesselMux = portMUX_INITIALIZER_UNLOCKED;   // sérialise les écrivains
+static LocalEnu enu = {};   // plan local commun aux pistes (réancré paresseusement)
+
+static void publish(TargetOutput& o);
+
+// Publie les pas lissés disponibles avec 'lag' pings de recul (0: vide le lisseur)
+static void publishSmoothed(TargetTrack& t, uint16_t lag) {
+  TargetSmoothOut s;
+  while (targetSmootherPop(t.smoother, lag, s)) {
+    TargetOutput o = {};
+    o.kind = TARGET_OUT_SMOOTHED;
+    o.beaconId = t.id;
+    o.model = 0xFF;
+    localEnuInverse(enu, s.x, s.y, o.lat, o.lon);
+    o.r95 = s.posStd * 2.45f;
+    o.azDeg = NAN; o.distM = NAN;
+    o.lag = (uint8_t)s.lag;
+    o.pingUs = s.tUs;
+    publish(o);
+    stats.smoothed++;
+  }
+}
+
+static void transferPos(const LocalEnu& prev, TargetFilterState& f) {
+  if (!f.initialized) return;
+  double lat, lon;
+  float x, y;
+  localEnuInverse(prev, targetFilterX(f), targetFilterY(f), lat, lon);
+  localEnuForward(enu, lat, lon, x, y);
+  targetFilterSetPos(f, x, y);
+}
+
+// Réancrage: l'état des filtres est reporté dans le nouveau plan (vitesses inchangées);
+// les lisseurs, exprimés dans l'ancien plan, sont vidés avant
+static void reanchor(double latDeg, double lonDeg) {
+  for (uint8_t i = 0; i < TARGET_MAX_BEACONS; ++i) if (tracks[i].used) publishSmoothed(tracks[i], 0);
+  LocalEnu prev = enu;
+  localEnuInit(enu, latDeg, lonDeg);
+  if (!prev.valid) return;
+  for (uint8_t i = 0; i < TARGET_MAX_BEACONS; ++i) {
+    TargetTrack& t = tracks[i];
+    if (!t.used) continue;
+    transferPos(prev, t.tf);
+    for (int j = 0; j < IMM_MODEL_COUNT; ++j) transferPos(prev, t.imm.f[j]);
+    targetImmCombine(t.imm);
+  }
+}
+
+static void resetTracker(TargetTrack& t) {
+  publishSmoothed(t, 0);
+  targetFilterReset(t.tf);
+  targetImmReset(t.imm);
+  t.gatedStreak = 0;
+}
+
+// Piste de la balise 'id': existante, sinon case libre, sinon la moins récemment mise à jour
+static TargetTrack& trackFor(uint8_t id) {
+  TargetTrack* oldest = &tracks[0];
+  TargetTrack* freeSlot = nullptr;
+  for (uint8_t i = 0; i < TARGET_MAX_BEACONS; ++i) {
+    TargetTrack& t = tracks[i];
+    if (t.used && t.id == id) return t;
+    if (!t.used) { if (!freeSlot) freeSlot = &t; }
+    else if (t.lastUs < oldest->lastUs) oldest = &t;
+  }
+  TargetTrack& t = freeSlot ? *freeSlot : *oldest;
+  if (!freeSlot) { publishSmoothed(t, 0); stats.evicted++; }
+  else stats.tracks++;
+  t.used = true;
+  t.id = id;
+  t.immActive = false;
+  t.lastUs = 0;
+  resetTracker(t);
+  return t;
+}
+
+// Fonction pour corriger la distance selon le mode configuré
+static float correctSeakerDistance(float rawDistance) {
+  switch(gSeakerMode) {
+    case SEAKER_OFFSET:
+      // Mode offset simple : soustraire une distance fixe
+      return rawDistance - gSeakerDistOffset;
+
+    case SEAKER_TRANSPONDER: {
+      // Mode transpondeur :
+      // 1. Convertir le délai ms en distance, à la célérité nominale du SEAKER
+      //    (la distance brute l'utilise aussi; le profil SVP corrige ensuite)
+      float delayDistance = (gSeakerTransponderDelay / 1000.0f) * SVP_NOMINAL_SPEED;
+      // 2. Soustraire cette distance
+      float remainingDistance = rawDistance - delayDistance;
+      // 3. Diviser par 2 (aller-retour)
+      return remainingDistance / 2.0f;
+    }
+
+    case SEAKER_NORMAL:
+    default:
+      return rawDistance;
+  }
+}
+
+static float estimateGpsPosStd(uint8_t fixQuality, float hdop){
+  // Estimation grossière en mètres selon fixQuality/hdop
+  if (fixQuality == 4) return 0.03f;      // RTK Fix ~3cm
+  if (fixQuality == 5) return 0.1f;       // RTK Float ~10cm
+  if (isfinite(hdop)) return max(1.0f, hdop * 1.5f);
+  return 3.0f; // fallback
+}
+
+static float estimateSeakerPosStd(float distanceM){
+  // Erreur angulaire configurable (deg)
+  const float angRadStd = gSeakerAngleSigmaDeg * (M_PI/180.0f);
+  float lateral = fabs(distanceM) * angRadStd;
+  // Erreur relative de distance configurable
+  float rangeErr = max(0.1f, gSeakerRangeRel * fabs(distanceM));
+  return sqrtf(lateral*lateral + rangeErr*rangeErr);
+}
+
+static void noteLatency(TargetLatencyStats& s, int64_t us) {
+  uint32_t v = (us < 0) ? 0 : (us > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)us);
+  s.lastUs = v;
+  if (v > s.maxUs) s.maxUs = v;
+  s.meanUs = s.count ? s.meanUs + ((int32_t)(v - s.meanUs) >> 4) : v;
+  s.count++;
+}
+
+static void publish(TargetOutput& o) {
+  o.doneUs = timeLocalUs();
+  if (!outQueue.push(o)) stats.outOverflow = outQueue.dropped();
+}
+
+static void fusePing(const SeakerPing& ping) {
+  stats.pings++;
+  if (!isfinite(ping.angleDeg) || !isfinite(ping.distanceM)) return;
+  // Pose du bateau interpolée à l'instant du ping (arrivée de la réponse sur la tête,
+  // voir parseSeakerNMEA), et non celle du dernier fix: en giration l'écart vaut
+  // plusieurs mètres
+  int64_t pingUs = ping.rxUs ? ping.rxUs : timeLocalUs();
+  PoseSample pose;
+  if (gpsPoseAt(pingUs, pose) == POSE_NONE) { stats.noPose++; return; }
+  double platformAz = pose.headingDeg;
+  if (!isfinite(platformAz)) { stats.noPose++; return; }
+  // Appliquer inversion/offset SEAKER
+  double rel = ping.angleDeg;
+  if (gSeakerInvertAngle) rel = -rel;
+  rel += (double)gSeakerAngleOffsetDeg;
+  while (rel < 0) rel += 360.0; while (rel >= 360.0) rel -= 360.0;
+  // Géométrie du bateau (précalculée): gisement horizontal du rayon,
+  // position de la tête par rapport à l'antenne, compensés du tangage/roulis
+  VesselMount vm;
+  vesselMount.read(vm);
+  VesselPingGeom vg;
+  vesselApplyPing(vm, (float)rel, pose.pitchDeg, pose.rollDeg, vg);
+  double az = platformAz + (double)vg.relBrgRad * (180.0/M_PI);
+  while (az < 0) az += 360.0; while (az >= 360.0) az -= 360.0;
+  // Appliquer la correction de distance selon le mode
+  double d = correctSeakerDistance(ping.distanceM); // mètres corrigés, célérité nominale
+  // Réfraction (profil de célérité): distance horizontale par la grille précalculée
+  d = svpHorizontalRange((float)d);
+
+  // Calcul dans le plan local (quelques multiplications, pas de trigonométrie double)
+  if (localEnuNeedsReanchor(enu, pose.latitude, pose.longitude)) reanchor(pose.latitude, pose.longitude);
+  float e0, n0;
+  localEnuForward(enu, pose.latitude, pose.longitude, e0, n0);
+  float hdg = localEnuGridAzimuth(enu, pose.longitude, (float)platformAz) * (float)(M_PI/180.0);
+  if (vg.fwd != 0.0f || vg.stbd != 0.0f) {
+    // Bras de levier (repère nivelé avant/tribord) tourné du cap: position de la tête
+    float sh = sinf(hdg), ch = cosf(hdg);
+    e0 += vg.fwd * sh + vg.stbd * ch;
+    n0 += vg.fwd * ch - vg.stbd * sh;
+  }
+  float brg = hdg + vg.relBrgRad;
+  float e1 = e0 + (float)d * sinf(brg);
+  float n1 = n0 + (float)d * cosf(brg);
+  double tgtLat, tgtLon;
+  localEnuInverse(enu, e1, n1, tgtLat, tgtLon);
+  // Estimation d'incertitude (écart-type) et r95
+  float gpsStd = estimateGpsPosStd(pose.fixQuality, pose.hdop);
+  float seakerStd = estimateSeakerPosStd((float)d);
+  float measStd = sqrtf(gpsStd*gpsStd + seakerStd*seakerStd);
+  // Même mesure en (distance, gisement): erreur radiale et latérale séparées
+  TargetMeas tm;
+  tm.mode = gKalmanMeasMode;
+  tm.x = e1; tm.y = n1; tm.posStd = measStd;
+  TargetPolarMeas& pm = tm.polar;
+  pm.originX = e0; pm.originY = n0;
+  pm.range = fabsf((float)d);
+  pm.bearingRad = (d < 0) ? brg + (float)M_PI : brg;
+  pm.rangeStd = max(0.1f, gSeakerRangeRel * pm.range);
+  pm.bearingStd = gSeakerAngleSigmaDeg * (float)(M_PI/180.0);
+  pm.originStd = gpsStd;
+
+  TargetOutput raw = {};
+  raw.kind = TARGET_OUT_RAW;
+  raw.beaconId = ping.beaconId;
+  raw.model = 0xFF;
+  raw.lat = tgtLat; raw.lon = tgtLon;
+  raw.r95 = measStd * 2.45f;
+  raw.azDeg = (float)az; raw.distM = (float)d;
+  raw.pingUs = pingUs;
+  publish(raw);
+
+  // Kalman 2D avec gating, sur la piste de la balise: dt entre pings de cette balise
+  TargetTrack& t = trackFor(ping.beaconId);
+  float dt = (t.lastUs==0)? 0.0f : (float)(pingUs - t.lastUs) / 1e6f; t.lastUs = pingUs;
+  bool imm = gKalmanImm;
+  // Changement de pisteur: repart de la mesure courante
+  if (imm != t.immActive) { resetTracker(t); t.immActive = imm; }
+  if (dt > FILTER_MAX_GAP_S || t.gatedStreak >= FILTER_MAX_GATED) resetTracker(t);
+  if (dt > 0.0f) {
+    if (imm) targetImmPredict(t.imm, dt, gKalmanAccelStd);
+    else targetFilterPredict(t.tf, dt, gKalmanAccelStd);
+  }
+  // Gating avant mise à jour: une mesure aberrante ne modifie pas l'état
+  float innov = imm ? targetImmInnovation(t.imm, tm) : targetFilterMeasInnovation(t.tf, tm);
+  if (innov >= gKalmanGate) { stats.gated++; t.gatedStreak++; return; }
+  t.gatedStreak = 0;
+  // A priori (combiné en IMM) pour le lisseur; en IMM le lissage RTS à transition CV
+  // est une approximation (voir target_smoother.h)
+  const TargetFilterState& est = imm ? t.imm.est : t.tf;
+  KalmanFixed<4, 2> prior = est.kf;
+  bool hadPrior = est.initialized;
+  if (imm) {
+    targetImmUpdate(t.imm, tm);
+    for (int j = 0; j < IMM_MODEL_COUNT; ++j) stats.immMu[j] = t.imm.mu[j];
+  } else {
+    targetFilterMeasUpdate(t.tf, tm);
+  }
+  // Filtre (ré)initialisé par cette mesure: pas d'a priori, le pas sert de point de départ
+  if (!hadPrior) prior = est.kf;
+  double fLat, fLon;
+  localEnuInverse(enu, targetFilterX(est), targetFilterY(est), fLat, fLon);
+  float posStdF = targetFilterPosStd(est);
+  TargetOutput filt = {};
+  filt.kind = TARGET_OUT_FILTERED;
+  filt.beaconId = t.id;
+  filt.model = imm ? (uint8_t)targetImmBestModel(t.imm) : 0xFF;
+  filt.lat = fLat; filt.lon = fLon;
+  filt.r95 = posStdF * 2.45f;
+  filt.azDeg = NAN; filt.distM = NAN;
+  filt.pingUs = pingUs;
+  publish(filt);
+  noteLatency(stats.fusion, filt.doneUs - pingUs);
+
+  uint16_t lag = gKalmanSmoothLag;
+  if (lag > TARGET_SMOOTH_MAX_LAG) lag = TARGET_SMOOTH_MAX_LAG;
+  if (lag) {
+    targetSmootherPush(t.smoother, pingUs, prior, est.kf);
+    publishSmoothed(t, lag);
+  } else if (t.smoother.count) {
+    publishSmoothed(t, 0);   // lisseur désactivé en cours de route
+  }
+}
+
+static void fusionTask(void* arg) {
+  (void)arg;
+  TickType_t wait = portMAX_DELAY;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, wait);
+    wait = portMAX_DELAY;
+    SeakerPing ping;
+    while (seakerPeekPing(ping)) {
+      int64_t pingUs = ping.rxUs ? ping.rxUs : timeLocalUs();
+      int64_t age = timeLocalUs() - pingUs;
+      if (pingUs > gpsPoseNewestUs() && age < PING_HOLD_US) {
+        // Réveil par la prochaine pose, ou à l'échéance pour extrapoler
+        static int64_t heldUs = 0;
+        if (pingUs != heldUs) { heldUs = pingUs; stats.held++; }
+        wait = pdMS_TO_TICKS((PING_HOLD_US - age) / 1000 + 1);
+        break;
+      }
+      seakerPopPing(ping);
+      fusePing(ping);
+    }
+  }
+}
+
+void targetFusionBegin() {
+  if (fusionTaskHandle) return;
+  targetFusionSetVessel(gVessel);
+  for (uint8_t i = 0; i < TARGET_MAX_BEACONS; ++i) {
+    targetSmootherInit(tracks[i].smoother, tracks[i].smoothSteps, TARGET_SMOOTH_MAX_LAG + 1);
+    targetImmReset(tracks[i].imm);
+  }
+  // Core 1 avec gps_rx/seaker, au-dessus de loop() (priorité 1)
+  xTaskCreatePinnedToCore(fusionTask, "fusion", 4096, nullptr, 2, &fusionTaskHandle, 1);
+}
+
+void targetFusionSetVessel(const VesselGeometry& g) {
+  VesselMount m;
+  vesselMountPrepare(g, m);
+  portENTER_CRITICAL(&vesselMux);
+  vesselMount.write(m);
+  portEXIT_CRITICAL(&vesselMux);
+}
+
+void targetFusionNotify() {
+  if (fusionTaskHandle) xTaskNotifyGive(fusionTaskHandle);
+}
+
+bool targetFusionPopOutput(TargetOutput& out) { return outQueue.pop(out); }
+
+void targetFusionNoteSink(const TargetOutput& out) {
+  if (out.kind == TARGET_OUT_FILTERED) noteLatency(stats.sink, timeLocalUs() - out.pingUs);
+}
+
+TargetFusionStats targetFusionGetStats() { return stats; }
@@ -0,0 +1,78 @@
+#pragma once
+#include <Arduino.h>
+#include "seaker_proto.h"
+#include "vessel_geometry.h"
+
+// Tâche de fusion cible (core 1, priorité au-dessus de loop()):
+// réveillée par notification à chaque ping SEAKER ou nouvelle pose GPS,
+// combine ping + pose interpolée, applique le filtre de Kalman de la piste
+// de la balise émettrice (banque fixe, routage par beaconId) et publie
+// les résultats dans une file lue par loop() (NMEA, WebSocket, télémétrie).
+// Le calcul ne dépend donc plus de la charge HTTP/WiFi/CLI.
+
+// Configuration de correction de distance SEAKER
+enum SeakerMode { SEAKER_NORMAL, SEAKER_OFFSET, SEAKER_TRANSPONDER };
+extern SeakerMode gSeakerMode;
+extern float gSeakerDistOffset;        // Offset en mètres
+extern float gSeakerTransponderDelay;  // Délai transpondeur en millisecondes
+
+// Pistes simultanées (une par balise/canal SEAKER), en mémoire statique;
+// au-delà, la piste mise à jour le moins récemment est recyclée
+static const uint8_t TARGET_MAX_BEACONS = 4;
+
+enum TargetOutKind : uint8_t {
+  TARGET_OUT_RAW = 0,       // position brute du ping ($TARGET)
+  TARGET_OUT_FILTERED,      // sortie Kalman acceptée par le gating ($TARGETF)
+  TARGET_OUT_SMOOTHED,      // sortie du lisseur RTS à retard fixe ($TARGETS)
+};
+
+// Résultat publié vers loop() (POD)
+struct TargetOutput {
+  uint8_t kind;
+  uint8_t beaconId;  // balise d'origine (SeakerPing::beaconId)
+  uint8_t model;     // filtré: modèle IMM dominant (TargetImmModel), 0xFF hors IMM
+  double lat;
+  double lon;
+  float r95;
+  float azDeg;       // brut uniquement
+  float distM;       // brut uniquement
+  uint8_t lag;       // lissé uniquement: pings plus récents pris en compte
+  int64_t pingUs;    // réception du ping (timeLocalUs)
+  int64_t doneUs;    // fin du calcul dans la tâche
+};
+
+struct TargetLatencyStats {
+  uint32_t count;
+  uint32_t lastUs;
+  uint32_t maxUs;
+  uint32_t meanUs;   // moyenne glissante (1/16)
+};
+
+struct TargetFusionStats {
+  uint32_t pings;        // pings traités
+  uint32_t noPose;       // pings sans pose exploitable
+  uint32_t gated;        // mesures rejetées par le gating Kalman
+  uint32_t held;         // pings mis en attente d'une pose postérieure
+  uint32_t outOverflow;  // résultats perdus (file de sortie pleine)
+  uint32_t smoothed;     // sorties lissées publiées
+  uint32_t tracks;       // pistes actives
+  uint32_t evicted;      // pistes recyclées pour une nouvelle balise (banque pleine)
+  float immMu[3];        // probabilités IMM (dernière piste mise à jour) immobile / vitesse constante / manœuvrant
+  TargetLatencyStats fusion;  // ping -> fin du calcul (tâche)
+  TargetLatencyStats sink;    // ping -> émission $TARGETF dans loop()
+};
+
+void targetFusionBegin();
+
+// Nouvelle géométrie du bateau (précalculée ici, prise en compte au ping suivant)
+void targetFusionSetVessel(const VesselGeometry& g);
+
+// Réveil de la tâche (ping en file ou nouvelle pose); sans effet avant targetFusionBegin
+void targetFusionNotify();
+
+// Consommateur unique (loop): retire le plus ancien résultat
+bool targetFusionPopOutput(TargetOutput& out);
+// À appeler par le consommateur après émission d'un résultat filtré
+void targetFusionNoteSink(const TargetOutput& out);
+
+TargetFusionStats targetFusionGetStats();
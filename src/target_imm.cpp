@@ -0,0 +1,120 @@
+#include "target_imm.h"
+
+// Modèle immobile: dérive de position (m/√s); modèle CV: bruit d'accélération (m/s^2)
+static const float IMM_STATIC_DRIFT = 0.05f;
+static const float IMM_CV_ACCEL = 0.05f;
+// Durée moyenne de séjour dans chaque modèle (s): p(quitter) = 1 - exp(-dt/tau),
+// répartie à parts égales sur les deux autres modèles
+static const float IMM_SOJOURN_S[IMM_MODEL_COUNT] = {30.0f, 30.0f, 10.0f};
+// Plancher de probabilité: un modèle reste toujours récupérable
+static const float IMM_MU_MIN = 1e-3f;
+
+// Mélange de moments: x = somme w x_i, P = somme w (P_i + dx dx')
+static void mergeMoments(const TargetFilterState* f, const float* w, TargetFilterState& out) {
+  KMat<4, 1> x = KMat<4, 1>::zero();
+  for (int i = 0; i < IMM_MODEL_COUNT; ++i) for (int r = 0; r < 4; ++r) x.m[r][0] += w[i] * f[i].kf.x.m[r][0];
+  KMat<4, 4> P = KMat<4, 4>::zero();
+  for (int i = 0; i < IMM_MODEL_COUNT; ++i) {
+    KMat<4, 1> d = f[i].kf.x - x;
+    KMat<4, 4> spread = f[i].kf.P + mulTransB(d, d);
+    for (int r = 0; r < 4; ++r) for (int c = 0; c < 4; ++c) P.m[r][c] += w[i] * spread.m[r][c];
+  }
+  out.kf.x = x;
+  out.kf.P = P;
+  out.initialized = true;
+}
+
+static void normalize(float* p) {
+  float sum = 0.0f;
+  for (int i = 0; i < IMM_MODEL_COUNT; ++i) { if (!(p[i] >= IMM_MU_MIN)) p[i] = IMM_MU_MIN; sum += p[i]; }
+  for (int i = 0; i < IMM_MODEL_COUNT; ++i) p[i] /= sum;
+}
+
+void targetImmReset(TargetImmState& s) {
+  for (int i = 0; i < IMM_MODEL_COUNT; ++i) {
+    targetFilterReset(s.f[i]);
+    s.mu[i] = s.cbar[i] = 1.0f / IMM_MODEL_COUNT;
+  }
+  targetFilterReset(s.est);
+  s.initialized = false;
+}
+
+void targetImmPredict(TargetImmState& s, float dt, float aStd) {
+  if (!s.initialized || !(dt > 0.0f)) return;
+  // Matrice de transition p[i][j] = P(modèle j à k | modèle i à k-1)
+  float p[IMM_MODEL_COUNT][IMM_MODEL_COUNT];
+  for (int i = 0; i < IMM_MODEL_COUNT; ++i) {
+    float leave = 1.0f - expf(-dt / IMM_SOJOURN_S[i]);
+    for (int j = 0; j < IMM_MODEL_COUNT; ++j) p[i][j] = (i == j) ? 1.0f - leave : leave / (IMM_MODEL_COUNT - 1);
+  }
+  // Conditions initiales mélangées de chaque modèle
+  TargetFilterState mixed[IMM_MODEL_COUNT];
+  for (int j = 0; j < IMM_MODEL_COUNT; ++j) {
+    float c = 0.0f;
+    for (int i = 0; i < IMM_MODEL_COUNT; ++i) c += p[i][j] * s.mu[i];
+    float w[IMM_MODEL_COUNT];
+    for (int i = 0; i < IMM_MODEL_COUNT; ++i) w[i] = p[i][j] * s.mu[i] / c;
+    mergeMoments(s.f, w, mixed[j]);
+    s.cbar[j] = c;
+  }
+  for (int j = 0; j < IMM_MODEL_COUNT; ++j) s.f[j] = mixed[j];
+  targetFilterPredictStatic(s.f[IMM_STATIONARY], dt, IMM_STATIC_DRIFT);
+  targetFilterPredict(s.f[IMM_CV], dt, IMM_CV_ACCEL);
+  targetFilterPredict(s.f[IMM_MANEUVER], dt, aStd);
+  mergeMoments(s.f, s.cbar, s.est);
+}
+
+float targetImmInnovation(const TargetImmState& s, const TargetMeas& m) {
+  if (!s.initialized) return 0.0f;
+  float best = INFINITY;
+  for (int j = 0; j < IMM_MODEL_COUNT; ++j) {
+    float d = targetFilterMeasInnovation(s.f[j], m);
+    if (d < best) best = d;
+  }
+  return best;
+}
+
+void targetImmUpdate(TargetImmState& s, const TargetMeas& m) {
+  if (!s.initialized) {
+    for (int j = 0; j < IMM_MODEL_COUNT; ++j) targetFilterMeasUpdate(s.f[j], m);
+    s.initialized = true;
+    targetImmCombine(s);
+    return;
+  }
+  // Log-vraisemblance de la mesure sous chaque modèle, avant mise à jour
+  float ll[IMM_MODEL_COUNT], llMax = -INFINITY;
+  for (int j = 0; j < IMM_MODEL_COUNT; ++j) {
+    float detS = 0.0f;
+    float d = targetFilterMeasInnovation(s.f[j], m, &detS);
+    ll[j] = (isfinite(d) && detS > 0.0f) ? -0.5f * d * d - 0.5f * logf(detS) : -INFINITY;
+    if (ll[j] > llMax) llMax = ll[j];
+    targetFilterMeasUpdate(s.f[j], m);
+  }
+  if (isfinite(llMax)) {
+    for (int j = 0; j < IMM_MODEL_COUNT; ++j) s.mu[j] = s.cbar[j] * expf(ll[j] - llMax);
+  } else {
+    for (int j = 0; j < IMM_MODEL_COUNT; ++j) s.mu[j] = s.cbar[j];
+  }
+  normalize(s.mu);
+  targetImmCombine(s);
+}
+
+void targetImmCombine(TargetImmState& s) {
+  if (!s.initialized) return;
+  mergeMoments(s.f, s.mu, s.est);
+}
+
+uint8_t targetImmBestModel(const TargetImmState& s) {
+  uint8_t b = 0;
+  for (int j = 1; j < IMM_MODEL_COUNT; ++j) if (s.mu[j] > s.mu[b]) b = (uint8_t)j;
+  return b;
+}
+
+const char* targetImmModelName(uint8_t model) {
+  switch (model) {
+    case IMM_STATIONARY: return "stationary";
+    case IMM_CV: return "cv";
+    case IMM_MANEUVER: return "maneuver";
+    default: return "?";
+  }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "target_filter.h"
+
+// Pistage IMM (Interacting Multiple Model) de la cible: trois filtres
+// target_filter sur le même état [x, y, vx, vy], mélangés à chaque ping
+// selon une chaîne de Markov entre modèles:
+//  - immobile: vitesse ramenée à zéro, dérive lente de position (ROV en stationnaire);
+//  - vitesse constante peu bruitée (transit régulier);
+//  - manœuvrant: vitesse constante à fort bruit d'accélération (aStd, réglage K).
+// Les probabilités de modèle suivent la vraisemblance de chaque mesure; la sortie
+// est le mélange (moments) des trois estimations. Stockage statique, trois
+// prédictions/mises à jour 4x4 par ping. Module sans dépendance Arduino.
+
+enum TargetImmModel : uint8_t {
+  IMM_STATIONARY = 0,
+  IMM_CV,
+  IMM_MANEUVER,
+  IMM_MODEL_COUNT
+};
+
+struct TargetImmState {
+  TargetFilterState f[IMM_MODEL_COUNT];
+  float mu[IMM_MODEL_COUNT];      // probabilités de modèle (après la dernière mesure)
+  float cbar[IMM_MODEL_COUNT];    // probabilités prédites (après mélange)
+  TargetFilterState est;          // estimation combinée
+  bool initialized;
+};
+
+void targetImmReset(TargetImmState& s);
+
+// Mélange des modèles puis prédiction de chacun sur dt secondes; s.est devient
+// l'a priori combiné. aStd: bruit d'accélération du modèle manœuvrant (m/s^2)
+void targetImmPredict(TargetImmState& s, float dt, float aStd);
+
+// Distance normalisée minimale sur les modèles (une mesure compatible avec au
+// moins un modèle n'est pas aberrante); 0 si non initialisé
+float targetImmInnovation(const TargetImmState& s, const TargetMeas& m);
+
+// Mise à jour des trois modèles, des probabilités et de l'estimation combinée
+void targetImmUpdate(TargetImmState& s, const TargetMeas& m);
+
+// Recalcule s.est après modification externe des modèles (réancrage)
+void targetImmCombine(TargetImmState& s);
+
+// Modèle le plus probable
+uint8_t targetImmBestModel(const TargetImmState& s);
+const char* targetImmModelName(uint8_t model);
@@ -0,0 +1,92 @@
+#include "target_smoother.h"
+#include "target_filter.h"
+
+static TargetSmoothStep& stepAt(TargetSmoother& sm, uint32_t i) {
+  return sm.steps[(sm.first + i) % sm.cap];
+}
+
+void targetSmootherInit(TargetSmoother& sm, TargetSmoothStep* buf, uint16_t cap) {
+  sm.steps = buf;
+  sm.cap = cap;
+  sm.dropped = 0;
+  targetSmootherReset(sm);
+}
+
+void targetSmootherReset(TargetSmoother& sm) {
+  sm.count = 0;
+  sm.first = 0;
+  sm.final = false;
+}
+
+bool targetSmootherPush(TargetSmoother& sm, int64_t tUs, const KalmanFixed<4, 2>& prior, const KalmanFixed<4, 2>& post) {
+  bool ok = true;
+  if (!sm.cap) return false;
+  if (sm.count == sm.cap) {
+    sm.first = (sm.first + 1) % sm.cap;
+    sm.count--;
+    sm.dropped++;
+    ok = false;
+  }
+  if (sm.count && !sm.final) {
+    // Gain du pas précédent: C = P F' Pp^-1, soit C' = Pp^-1 (F P) (P, Pp symétriques)
+    TargetSmoothStep& prev = stepAt(sm, sm.count - 1);
+    float dt = (float)(tUs - prev.tUs) / 1e6f;
+    KMat<4, 4> FP = targetFilterTransition(dt > 0.0f ? dt : 0.0f) * prev.P;
+    KMat<4, 4> L;
+    prev.C = cholesky(prior.P, L) ? transpose(cholSolve(L, FP)) : KMat<4, 4>::zero();
+  }
+  TargetSmoothStep& s = stepAt(sm, sm.count);
+  s.tUs = tUs;
+  s.x = post.x; s.P = post.P;
+  s.xp = prior.x; s.Pp = prior.P;
+  s.C = KMat<4, 4>::zero();
+  sm.count++;
+  sm.final = false;
+  return ok;
+}
+
+// Lissage définitif en place de tous les pas en attente (x, P remplacés, gains annulés)
+static void finalize(TargetSmoother& sm) {
+  for (int i = (int)sm.count - 2; i >= 0; --i) {
+    TargetSmoothStep& k = stepAt(sm, i);
+    const TargetSmoothStep& n = stepAt(sm, i + 1);
+    k.x = k.x + k.C * (n.x - n.xp);
+    k.P = k.P + mulTransB(k.C * (n.P - n.Pp), k.C);
+    symmetrize(k.P);
+    k.C = KMat<4, 4>::zero();
+  }
+  sm.final = true;
+}
+
+bool targetSmootherPop(TargetSmoother& sm, uint16_t lag, TargetSmoothOut& out) {
+  if (!sm.count || sm.count <= lag) return false;
+  KMat<4, 1> xs;
+  KMat<4, 4> Ps;
+  if (lag == 0) {
+    if (!sm.final) finalize(sm);
+    xs = stepAt(sm, 0).x;
+    Ps = stepAt(sm, 0).P;
+  } else {
+    // Passage arrière du plus récent (lissé = filtré) jusqu'au plus ancien
+    const TargetSmoothStep& last = stepAt(sm, sm.count - 1);
+    xs = last.x;
+    Ps = last.P;
+    for (int i = (int)sm.count - 2; i >= 0; --i) {
+      const TargetSmoothStep& k = stepAt(sm, i);
+      const TargetSmoothStep& n = stepAt(sm, i + 1);
+      xs = k.x + k.C * (xs - n.xp);
+      Ps = k.P + mulTransB(k.C * (Ps - n.Pp), k.C);
+    }
+    symmetrize(Ps);
+  }
+  const TargetSmoothStep& o = stepAt(sm, 0);
+  out.tUs = o.tUs;
+  out.x = xs.m[0][0]; out.y = xs.m[1][0];
+  out.vx = xs.m[2][0]; out.vy = xs.m[3][0];
+  float v = 0.5f * (Ps.m[0][0] + Ps.m[1][1]);
+  out.posStd = v > 0.0f ? sqrtf(v) : 0.0f;
+  out.lag = sm.count - 1;
+  sm.first = (sm.first + 1) % sm.cap;
+  sm.count--;
+  return true;
+}
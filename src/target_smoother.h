@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+#include "kalman_fixed.h"
+
+// Lisseur de Rauch-Tung-Striebel à retard fixe pour le filtre cible
+// (target_filter): chaque pas mis à jour est conservé (état filtré, a priori
+// et gain de lissage) dans un anneau préalloué par l'appelant. Un pas est
+// restitué lissé dès que 'lag' pas plus récents sont disponibles:
+//   xs_k = x_k + C_k (xs_k+1 - xp_k+1)
+//   Ps_k = P_k + C_k (Ps_k+1 - Pp_k+1) C_k'
+// avec C_k = P_k F' Pp_k+1^-1 calculé une seule fois, à l'arrivée du pas k+1;
+// le passage arrière ne coûte ensuite que des produits 4x4 par pas.
+// Utilisé en ligne par target_fusion ($TARGETS) et hors ligne par
+// tools/track_smooth.cpp. Module sans dépendance Arduino.
+// F est toujours la transition vitesse constante. En pistage IMM, target_fusion
+// pousse l'a priori et l'estimation combinés (mélange des moments des trois
+// modèles): le lissage est alors une approximation. L'a priori combiné n'est pas
+// F x_k et le gain suppose la covariance croisée F P_k entre pas, ce qui n'est
+// exact qu'en modèle unique; ce n'est pas un lisseur IMM (probabilités de modèle
+// non lissées).
+
+static const uint16_t TARGET_SMOOTH_MAX_LAG = 16;   // retard maximal en ligne (pas)
+
+struct TargetSmoothStep {
+  int64_t tUs;          // instant du ping
+  KMat<4, 1> x;         // état filtré (après mise à jour)
+  KMat<4, 4> P;
+  KMat<4, 1> xp;        // a priori de ce pas (avant mise à jour)
+  KMat<4, 4> Pp;
+  KMat<4, 4> C;         // gain de lissage vers le pas suivant (nul pour le plus récent)
+};
+
+struct TargetSmoother {
+  TargetSmoothStep* steps;
+  uint16_t cap;
+  uint16_t count;       // pas en attente
+  uint32_t first;       // index (modulo cap) du plus ancien
+  uint32_t dropped;     // pas perdus (anneau plein)
+  bool final;           // pas en attente déjà lissés définitivement (vidage en cours)
+};
+
+struct TargetSmoothOut {
+  int64_t tUs;
+  float x, y, vx, vy;   // plan local (m, m/s)
+  float posStd;         // écart-type de position moyen lissé (m)
+  uint16_t lag;         // pas plus récents utilisés
+};
+
+void targetSmootherInit(TargetSmoother& sm, TargetSmoothStep* buf, uint16_t cap);
+void targetSmootherReset(TargetSmoother& sm);
+
+// Ajoute un pas: a priori (avant mise à jour) et état filtré du filtre cible.
+// Faux si l'anneau était plein (le plus ancien pas est alors abandonné)
+bool targetSmootherPush(TargetSmoother& sm, int64_t tUs, const KalmanFixed<4, 2>& prior, const KalmanFixed<4, 2>& post);
+
+// Retire le plus ancien pas, lissé, s'il est suivi d'au moins 'lag' pas.
+// lag 0: vidage; un seul passage arrière lisse alors tous les pas en attente
+// (lissage complet de la trace en O(n) hors ligne)
+bool targetSmootherPop(TargetSmoother& sm, uint16_t lag, TargetSmoothOut& out);
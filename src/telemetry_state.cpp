@@ -1,12 +1,66 @@
 #include "telemetry_state.h"
+#include "target_imm.h"
+#include "ws_binary.h"
 
 volatile double gTargetFLat = NAN;
 volatile double gTargetFLon = NAN;
 volatile float gTargetFR95 = NAN;
 volatile unsigned long gTargetFMs = 0;
+volatile uint8_t gTargetFId = 0;
+TelemetryTarget gTargets[TARGET_MAX_BEACONS] = {};
 
+void telemetrySetTarget(const TargetOutput& o){
+  telemetrySetTargetF(o.lat, o.lon, o.r95, o.beaconId);
+  TelemetryTarget* slot = &gTargets[0];
+  for (uint8_t i = 0; i < TARGET_MAX_BEACONS; ++i) {
+    TelemetryTarget& t = gTargets[i];
+    if (t.ms && t.id == o.beaconId) { slot = &t; break; }
+    if (t.ms < slot->ms) slot = &t;   // case libre (0) ou plus ancienne
+  }
+  slot->id = o.beaconId;
+  slot->model = o.model;
+  slot->lat = o.lat; slot->lon = o.lon; slot->r95 = o.r95;
+  slot->ms = millis();
+  if (!slot->ms) slot->ms = 1;
+}
 
+void telemetryTargetsJsonTo(NmeaWriter& w){
+  nmeaPutChar(w, '[');
+  bool first = true;
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < TARGET_MAX_BEACONS; ++i) {
+    const TelemetryTarget& t = gTargets[i];
+    if (!t.ms) continue;
+    if (!first) nmeaPutChar(w, ',');
+    first = false;
+    nmeaPutStr(w, "{\"id\":"); nmeaPutU32(w, t.id);
+    nmeaPutStr(w, ",\"lat\":"); nmeaPutFixed(w, t.lat, 7, "null");
+    nmeaPutStr(w, ",\"lon\":"); nmeaPutFixed(w, t.lon, 7, "null");
+    nmeaPutStr(w, ",\"r95_m\":"); nmeaPutFixed(w, t.r95, 2, "null");
+    nmeaPutStr(w, ",\"model\":");
+    if (t.model == 0xFF) nmeaPutStr(w, "null");
+    else { nmeaPutChar(w, '"'); nmeaPutStr(w, targetImmModelName(t.model)); nmeaPutChar(w, '"'); }
+    nmeaPutStr(w, ",\"age_ms\":"); nmeaPutU32(w, (uint32_t)(now - t.ms));
+    nmeaPutChar(w, '}');
+  }
+  nmeaPutChar(w, ']');
+}
 
+size_t telemetryTargetsBinTo(uint8_t* p){
+  size_t n = wsbEncodeBeacons(p);
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < TARGET_MAX_BEACONS; ++i) {
+    const TelemetryTarget& t = gTargets[i];
+    if (!t.ms) continue;
+    n += wsbBeaconsAdd(p, p + n, t.id, t.model, t.lat, t.lon, t.r95, (uint32_t)(now - t.ms));
+  }
+  return n;
+}
 
-
-
+String telemetryTargetsJson(){
+  char buf[TARGET_MAX_BEACONS * 128 + 8];
+  NmeaWriter w;
+  nmeaWriterInit(w, buf, sizeof(buf));
+  telemetryTargetsJsonTo(w);
+  return String(nmeaText(w));
+}
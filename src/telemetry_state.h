@@ -1,18 +1,37 @@
 #pragma once
 #include <Arduino.h>
+#include "target_fusion.h"
+#include "nmea_writer.h"
 
 // Dernière cible filtrée (TARGETF) connue
 extern volatile double gTargetFLat;
 extern volatile double gTargetFLon;
 extern volatile float gTargetFR95;
 extern volatile unsigned long gTargetFMs;
+extern volatile uint8_t gTargetFId;    // balise de cette position
 
-inline void telemetrySetTargetF(double lat, double lon, float r95){
-  gTargetFLat = lat; gTargetFLon = lon; gTargetFR95 = r95; gTargetFMs = millis();
+inline void telemetrySetTargetF(double lat, double lon, float r95, uint8_t id = 0){
+  gTargetFLat = lat; gTargetFLon = lon; gTargetFR95 = r95; gTargetFMs = millis(); gTargetFId = id;
 }
 
-
-
-
-
-
+// Dernière position filtrée par balise (écrit et lu dans loop(): émission des
+// sorties fusion, /api/telemetry, WebSocket); ms == 0: case libre
+struct TelemetryTarget {
+  uint8_t id;
+  uint8_t model;        // modèle IMM dominant, 0xFF hors IMM
+  double lat;
+  double lon;
+  float r95;
+  unsigned long ms;     // millis() de la dernière mise à jour
+};
+extern TelemetryTarget gTargets[TARGET_MAX_BEACONS];
+
+// Met à jour la case de la balise (ou la plus ancienne) et la cible unique gTargetF*
+void telemetrySetTarget(const TargetOutput& o);
+// Tableau JSON des cases occupées: [{"id":..,"lat":..,"lon":..,"r95_m":..,"model":..,"age_ms":..}]
+String telemetryTargetsJson();
+// Idem, écrit sans allocation (~110 octets par balise)
+void telemetryTargetsJsonTo(NmeaWriter& w);
+// Idem en enregistrement binaire BEACONS (ws_binary) écrit en 'p', qui doit pouvoir recevoir
+// WSB_BEACONS_SIZE + TARGET_MAX_BEACONS * WSB_BEACON_SIZE octets. Retourne les octets écrits
+size_t telemetryTargetsBinTo(uint8_t* p);
@@ -0,0 +1,158 @@
+#include "time_base.h"
+#include "seqlock.h"
+#include <esp_timer.h>
+
+// Latence max entre le front PPS et l'arrivée de l'époque correspondante
+static const int64_t PPS_MAX_LATENCY_US = 800000;
+// Au-delà, un intervalle entre PPS consécutifs est rejeté (horloge ou front parasite)
+static const int64_t PPS_MAX_INTERVAL_ERR_US = 500;
+// PPS considéré perdu après ce délai (l'ancrage continue en roue libre)
+static const int64_t PPS_LOST_US = 3000000;
+
+struct TimeAnchor {
+  int64_t localUs;   // instant local de référence
+  int64_t utcUs;     // UTC correspondant
+  int32_t driftPpb;
+  uint8_t state;
+};
+
+static SeqLock<TimeAnchor> anchor;
+static portMUX_TYPE ppsMux = portMUX_INITIALIZER_UNLOCKED;
+static volatile int64_t ppsLocalUs = 0;
+static volatile uint32_t ppsCount = 0;
+
+// État de la discipline (tâche gps_rx uniquement)
+static uint32_t lastPpsCount = 0;
+static int64_t lastPpsLocalUs = 0;
+static int64_t lastPpsUtcUs = 0;
+static int32_t driftPpb = 0;
+static int32_t residualUs = 0;
+static uint32_t ppsRejected = 0;
+
+static void IRAM_ATTR onPps() {
+  int64_t t = esp_timer_get_time();
+  portENTER_CRITICAL_ISR(&ppsMux);
+  ppsLocalUs = t;
+  ppsCount++;
+  portEXIT_CRITICAL_ISR(&ppsMux);
+}
+
+static void readPps(int64_t& t, uint32_t& n) {
+  portENTER_CRITICAL(&ppsMux);
+  t = ppsLocalUs;
+  n = ppsCount;
+  portEXIT_CRITICAL(&ppsMux);
+}
+
+// Jours depuis 1970-01-01 (calendrier grégorien)
+static int64_t daysFromCivil(int y, unsigned m, unsigned d) {
+  y -= (m <= 2) ? 1 : 0;
+  int era = (y >= 0 ? y : y - 399) / 400;
+  unsigned yoe = (unsigned)(y - era * 400);
+  unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return (int64_t)era * 146097 + (int64_t)doe - 719468;
+}
+
+static int64_t anchorToUtc(const TimeAnchor& a, int64_t localUs) {
+  int64_t dt = localUs - a.localUs;
+  return a.utcUs + dt - (dt * a.driftPpb) / 1000000000LL;
+}
+
+static int64_t utcToAnchorLocal(const TimeAnchor& a, int64_t utcUs) {
+  int64_t du = utcUs - a.utcUs;
+  return a.localUs + du + (du * a.driftPpb) / 1000000000LL;
+}
+
+static void publishAnchor(int64_t localUs, int64_t utcUs, uint8_t state) {
+  TimeAnchor a = { localUs, utcUs, driftPpb, state };
+  anchor.write(a);
+}
+
+void timeBaseBegin(int ppsPin) {
+  if (ppsPin < 0) return;
+  pinMode(ppsPin, INPUT);
+  attachInterrupt(digitalPinToInterrupt(ppsPin), onPps, RISING);
+}
+
+int64_t timeLocalUs() { return esp_timer_get_time(); }
+
+int64_t timeLocalToUtcUs(int64_t localUs) {
+  TimeAnchor a;
+  anchor.read(a);
+  if (a.state == TIME_SYNC_NONE) return 0;
+  return anchorToUtc(a, localUs);
+}
+
+int64_t timeNowUtcUs() { return timeLocalToUtcUs(esp_timer_get_time()); }
+
+bool timeUtcValid() { return anchor.version() != 0; }
+
+int64_t timeBaseOnGpsEpoch(uint16_t year, uint8_t month, uint8_t day, int32_t utcMs, int64_t rxLocalUs) {
+  if (year < 2000 || month < 1 || month > 12 || day < 1 || utcMs < 0) return rxLocalUs;
+  int64_t epochUtcUs = daysFromCivil(year, month, day) * 86400000000LL + (int64_t)utcMs * 1000;
+  int64_t pLocal; uint32_t pCount;
+  readPps(pLocal, pCount);
+
+  if (pCount != 0 && pCount != lastPpsCount) {
+    // L'époque de fraction 'frac' arrive au moins frac ms après le front de sa seconde
+    int64_t frac = (int64_t)(utcMs % 1000) * 1000;
+    int64_t elapsed = rxLocalUs - pLocal;
+    if (elapsed >= frac && elapsed < frac + PPS_MAX_LATENCY_US) {
+      int64_t ppsUtc = epochUtcUs - frac;
+      if (lastPpsCount && pCount == lastPpsCount + 1 && ppsUtc == lastPpsUtcUs + 1000000) {
+        int64_t err = (pLocal - lastPpsLocalUs) - 1000000;
+        if (err > -PPS_MAX_INTERVAL_ERR_US && err < PPS_MAX_INTERVAL_ERR_US) {
+          // Écart de l'ancrage précédent sur ce front, puis dérive filtrée (1 ppb = 1 ns/s)
+          TimeAnchor a; anchor.read(a);
+          residualUs = (int32_t)(anchorToUtc(a, pLocal) - ppsUtc);
+          driftPpb += (int32_t)((err * 1000 - driftPpb) / 8);
+        } else {
+          ppsRejected++;
+        }
+      }
+      lastPpsCount = pCount;
+      lastPpsLocalUs = pLocal;
+      lastPpsUtcUs = ppsUtc;
+      publishAnchor(pLocal, ppsUtc, TIME_SYNC_PPS);
+      return pLocal + frac + (frac * driftPpb) / 1000000000LL;
+    }
+    ppsRejected++;
+    lastPpsCount = pCount;
+  }
+  // Sans PPS récent: ancrage sur l'arrivée de l'époque
+  TimeAnchor a; anchor.read(a);
+  if (a.state != TIME_SYNC_PPS || rxLocalUs - a.localUs > PPS_LOST_US) {
+    publishAnchor(rxLocalUs, epochUtcUs, TIME_SYNC_NMEA);
+    return rxLocalUs;
+  }
+  // PPS manqué mais ancrage récent: roue libre
+  return utcToAnchorLocal(a, epochUtcUs);
+}
+
+TimeBaseStats timeBaseGetStats() {
+  TimeBaseStats s;
+  TimeAnchor a;
+  anchor.read(a);
+  int64_t pLocal; uint32_t pCount;
+  readPps(pLocal, pCount);
+  int64_t now = esp_timer_get_time();
+  s.state = a.state;
+  if (s.state == TIME_SYNC_PPS && now - a.localUs > PPS_LOST_US) s.state = TIME_SYNC_NMEA;
+  s.ppsCount = pCount;
+  s.ppsAgeMs = pCount ? (uint32_t)((now - pLocal) / 1000) : UINT32_MAX;
+  s.driftPpb = a.driftPpb;
+  s.residualUs = residualUs;
+  s.ppsRejected = ppsRejected;
+  return s;
+}
+
+bool timeFormatNmeaUtc(int64_t utcUs, char* out, size_t cap) {
+  if (utcUs <= 0 || !out || cap < 10) return false;
+  int64_t tod = utcUs % 86400000000LL;
+  uint32_t cs = (uint32_t)(tod / 10000); // centièmes de seconde
+  uint32_t s = cs / 100;
+  snprintf(out, cap, "%02lu%02lu%02lu.%02lu", (unsigned long)(s / 3600), (unsigned long)((s / 60) % 60),
+           (unsigned long)(s % 60), (unsigned long)(cs % 100));
+  return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <Arduino.h>
+
+// Base de temps µs disciplinée par le PPS GPS.
+// Le front PPS est daté par esp_timer dans l'ISR; la tâche gps_rx l'associe à
+// la seconde UTC de l'époque NMEA/binaire qui suit, puis estime la dérive de
+// l'horloge locale sur les PPS consécutifs. Sans PPS, ancrage grossier sur
+// l'arrivée des trames (latence UART incluse, quelques dizaines de ms).
+// Lecture sans verrou depuis n'importe quel cœur (seqlock).
+
+enum TimeSyncState : uint8_t {
+  TIME_SYNC_NONE = 0,
+  TIME_SYNC_NMEA = 1,  // ancré sur l'arrivée des trames
+  TIME_SYNC_PPS = 2,   // ancré sur un front PPS (< 3 s)
+};
+
+struct TimeBaseStats {
+  uint8_t state;           // TimeSyncState courant
+  uint32_t ppsCount;       // fronts PPS reçus
+  uint32_t ppsAgeMs;       // depuis le dernier front (UINT32_MAX si aucun)
+  int32_t driftPpb;        // dérive estimée de l'horloge locale (>0: locale en avance)
+  int32_t residualUs;      // écart prédiction / PPS mesuré au dernier ancrage
+  uint32_t ppsRejected;    // fronts non associés (intervalle ou latence hors tolérance)
+};
+
+// Installe l'interruption PPS (front montant); ppsPin < 0 = sans PPS
+void timeBaseBegin(int ppsPin);
+
+// Horloge locale monotone (esp_timer), µs depuis le boot
+int64_t timeLocalUs();
+
+// Temps UTC courant en µs depuis 1970-01-01, 0 si non synchronisé
+int64_t timeNowUtcUs();
+// Convertit un horodatage local (timeLocalUs) en UTC, 0 si non synchronisé
+int64_t timeLocalToUtcUs(int64_t localUs);
+bool timeUtcValid();
+
+// Appelé par la tâche gps_rx à la clôture d'une époque datée. Retourne l'instant
+// local (timeLocalUs) de l'époque: déduit du PPS si synchronisé, sinon rxLocalUs.
+int64_t timeBaseOnGpsEpoch(uint16_t year, uint8_t month, uint8_t day, int32_t utcMs, int64_t rxLocalUs);
+
+TimeBaseStats timeBaseGetStats();
+
+// "hhmmss.ss" (champ heure NMEA); faux si utcUs invalide
+bool timeFormatNmeaUtc(int64_t utcUs, char* out, size_t cap);
@@ -1,85 +1,194 @@
 #include "utm.h"
-#include <math.h>
 
-// Implémentation compacte d'après l'ellipsoïde WGS84
-// Références: Snyder, "Map Projections - A Working Manual"
+// Mercator transverse par les séries de Krüger en n (ordre 6), d'après
+// Karney, "Transverse Mercator with an accuracy of a few nanometers" (2011):
+// erreur < 5 nm jusqu'à 3900 km du méridien central, contre quelques mm à cm
+// en bord de fuseau pour les développements en A de Snyder utilisés auparavant.
+// Coefficients de l'ellipsoïde évalués à la compilation; les multiples
+// sin(2jξ)cosh(2jη) sont obtenus par récurrence et, à l'aller, sin 2ξ' / exp 2η'
+// par identités algébriques: 2 sin/cos, atan2, log et 2 sqrt par point.
+
+static constexpr double WGS84_A = 6378137.0;
+static constexpr double WGS84_F = 1.0 / 298.257223563;
+static constexpr double K0 = 0.9996;
+static constexpr double FALSE_EASTING = 500000.0;
+static constexpr double FALSE_NORTHING_S = 10000000.0;
+static constexpr double DEG = M_PI / 180.0;
+
+static constexpr double N1 = WGS84_F / (2.0 - WGS84_F);
+static constexpr double N2 = N1 * N1;
+static constexpr double N3 = N2 * N1;
+static constexpr double N4 = N3 * N1;
+static constexpr double N5 = N4 * N1;
+static constexpr double N6 = N5 * N1;
+
+// Rayon rectifiant multiplié par k0
+static constexpr double K0A = K0 * WGS84_A / (1.0 + N1) * (1.0 + N2 / 4.0 + N4 / 64.0 + N6 / 256.0);
+// Excentricité e = sqrt(f (2 - f)) (sqrt n'est pas constexpr en C++11)
+static constexpr double ECC = 0.0818191908426214943;
+static_assert(ECC * ECC - WGS84_F * (2.0 - WGS84_F) < 1e-16 && ECC * ECC - WGS84_F * (2.0 - WGS84_F) > -1e-16,
+              "excentricité WGS84");
+
+static constexpr double ALPHA[6] = {
+  N1 / 2.0 - 2.0 * N2 / 3.0 + 5.0 * N3 / 16.0 + 41.0 * N4 / 180.0 - 127.0 * N5 / 288.0 + 7891.0 * N6 / 37800.0,
+  13.0 * N2 / 48.0 - 3.0 * N3 / 5.0 + 557.0 * N4 / 1440.0 + 281.0 * N5 / 630.0 - 1983433.0 * N6 / 1935360.0,
+  61.0 * N3 / 240.0 - 103.0 * N4 / 140.0 + 15061.0 * N5 / 26880.0 + 167603.0 * N6 / 181440.0,
+  49561.0 * N4 / 161280.0 - 179.0 * N5 / 168.0 + 6601661.0 * N6 / 7257600.0,
+  34729.0 * N5 / 80640.0 - 3418889.0 * N6 / 1995840.0,
+  212378941.0 * N6 / 319334400.0,
+};
+
+static constexpr double BETA[6] = {
+  N1 / 2.0 - 2.0 * N2 / 3.0 + 37.0 * N3 / 96.0 - N4 / 360.0 - 81.0 * N5 / 512.0 + 96199.0 * N6 / 604800.0,
+  N2 / 48.0 + N3 / 15.0 - 437.0 * N4 / 1440.0 + 46.0 * N5 / 105.0 - 1118711.0 * N6 / 3870720.0,
+  17.0 * N3 / 480.0 - 37.0 * N4 / 840.0 - 209.0 * N5 / 4480.0 + 5569.0 * N6 / 90720.0,
+  4397.0 * N4 / 161280.0 - 11.0 * N5 / 504.0 - 830251.0 * N6 / 7257600.0,
+  4583.0 * N5 / 161280.0 - 108847.0 * N6 / 3991680.0,
+  20648693.0 * N6 / 638668800.0,
+};
+
+// Latitude conforme -> géodésique: phi = chi + somme delta_j sin(2j chi)
+static constexpr double DELTA[6] = {
+  2.0 * N1 - 2.0 * N2 / 3.0 - 2.0 * N3 + 116.0 * N4 / 45.0 + 26.0 * N5 / 45.0 - 2854.0 * N6 / 675.0,
+  7.0 * N2 / 3.0 - 8.0 * N3 / 5.0 - 227.0 * N4 / 45.0 + 2704.0 * N5 / 315.0 + 2323.0 * N6 / 945.0,
+  56.0 * N3 / 15.0 - 136.0 * N4 / 35.0 - 1262.0 * N5 / 105.0 + 73814.0 * N6 / 2835.0,
+  4279.0 * N4 / 630.0 - 332.0 * N5 / 35.0 - 399572.0 * N6 / 14175.0,
+  4174.0 * N5 / 315.0 - 144838.0 * N6 / 6237.0,
+  601676.0 * N6 / 22275.0,
+};
+
+static inline double deg2rad(double d){ return d * DEG; }
+static inline double rad2deg(double r){ return r / DEG; }
+static inline double centralMeridianDeg(int zone) { return (zone - 1) * 6 - 180 + 3; }
+
+// Somme des termes c_j {sin(2jx)cosh(2jy), cos(2jx)sinh(2jy)}, j = 1..6,
+// à partir de sin(2x), cos(2x) et exp(2y) (multiples par récurrence)
+static void krugerSums(const double* c, double s2, double c2, double e2y, double& sx, double& sy) {
+  double sh2 = 0.5 * (e2y - 1.0 / e2y), ch2 = 0.5 * (e2y + 1.0 / e2y);
+  double sj = s2, cj = c2, shj = sh2, chj = ch2;
+  sx = 0.0; sy = 0.0;
+  for (int j = 0; j < 6; ++j) {
+    sx += c[j] * sj * chj;
+    sy += c[j] * cj * shj;
+    double sn = sj * c2 + cj * s2, cn = cj * c2 - sj * s2;
+    double shn = shj * ch2 + chj * sh2, chn = chj * ch2 + shj * sh2;
+    sj = sn; cj = cn; shj = shn; chj = chn;
+  }
+}
 
-static const double WGS84_A = 6378137.0;
-static const double WGS84_F = 1.0 / 298.257223563;
-static const double WGS84_E2 = WGS84_F * (2.0 - WGS84_F);
-static const double K0 = 0.9996;
+// sinh(e atanh(e sinφ)) par série (e² sin²φ < 0,007: 5 termes suffisent au double)
+static inline double sigmaOf(double s) {
+  double q = ECC * ECC * s * s;
+  double u = ECC * ECC * s * (1.0 + q * (1.0 / 3.0 + q * (1.0 / 5.0 + q * (1.0 / 7.0 + q / 9.0))));
+  double u2 = u * u;
+  return u * (1.0 + u2 * (1.0 / 6.0 + u2 / 120.0));
+}
 
-static inline double deg2rad(double d){ return d * (M_PI/180.0); }
-static inline double rad2deg(double r){ return r * (180.0/M_PI); }
+static void forwardTm(double lat, double dLon, double& x, double& y) {
+  double s = sin(lat), c = cos(lat);
+  double sl = sin(dLon), cl = cos(dLon);
+  // tan de la latitude conforme: τ' = τ sqrt(1+σ²) - σ sqrt(1+τ²)
+  double sig = sigmaOf(s);
+  double t = (s * sqrt(1.0 + sig * sig) - sig) / c;
+  // ξ' = atan2(t, cos λ), η' = atanh(sin λ / sqrt(1+t²)); multiples de 2ξ', 2η' sans trigonométrie
+  double r2 = t * t + cl * cl;
+  double q = sl / sqrt(1.0 + t * t);
+  double e2y = (1.0 + q) / (1.0 - q);
+  double xi = atan2(t, cl);
+  double eta = 0.5 * log(e2y);
+  double sx, sy;
+  krugerSums(ALPHA, 2.0 * t * cl / r2, (cl * cl - t * t) / r2, e2y, sx, sy);
+  x = K0A * (eta + sy);
+  y = K0A * (xi + sx);
+}
 
-bool wgs84ToUtm(double latDeg, double lonDeg, int& zone, bool& northHemisphere, double& easting, double& northing) {
+static void inverseTm(double x, double y, double& lat, double& dLon) {
+  double xi = y / K0A, eta = x / K0A;
+  double sx, sy;
+  krugerSums(BETA, sin(2.0 * xi), cos(2.0 * xi), exp(2.0 * eta), sx, sy);
+  double xp = xi - sx, ep = eta - sy;
+  double ee = exp(ep);
+  double shEp = 0.5 * (ee - 1.0 / ee), chEp = 0.5 * (ee + 1.0 / ee);
+  double sxp = sin(xp), cxp = cos(xp);
+  double sChi = sxp / chEp;
+  double cChi = sqrt(1.0 - sChi * sChi);
+  double chi = asin(sChi);
+  dLon = atan2(shEp, cxp);
+  double s2 = 2.0 * sChi * cChi, c2 = 1.0 - 2.0 * sChi * sChi;
+  double sj = s2, cj = c2, sum = 0.0;
+  for (int j = 0; j < 6; ++j) {
+    sum += DELTA[j] * sj;
+    double sn = sj * c2 + cj * s2;
+    cj = cj * c2 - sj * s2;
+    sj = sn;
+  }
+  lat = chi + sum;
+}
+
+static bool validLatLon(double latDeg, double lonDeg) {
   if (!isfinite(latDeg) || !isfinite(lonDeg)) return false;
-  if (lonDeg < -180.0 || lonDeg > 180.0 || latDeg < -80.0 || latDeg > 84.0) return false; // plages UTM
-  zone = (int)floor((lonDeg + 180.0) / 6.0) + 1;
-  if (zone < 1) zone = 1; if (zone > 60) zone = 60;
+  return !(lonDeg < -180.0 || lonDeg > 180.0 || latDeg < -80.0 || latDeg > 84.0); // plages UTM
+}
+
+static int zoneOf(double lonDeg) {
+  int zone = (int)floor((lonDeg + 180.0) / 6.0) + 1;
+  if (zone < 1) zone = 1;
+  if (zone > 60) zone = 60;
+  return zone;
+}
 
+bool wgs84ToUtm(double latDeg, double lonDeg, int& zone, bool& northHemisphere, double& easting, double& northing) {
+  if (!validLatLon(latDeg, lonDeg)) return false;
+  zone = zoneOf(lonDeg);
   northHemisphere = (latDeg >= 0.0);
-  double lat = deg2rad(latDeg);
-  double lon = deg2rad(lonDeg);
-  double lon0 = deg2rad((zone - 1) * 6 - 180 + 3); // méridien central
-
-  double e2 = WGS84_E2;
-  double ep2 = e2 / (1.0 - e2);
-  double sinLat = sin(lat), cosLat = cos(lat), tanLat = tan(lat);
-  double N = WGS84_A / sqrt(1.0 - e2 * sinLat * sinLat);
-  double T = tanLat * tanLat;
-  double C = ep2 * cosLat * cosLat;
-  double A = (lon - lon0) * cosLat;
-
-  double M = WGS84_A * ((1 - e2/4 - 3*e2*e2/64 - 5*e2*e2*e2/256) * lat
-    - (3*e2/8 + 3*e2*e2/32 + 45*e2*e2*e2/1024) * sin(2*lat)
-    + (15*e2*e2/256 + 45*e2*e2*e2/1024) * sin(4*lat)
-    - (35*e2*e2*e2/3072) * sin(6*lat));
-
-  double x = K0 * N * (A + (1 - T + C) * A*A*A / 6.0 + (5 - 18*T + T*T + 72*C - 58*ep2) * A*A*A*A*A / 120.0) + 500000.0;
-  double y = K0 * (M + N * tanLat * (A*A/2.0 + (5 - T + 9*C + 4*C*C) * A*A*A*A / 24.0 + (61 - 58*T + T*T + 600*C - 330*ep2) * A*A*A*A*A*A / 720.0));
-
-  if (!northHemisphere) y += 10000000.0; // offset Sud
-  easting = x; northing = y;
+  double x, y;
+  forwardTm(deg2rad(latDeg), deg2rad(lonDeg - centralMeridianDeg(zone)), x, y);
+  easting = x + FALSE_EASTING;
+  northing = northHemisphere ? y : y + FALSE_NORTHING_S; // offset Sud
   return true;
 }
 
 bool utmToWgs84(int zone, bool northHemisphere, double easting, double northing, double& latDeg, double& lonDeg) {
-  if (zone < 1 || zone > 60) return false;
-  double x = easting - 500000.0;
-  double y = northing;
-  if (!northHemisphere) y -= 10000000.0;
-
-  double e2 = WGS84_E2;
-  double ep2 = e2 / (1.0 - e2);
-  double lon0 = deg2rad((zone - 1) * 6 - 180 + 3);
-
-  double M = y / K0;
-  double mu = M / (WGS84_A * (1 - e2/4 - 3*e2*e2/64 - 5*e2*e2*e2/256));
-  double e1 = (1 - sqrt(1 - e2)) / (1 + sqrt(1 - e2));
-  double J1 = (3*e1/2 - 27*e1*e1*e1/32);
-  double J2 = (21*e1*e1/16 - 55*e1*e1*e1*e1/32);
-  double J3 = (151*e1*e1*e1/96);
-  double J4 = (1097*e1*e1*e1*e1/512);
-  double fp = mu + J1*sin(2*mu) + J2*sin(4*mu) + J3*sin(6*mu) + J4*sin(8*mu);
-
-  double sinfp = sin(fp), cosfp = cos(fp), tanfp = tan(fp);
-  double C1 = ep2 * cosfp * cosfp;
-  double T1 = tanfp * tanfp;
-  double N1 = WGS84_A / sqrt(1 - e2 * sinfp * sinfp);
-  double R1 = N1 * (1 - e2) / (1 - e2 * sinfp * sinfp);
-  double D = x / (N1 * K0);
-
-  double lat = fp - (N1 * tanfp / R1) * (D*D/2.0 - (5 + 3*T1 + 10*C1 - 4*C1*C1 - 9*ep2) * D*D*D*D/24.0 + (61 + 90*T1 + 298*C1 + 45*T1*T1 - 252*ep2 - 3*C1*C1) * D*D*D*D*D*D/720.0);
-  double lon = lon0 + (D - (1 + 2*T1 + C1) * D*D*D/6.0 + (5 - 2*C1 + 28*T1 - 3*C1*C1 + 8*ep2 + 24*T1*T1) * D*D*D*D*D/120.0) / cosfp;
-
+  if (zone < 1 || zone > 60 || !isfinite(easting) || !isfinite(northing)) return false;
+  double y = northHemisphere ? northing : northing - FALSE_NORTHING_S;
+  double lat, dLon;
+  inverseTm(easting - FALSE_EASTING, y, lat, dLon);
   latDeg = rad2deg(lat);
-  lonDeg = rad2deg(lon);
+  lonDeg = centralMeridianDeg(zone) + rad2deg(dLon);
   return true;
 }
 
+size_t wgs84ToUtmBatch(const GeoPoint* in, UtmCoord* out, size_t count, int zone, int hemisphere) {
+  size_t ok = 0;
+  for (size_t i = 0; i < count; ++i) {
+    UtmCoord& u = out[i];
+    double latDeg = in[i].latDeg, lonDeg = in[i].lonDeg;
+    u.zone = zone;
+    if (!validLatLon(latDeg, lonDeg) || zone < 0 || zone > 60) {
+      u.easting = NAN; u.northing = NAN; u.northHemisphere = true;
+      continue;
+    }
+    if (zone == 0) u.zone = zoneOf(lonDeg);
+    double dLon = lonDeg - centralMeridianDeg(u.zone);
+    if (dLon > 180.0) dLon -= 360.0; else if (dLon < -180.0) dLon += 360.0;
+    u.northHemisphere = hemisphere ? (hemisphere > 0) : (latDeg >= 0.0);
+    double x, y;
+    forwardTm(deg2rad(latDeg), deg2rad(dLon), x, y);
+    u.easting = x + FALSE_EASTING;
+    u.northing = u.northHemisphere ? y : y + FALSE_NORTHING_S;
+    ok++;
+  }
+  return ok;
+}
 
-
-
-
-
+size_t utmToWgs84Batch(const UtmCoord* in, GeoPoint* out, size_t count) {
+  size_t ok = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (utmToWgs84(in[i].zone, in[i].northHemisphere, in[i].easting, in[i].northing, out[i].latDeg, out[i].lonDeg)) {
+      ok++;
+    } else {
+      out[i].latDeg = NAN; out[i].lonDeg = NAN;
+    }
+  }
+  return ok;
+}
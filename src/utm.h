@@ -1,5 +1,8 @@
 #pragma once
-#include <Arduino.h>
+#include <math.h>
+#include <stddef.h>
+
+// Module sans dépendance Arduino
 
 struct UtmCoord {
   int zone;
@@ -8,14 +11,22 @@ struct UtmCoord {
   double northing;
 };
 
+struct GeoPoint {
+  double latDeg;
+  double lonDeg;
+};
+
 // Convertit WGS84 (lat/lon en degrés) vers UTM (auto-zone)
 bool wgs84ToUtm(double latDeg, double lonDeg, int& zone, bool& northHemisphere, double& easting, double& northing);
 
 // Convertit UTM -> WGS84 (lat/lon en degrés)
 bool utmToWgs84(int zone, bool northHemisphere, double easting, double northing, double& latDeg, double& lonDeg);
 
-
-
-
-
-
+// Conversion par lots (export de trace, historique). zone = 0: fuseau de chaque point,
+// sinon fuseau imposé à tout le lot (coordonnées continues sur une trace à cheval).
+// hemisphere = 0: hémisphère de chaque point; > 0 nord, < 0 sud imposé à tout le lot
+// (même fausse ordonnée pour tous les points d'une trace qui traverse l'équateur).
+// Points invalides: easting/northing NAN. Retourne le nombre de points convertis.
+size_t wgs84ToUtmBatch(const GeoPoint* in, UtmCoord* out, size_t count, int zone = 0, int hemisphere = 0);
+// Points invalides: lat/lon NAN. Retourne le nombre de points convertis.
+size_t utmToWgs84Batch(const UtmCoord* in, GeoPoint* out, size_t count);
@@ -0,0 +1,68 @@
+#include "vessel_geometry.h"
+#include <math.h>
+
+static const float DEG2RAD = (float)(M_PI / 180.0);
+
+void vesselGeometryDefaults(VesselGeometry& g) {
+  g.antX = g.antY = g.antZ = 0.0f;
+  g.headX = g.headY = g.headZ = 0.0f;
+  g.mountPitchDeg = 0.0f;
+  g.mountRollDeg = 0.0f;
+  g.attitude = true;
+}
+
+void vesselMountPrepare(const VesselGeometry& g, VesselMount& m) {
+  m.lever[0] = g.headX - g.antX;
+  m.lever[1] = g.headY - g.antY;
+  m.lever[2] = g.headZ - g.antZ;
+  // Rotation tête -> bateau Ry(tangage) Rx(roulis), par colonnes
+  float sp = sinf(g.mountPitchDeg * DEG2RAD), cp = cosf(g.mountPitchDeg * DEG2RAD);
+  float sr = sinf(g.mountRollDeg * DEG2RAD), cr = cosf(g.mountRollDeg * DEG2RAD);
+  m.axisX[0] = cp;   m.axisX[1] = 0.0f; m.axisX[2] = -sp;
+  m.axisY[0] = sp * sr; m.axisY[1] = cr; m.axisY[2] = cp * sr;
+  m.axisZ[0] = sp * cr; m.axisZ[1] = -sr; m.axisZ[2] = cp * cr;
+  m.attitude = g.attitude;
+  m.identity = !g.attitude && m.lever[0] == 0.0f && m.lever[1] == 0.0f && m.lever[2] == 0.0f &&
+               g.mountPitchDeg == 0.0f && g.mountRollDeg == 0.0f;
+}
+
+void vesselApplyPing(const VesselMount& m, float relDeg, float pitchDeg, float rollDeg, VesselPingGeom& out) {
+  float a = relDeg * DEG2RAD;
+  if (m.identity) {
+    out.fwd = 0.0f; out.stbd = 0.0f; out.relBrgRad = a;
+    return;
+  }
+  float ca = cosf(a), sa = sinf(a);
+  // Direction mesurée (plan de la tête) et axe bas de la tête, repère bateau
+  float v[3], z[3];
+  for (int i = 0; i < 3; ++i) {
+    v[i] = ca * m.axisX[i] + sa * m.axisY[i];
+    z[i] = m.axisZ[i];
+  }
+  float l0 = m.lever[0], l1 = m.lever[1], l2 = m.lever[2];
+  if (m.attitude && isfinite(pitchDeg) && isfinite(rollDeg)) {
+    // Bateau -> repère nivelé aligné sur le cap: Ry(tangage) Rx(roulis)
+    float sp = sinf(pitchDeg * DEG2RAD), cp = cosf(pitchDeg * DEG2RAD);
+    float sr = sinf(rollDeg * DEG2RAD), cr = cosf(rollDeg * DEG2RAD);
+    const float R[3][3] = {{cp, sp * sr, sp * cr}, {0.0f, cr, -sr}, {-sp, cp * sr, cp * cr}};
+    float tv[3], tz[3];
+    for (int i = 0; i < 3; ++i) {
+      tv[i] = R[i][0] * v[0] + R[i][1] * v[1] + R[i][2] * v[2];
+      tz[i] = R[i][0] * z[0] + R[i][1] * z[1] + R[i][2] * z[2];
+    }
+    for (int i = 0; i < 3; ++i) { v[i] = tv[i]; z[i] = tz[i]; }
+    out.fwd = R[0][0] * l0 + R[0][1] * l1 + R[0][2] * l2;
+    out.stbd = R[1][1] * l1 + R[1][2] * l2;
+  } else {
+    out.fwd = l0;
+    out.stbd = l1;
+  }
+  // Rayon horizontal du plan (v, axe bas de la tête): v - (v_z / z_z) z
+  float h0 = v[0], h1 = v[1];
+  if (fabsf(z[2]) > 0.1f) {
+    float k = v[2] / z[2];
+    h0 -= k * z[0];
+    h1 -= k * z[1];
+  }
+  out.relBrgRad = (h0 * h0 + h1 * h1 > 1e-12f) ? atan2f(h1, h0) : a;
+}
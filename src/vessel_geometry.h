@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+
+// Géométrie du bateau: bras de levier antenne GNSS -> tête SEAKER et
+// inclinaison de montage de la tête, compensées de l'attitude (tangage/roulis
+// PSTI036/PASHR) à chaque ping.
+// Repère bateau: x vers l'avant, y vers tribord, z vers le bas (m).
+// Attitude: tangage positif étrave haute, roulis positif tribord bas
+// (rotation cap-tangage-roulis, convention aéronautique).
+// Le désalignement en cap de la tête reste l'offset angulaire SEAKER
+// (gSeakerAngleOffsetDeg), appliqué à l'angle mesuré avant ce calcul.
+//
+// La rotation de montage et le bras de levier sont précalculés une fois
+// (vesselMountPrepare); par ping il reste 3 sin/cos (angle mesuré, tangage,
+// roulis), une trentaine de multiplications-additions et un atan2 (1 sin/cos
+// sans attitude, aucun calcul si la géométrie est neutre). La tête ne mesure que
+// l'angle du rayon projeté dans son plan: sans élévation mesurée, le rayon est
+// pris horizontal (cible vers la profondeur de la tête), c'est-à-dire la
+// direction horizontale du plan vertical-tête contenant l'angle mesuré; la
+// distance reste celle du SEAKER.
+// Module sans dépendance Arduino.
+
+struct VesselGeometry {
+  float antX, antY, antZ;      // antenne GNSS (référence de la position)
+  float headX, headY, headZ;   // tête SEAKER
+  float mountPitchDeg;         // inclinaison de la tête autour de y (avant haut +)
+  float mountRollDeg;          // inclinaison de la tête autour de x (tribord bas +)
+  bool attitude;               // compensation tangage/roulis de la centrale
+};
+
+// Forme précalculée (POD, publiée vers la tâche fusion)
+struct VesselMount {
+  float lever[3];              // tête - antenne, repère bateau
+  float axisX[3];              // axes avant, tribord et bas de la tête dans le repère bateau
+  float axisY[3];
+  float axisZ[3];
+  bool attitude;
+  bool identity;               // tête à l'antenne, montage à plat, sans attitude: calcul sauté
+};
+
+// Résultat pour un ping, dans le repère horizontal aligné sur le cap
+struct VesselPingGeom {
+  float fwd;                   // décalage horizontal de la tête (m), avant
+  float stbd;                  // idem, tribord
+  float relBrgRad;             // gisement horizontal du rayon par rapport au cap
+};
+
+void vesselGeometryDefaults(VesselGeometry& g);
+void vesselMountPrepare(const VesselGeometry& g, VesselMount& m);
+
+// relDeg: angle mesuré (après inversion/offset), pitchDeg/rollDeg NAN si inconnus (plat)
+void vesselApplyPing(const VesselMount& m, float relDeg, float pitchDeg, float rollDeg, VesselPingGeom& out);
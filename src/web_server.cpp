@@ -13,6 +13,12 @@
 #include "log_iface.h"
 #include "runtime_config.h"
 #include "demo_sim.h"
+#include "time_base.h"
+#include "svp_table.h"
+#include "nmea_writer.h"
+#include "ws_publisher.h"
+#include "target_fusion.h"
+#include "target_filter.h"
 
 // Helpers JSON: nombre ou null si non-fini
 static inline String jsonNum(double v, int decimals){
@@ -20,12 +26,20 @@ static inline String jsonNum(double v, int decimals){
 }
 
 // Types from main.cpp
-enum SeakerMode { SEAKER_NORMAL, SEAKER_OFFSET, SEAKER_TRANSPONDER };
 extern String gNtripHost; extern uint16_t gNtripPort; extern String gNtripMount; extern volatile bool gNtripEnabled; extern volatile unsigned long gRtcmLastMs; 
 
 static WebServer server(80);
 static WebSocketsServer ws(81);
 
+// Protocole par client WebSocket (un bit par numéro de client): texte JSON par
+// défaut, binaire (ws_binary) après {"cmd":"proto","bin":1}. Modifié et lu dans loop uniquement
+static_assert(WEBSOCKETS_SERVER_CLIENT_MAX <= 32, "masque de clients WebSocket");
+static_assert(NMEA_WS_HEADROOM == WEBSOCKETS_MAX_HEADER_SIZE, "réserve d'en-tête WebSocket");
+static uint32_t wsClients = 0;
+static uint32_t wsBinClients = 0;
+static uint32_t wsNmeaBinClients = 0;   // binaire + lignes NMEA ("nmea":1)
+static uint32_t wsNewClients = 0;       // état complet à envoyer (connexion, changement de protocole)
+
 static bool gFsReady = false;
 
 static void handleRoot(){
@@ -60,7 +74,7 @@ extern const char* FIRMWARE_VERSION;
 extern const char* BUILD_DATE;
 
 static void handleApiTelemetry(){
-  GpsFix f = gpsGetFix();
+  GpsFix f; gpsReadFix(f);
   String json = "{";
   
   // Version firmware
@@ -74,6 +88,15 @@ static void handleApiTelemetry(){
             ",\"hdg\":" + jsonNum(hdg,1) +
             ",\"sats\":" + String((unsigned)f.satellites) +
             ",\"hdop\":" + jsonNum(f.hdop,1);
+    // Époque publiée: heure UTC, âge depuis réception et contenu (GPS_EPOCH_*)
+    json += ",\"utc_ms\":" + (f.utcMs >= 0 ? String((long)f.utcMs) : String("null")) +
+            ",\"age_ms\":" + (f.rxMs ? String((unsigned long)(millis() - f.rxMs)) : String("null")) +
+            ",\"epoch\":" + String((unsigned)f.epochMask);
+    // RTK (PSTI030): âge des corrections, ratio AR, vitesse ENU
+    json += ",\"rtk_age\":" + jsonNum(f.rtkAgeS,1) + ",\"rtk_ratio\":" + jsonNum(f.rtkRatio,1) +
+            ",\"vel_enu\":[" + jsonNum(f.velE,2) + "," + jsonNum(f.velN,2) + "," + jsonNum(f.velU,2) + "]";
+    // Attitude (PSTI036/PASHR): tangage, roulis en degrés
+    json += ",\"att\":[" + jsonNum(f.pitchDeg,1) + "," + jsonNum(f.rollDeg,1) + "]";
   }
   // Ajouter la vitesse en noeuds si disponible
   if (isfinite(f.speedKnots)) { json += ",\"speed_kn\":" + String(f.speedKnots,2); }
@@ -89,7 +112,7 @@ static void handleApiTelemetry(){
   }
   json += "},";
   // SEAKER with nulls for non-finite
-  json += "\"seaker\":{\"status\":\"" + gSeaker.lastStatus + "\",\"angle\":";
+  json += "\"seaker\":{\"status\":\"" + String(gSeaker.lastStatus) + "\",\"angle\":";
   if (isfinite(gSeaker.lastAngle)) json += String(gSeaker.lastAngle,1); else json += "null";
   json += ",\"dist\":";
   if (isfinite(gSeaker.lastDistance)) json += String(gSeaker.lastDistance,1); else json += "null";
@@ -97,7 +120,19 @@ static void handleApiTelemetry(){
   if (isfinite(gSeaker.rxFrequency)) json += String(gSeaker.rxFrequency,1); else json += "null";
   // Ajouter statistiques TAT
   json += ",\"tat\":{\"acc2s\":" + String((unsigned long)gSeaker.tatAcc2s) + ",\"rej2s\":" + String((unsigned long)gSeaker.tatRej2s) + ",\"accTot\":" + String((unsigned long)gSeaker.acceptedPings) + ",\"rejTot\":" + String((unsigned long)gSeaker.rejectedTat) + ",\"enabled\":" + String(gTatFilterEnabled?1:0) + "}";
+  SeakerQueueStats sq = seakerGetQueueStats();
+  json += ",\"queue\":{\"enq\":" + String((unsigned long)sq.enqueued) + ",\"done\":" + String((unsigned long)sq.consumed) + ",\"ovf\":" + String((unsigned long)sq.overflow) + "}";
   json += "},";
+  {
+    TargetFusionStats fs = targetFusionGetStats();
+    json += "\"fusion\":{\"mode\":\"" + String(targetMeasModeName(gKalmanMeasMode)) + "\",\"imm\":{\"on\":" + String(gKalmanImm?"true":"false") + ",\"mu\":[" + String(fs.immMu[0],3) + "," + String(fs.immMu[1],3) + "," + String(fs.immMu[2],3) + "]}" +
+            ",\"smooth_lag\":" + String((unsigned)gKalmanSmoothLag) + ",\"smoothed\":" + String((unsigned long)fs.smoothed) +
+            ",\"tracks\":" + String((unsigned long)fs.tracks) + ",\"evicted\":" + String((unsigned long)fs.evicted) + ",\"beacon\":" + String((unsigned)seakerActiveBeacon()) + ",\"pings\":" + String((unsigned long)fs.pings) + ",\"no_pose\":" + String((unsigned long)fs.noPose) +
+            ",\"gated\":" + String((unsigned long)fs.gated) + ",\"held\":" + String((unsigned long)fs.held) +
+            ",\"out_ovf\":" + String((unsigned long)fs.outOverflow) +
+            ",\"lat_us\":{\"last\":" + String((unsigned long)fs.fusion.lastUs) + ",\"mean\":" + String((unsigned long)fs.fusion.meanUs) + ",\"max\":" + String((unsigned long)fs.fusion.maxUs) + "}" +
+            ",\"sink_us\":{\"last\":" + String((unsigned long)fs.sink.lastUs) + ",\"mean\":" + String((unsigned long)fs.sink.meanUs) + ",\"max\":" + String((unsigned long)fs.sink.maxUs) + "}},";
+  }
   {
     float v=0,i=0; if (readPower(v,i)) {
       json += "\"power\":{\"voltage\":" + String(v,2) + ",\"current_mA\":" + String(i,0) + "},";
@@ -106,14 +141,58 @@ static void handleApiTelemetry(){
   // NTRIP
   unsigned long now=millis(); bool streaming = (gRtcmLastMs!=0) && (now - gRtcmLastMs < 5000);
   json += "\"ntrip\":{\"enabled\":" + String(gNtripEnabled?1:0) + ",\"host\":\"" + gNtripHost + "\",\"port\":" + String((unsigned)gNtripPort) + ",\"mount\":\"" + gNtripMount + "\",\"streaming\":" + String(streaming?1:0) + "}";
+  // Satellites par constellation (GSV/GSA): en vue, suivis, utilisés, SNR moyen/max (dB-Hz)
+  {
+    GnssSatSummary ss; gpsReadSatSummary(ss);
+    json += ",\"gnss\":{";
+    for (int c=0;c<GNSS_CONST_COUNT;c++){
+      const GnssConstSummary& cs = ss.c[c];
+      if (c) json += ",";
+      json += "\"" + String(gnssConstName((GnssConst)c)) + "\":{\"view\":" + String((unsigned)cs.inView) + ",\"trk\":" + String((unsigned)cs.tracked) +
+              ",\"used\":" + String((unsigned)cs.used) + ",\"snr\":" + String((unsigned)cs.snrMean) + ",\"snr_max\":" + String((unsigned)cs.snrMax) + "}";
+    }
+    json += "}";
+  }
+  // Compteurs de dispatch NMEA GPS par type
+  {
+    GpsSentenceStat st[16]; int ns = gpsGetSentenceStats(st, 16);
+    NmeaDispatchTotals tot = gpsGetDispatchTotals();
+    json += ",\"nmea\":{\"types\":{";
+    for (int i=0;i<ns;i++){
+      if (i) json += ",";
+      json += "\"" + String(st[i].name) + "\":{\"hit\":" + String((unsigned long)st[i].stats.hits) + ",\"miss\":" + String((unsigned long)st[i].stats.misses) + ",\"cks\":" + String((unsigned long)st[i].stats.cksFail) + "}";
+    }
+    json += "},\"ignored\":" + String((unsigned long)tot.ignored) + ",\"cks_unknown\":" + String((unsigned long)tot.cksUnknown) + ",\"not_nmea\":" + String((unsigned long)tot.notNmea) + "}";
+    GpsUartStats us = gpsGetUartStats();
+    json += ",\"gps_uart\":{\"lines\":" + String((unsigned long)us.lines) + ",\"bytes\":" + String((unsigned long)us.bytes) +
+            ",\"fifo_ovf\":" + String((unsigned long)us.fifoOvf) + ",\"buf_full\":" + String((unsigned long)us.bufferFull) +
+            ",\"frame_err\":" + String((unsigned long)us.frameErr) + ",\"parity_err\":" + String((unsigned long)us.parityErr) +
+            ",\"pattern_ovf\":" + String((unsigned long)us.patternOvf) + ",\"long_lines\":" + String((unsigned long)us.longLines) +
+            ",\"epochs\":" + String((unsigned long)us.epochs) +
+            ",\"mode\":\"" + String(gpsGetBinaryMode() ? "bin" : "nmea") + "\"" +
+            ",\"bin\":{\"frames\":" + String((unsigned long)us.binFrames) + ",\"cks_err\":" + String((unsigned long)us.binCksErr) +
+            ",\"bad\":" + String((unsigned long)us.binBadFrame) + ",\"ack\":" + String((unsigned long)us.binAck) +
+            ",\"nack\":" + String((unsigned long)us.binNack) + "}}";
+    GpsPoseStats ps = gpsGetPoseStats();
+    json += ",\"pose\":{\"n\":" + String((unsigned long)ps.samples) + ",\"interp\":" + String((unsigned long)ps.lookups[POSE_INTERP]) +
+            ",\"extrap\":" + String((unsigned long)ps.lookups[POSE_EXTRAP]) + ",\"miss\":" + String((unsigned long)ps.lookups[POSE_NONE]) + "}";
+    TimeBaseStats tb = timeBaseGetStats();
+    const char* sync = tb.state == TIME_SYNC_PPS ? "pps" : (tb.state == TIME_SYNC_NMEA ? "nmea" : "none");
+    json += ",\"time\":{\"sync\":\"" + String(sync) + "\",\"pps\":" + String((unsigned long)tb.ppsCount) +
+            ",\"pps_age_ms\":" + (tb.ppsCount ? String((unsigned long)tb.ppsAgeMs) : String("null")) +
+            ",\"drift_ppb\":" + String((long)tb.driftPpb) + ",\"resid_us\":" + String((long)tb.residualUs) +
+            ",\"rejected\":" + String((unsigned long)tb.ppsRejected) + "}";
+  }
   // TargetF
   if (!isnan(gTargetFLat) && !isnan(gTargetFLon) && !isnan(gTargetFR95)) {
-    json += ",\"targetf\":{\"lat\":" + jsonNum(gTargetFLat,7) + ",\"lon\":" + jsonNum(gTargetFLon,7) + ",\"r95_m\":" + jsonNum(gTargetFR95,2);
+    json += ",\"targetf\":{\"lat\":" + jsonNum(gTargetFLat,7) + ",\"lon\":" + jsonNum(gTargetFLon,7) + ",\"r95_m\":" + jsonNum(gTargetFR95,2) + ",\"id\":" + String((unsigned)gTargetFId);
     int tz; bool tnh; double te,tn; if (wgs84ToUtm(gTargetFLat,gTargetFLon,tz,tnh,te,tn)) {
       json += ",\"utm\":{\"zone\":" + String(tz) + ",\"north\":" + String(tnh?1:0) + ",\"e\":" + String(te,2) + ",\"n\":" + String(tn,2) + "}";
     }
     json += "}";
   }
+  // Pistes par balise (dernière position filtrée de chacune)
+  json += ",\"targets\":" + telemetryTargetsJson();
   // IP locale, WiFi & version
   json += ",\"ip\":\"" + WiFi.localIP().toString() + "\"";
   
@@ -214,9 +293,179 @@ void webSetup(){
       server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Missing enabled parameter\"}");
     }
   });
+  // Géométrie du bateau: bras de levier antenne -> tête SEAKER (m, x avant, y tribord, z bas),
+  // inclinaison de montage de la tête (deg), compensation tangage/roulis
+  server.on("/api/vessel", HTTP_GET, [](){
+    const VesselGeometry& g = gVessel;
+    String j = String("{\"ant\":[") + String(g.antX,3) + "," + String(g.antY,3) + "," + String(g.antZ,3) + "]" +
+               ",\"head\":[" + String(g.headX,3) + "," + String(g.headY,3) + "," + String(g.headZ,3) + "]" +
+               ",\"mount_pitch\":" + String(g.mountPitchDeg,2) + ",\"mount_roll\":" + String(g.mountRollDeg,2) +
+               ",\"attitude\":" + String(g.attitude?"true":"false") + "}";
+    server.send(200, "application/json", j);
+  });
+  server.on("/api/vessel", HTTP_POST, [](){
+    VesselGeometry g = gVessel;
+    struct { const char* key; float* v; float lim; } fields[] = {
+      {"ant_x", &g.antX, 50.0f}, {"ant_y", &g.antY, 50.0f}, {"ant_z", &g.antZ, 50.0f},
+      {"head_x", &g.headX, 50.0f}, {"head_y", &g.headY, 50.0f}, {"head_z", &g.headZ, 50.0f},
+      {"mount_pitch", &g.mountPitchDeg, 45.0f}, {"mount_roll", &g.mountRollDeg, 45.0f},
+    };
+    for (auto& fd : fields) {
+      if (!server.hasArg(fd.key)) continue;
+      float v = server.arg(fd.key).toFloat();
+      if (!isfinite(v) || fabsf(v) > fd.lim) {
+        server.send(400, "application/json", String("{\"status\":\"error\",\"message\":\"Invalid ") + fd.key + "\"}");
+        return;
+      }
+      *fd.v = v;
+    }
+    if (server.hasArg("attitude")) { String a = server.arg("attitude"); g.attitude = (a == "true" || a == "1"); }
+    gVessel = g;
+    saveVesselPrefs();
+    targetFusionSetVessel(gVessel);
+    server.send(200, "application/json", "{\"status\":\"ok\"}");
+  });
+  // Profil de célérité (réfraction): état, profil chargé, réglages
+  server.on("/api/svp", HTTP_GET, [](){
+    SvpStatus st = svpGetStatus();
+    SoundProfile p;
+    svpGetProfile(p);
+    String j = String("{\"enabled\":") + String(gSvpEnabled?"true":"false") +
+               ",\"ready\":" + String(st.ready?"true":"false") + ",\"building\":" + String(st.building?"true":"false") +
+               ",\"head_depth\":" + String(st.headDepth,2) + ",\"beacon_depth\":" + jsonNum(gSvpBeaconDepth,2) +
+               ",\"c_mean\":" + jsonNum(st.cMean,1) + ",\"build_ms\":" + String(st.buildMs) + ",\"builds\":" + String(st.builds) +
+               ",\"grid\":[" + String(SVP_RANGE_NODES) + "," + String(SVP_ANGLE_NODES) + "],\"profile\":[";
+    for (uint8_t i = 0; i < p.n; ++i) {
+      if (i) j += ",";
+      j += "[" + String(p.depth[i],2) + "," + String(p.speed[i],2) + "]";
+    }
+    j += "]}";
+    server.send(200, "application/json", j);
+  });
+  server.on("/api/svp", HTTP_POST, [](){
+    bool rebuild = false;
+    if (server.hasArg("head_depth")) {
+      float v = server.arg("head_depth").toFloat();
+      if (!isfinite(v) || v < 0.0f || v > 100.0f) { server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid head_depth\"}"); return; }
+      rebuild = (v != gSvpHeadDepth);
+      gSvpHeadDepth = v;
+    }
+    if (server.hasArg("beacon_depth")) {
+      String a = server.arg("beacon_depth");
+      float v = (a.length() == 0 || a == "null") ? NAN : a.toFloat();
+      if (isfinite(v) && (v < 0.0f || v > 2000.0f)) { server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid beacon_depth\"}"); return; }
+      gSvpBeaconDepth = v;
+    }
+    if (server.hasArg("enabled")) { String a = server.arg("enabled"); gSvpEnabled = (a == "true" || a == "1"); }
+    saveSvpPrefs();
+    if (server.hasArg("clear") && server.arg("clear") == "1") svpClearProfile();
+    else if (rebuild) svpRequestRebuild();
+    server.send(200, "application/json", "{\"status\":\"ok\"}");
+  });
+  // Nouveau profil: corps CSV "profondeur,célérité" (text/csv ou text/plain), écrit dans /svp.csv
+  server.on("/api/svp/profile", HTTP_POST, [](){
+    if (!server.hasArg("plain")) { server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Missing CSV body\"}"); return; }
+    const String& body = server.arg("plain");
+    if (!svpSetProfile(body.c_str(), body.length())) {
+      server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid profile\"}");
+      return;
+    }
+    server.send(200, "application/json", "{\"status\":\"ok\"}");
+  });
+  // Publication WebSocket regroupée (ws_publisher): tick et compteurs
+  server.on("/api/ws", HTTP_GET, [](){
+    WsPubStats st = wsPubGetStats();
+    String j = String("{\"tick_ms\":") + String(gWsTickMs) +
+               ",\"clients\":" + String(__builtin_popcount(wsTextClients() | wsBinaryClients())) +
+               ",\"binary\":" + String(__builtin_popcount(wsBinaryClients())) +
+               ",\"ticks\":" + String(st.ticks) + ",\"frames\":" + String(st.frames) +
+               ",\"bytes\":" + String(st.bytes) + ",\"snapshots\":" + String(st.snapshots) + "}";
+    server.send(200, "application/json", j);
+  });
+  server.on("/api/ws", HTTP_POST, [](){
+    if (!server.hasArg("tick_ms")) { server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Missing tick_ms\"}"); return; }
+    long v = server.arg("tick_ms").toInt();
+    if (v < 20 || v > 2000) { server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid tick_ms\"}"); return; }
+    gWsTickMs = (uint16_t)v;
+    saveWsPrefs();
+    server.send(200, "application/json", "{\"status\":\"ok\"}");
+  });
+  // Sortie GPS binaire SkyTraq / NMEA
+  server.on("/api/gps/mode", HTTP_GET, [](){
+    bool leapRx = false; int8_t leap = gpsGetLeapSeconds(&leapRx);
+    String j = String("{\"binary\":") + String(gGpsBinaryMode?"true":"false") + ",\"active\":\"" + String(gpsGetBinaryMode()?"bin":"nmea") + "\"" +
+               ",\"true_heading\":" + String(gpsTrueHeadingRecent()?"true":"false") +
+               ",\"rate_hz\":" + String((unsigned)gGpsRateHz) + ",\"leap_s\":" + String((int)leap) +
+               ",\"leap_rx\":" + String(leapRx?"true":"false") + "}";
+    server.send(200, "application/json", j);
+  });
+  server.on("/api/gps/mode", HTTP_POST, [](){
+    if (!server.hasArg("binary") && !server.hasArg("rate")){
+      server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Missing binary or rate parameter\"}");
+      return;
+    }
+    if (server.hasArg("rate")){
+      long hz = server.arg("rate").toInt();
+      if (hz != 0 && !gpsSetUpdateRate((uint8_t)hz)) { server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid rate (1,2,4,5,8,10,20)\"}"); return; }
+      gGpsRateHz = (uint8_t)hz;
+    }
+    if (server.hasArg("binary")){
+      String val = server.arg("binary");
+      bool en = (val == "true" || val == "1");
+      String f = server.arg("force");
+      if (!gpsSetBinaryMode(en, f == "true" || f == "1")) {
+        saveGpsPrefs();
+        server.send(409, "application/json", "{\"status\":\"error\",\"message\":\"True heading (HDT/PSTI036/PASHR) would be lost in binary 0xA8 output; use force=1\"}");
+        return;
+      }
+      gGpsBinaryMode = en;
+    }
+    saveGpsPrefs();
+    String j = String("{\"status\":\"ok\",\"binary\":") + String(gGpsBinaryMode?"true":"false") + ",\"rate_hz\":" + String((unsigned)gGpsRateHz) + "}";
+    server.send(200, "application/json", j);
+  });
+  // Trace récente du bateau (historique de pose) en UTM, conversion par lot dans le fuseau du dernier point
+  server.on("/api/gps/track", HTTP_GET, [](){
+    static PoseSample poses[POSE_HISTORY_LEN];
+    static GeoPoint geo[POSE_HISTORY_LEN];
+    static UtmCoord utm[POSE_HISTORY_LEN];
+    int want = server.hasArg("n") ? server.arg("n").toInt() : POSE_HISTORY_LEN;
+    if (want < 1 || want > POSE_HISTORY_LEN) want = POSE_HISTORY_LEN;
+    int n = gpsCopyPoseHistory(poses, want);
+    if (n == 0) { server.send(200, "application/json", "{\"zone\":null,\"pts\":[]}"); return; }
+    for (int i = 0; i < n; ++i) { geo[i].latDeg = poses[i].latitude; geo[i].lonDeg = poses[i].longitude; }
+    int zone; bool nh; double e, nn;
+    if (!wgs84ToUtm(geo[n-1].latDeg, geo[n-1].lonDeg, zone, nh, e, nn)) { server.send(200, "application/json", "{\"zone\":null,\"pts\":[]}"); return; }
+    // Fuseau et hémisphère du dernier point imposés à toute la trace: un seul "north" dans la réponse
+    wgs84ToUtmBatch(geo, utm, (size_t)n, zone, nh ? 1 : -1);
+    int64_t now = timeLocalUs();
+    String j = String("{\"zone\":") + zone + ",\"north\":" + (nh ? "true" : "false") + ",\"pts\":[";
+    for (int i = 0; i < n; ++i) {
+      if (i) j += ",";
+      j += "[" + String((long)((now - poses[i].tUs) / 1000)) + "," + jsonNum(utm[i].easting, 2) + "," + jsonNum(utm[i].northing, 2) + "," + jsonNum(poses[i].headingDeg, 1) + "]";
+    }
+    j += "]}";
+    server.send(200, "application/json", j);
+  });
+  // Historique NMEA brut, diffusé directement depuis l'anneau (chunked, sans String intermédiaire)
+  server.on("/api/gps/raw", HTTP_GET, [](){
+    int lines = server.hasArg("lines") ? server.arg("lines").toInt() : 50;
+    struct Chunk { char buf[512]; size_t len; } ck; ck.len = 0;
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "text/plain", "");
+    gpsForEachRawLine(lines, [](const char* line, size_t len, void* ctx){
+      Chunk& c = *(Chunk*)ctx;
+      if (c.len + len + 1 > sizeof(c.buf)) { if (c.len) server.sendContent(c.buf, c.len); c.len = 0; }
+      if (len + 1 > sizeof(c.buf)) return;
+      memcpy(c.buf + c.len, line, len); c.len += len;
+      c.buf[c.len++] = '\n';
+    }, &ck);
+    if (ck.len) server.sendContent(ck.buf, ck.len);
+    server.sendContent("");
+  });
   server.on("/api/targetf", [](){
     if (!isnan(gTargetFLat) && !isnan(gTargetFLon) && !isnan(gTargetFR95)){
-      String j = String("{\"lat\":") + String(gTargetFLat,7) + ",\"lon\":" + String(gTargetFLon,7) + ",\"r95_m\":" + String(gTargetFR95,2) + "}";
+      String j = String("{\"lat\":") + String(gTargetFLat,7) + ",\"lon\":" + String(gTargetFLon,7) + ",\"r95_m\":" + String(gTargetFR95,2) + ",\"id\":" + String((unsigned)gTargetFId) + "}";
       server.send(200, "application/json", j);
     } else {
       server.send(204, "application/json", "{}");
@@ -285,9 +534,6 @@ void webSetup(){
   
   // API pour configurer la correction de distance SEAKER
   server.on("/api/seaker-config", HTTP_GET, [](){
-    extern SeakerMode gSeakerMode;
-    extern float gSeakerDistOffset;
-    extern float gSeakerTransponderDelay;
     extern volatile bool gSeakerInvertAngle;
     
     String mode = "normal";
@@ -301,9 +547,6 @@ void webSetup(){
   });
   
   server.on("/api/seaker-config", HTTP_POST, [](){
-    extern SeakerMode gSeakerMode;
-    extern float gSeakerDistOffset;
-    extern float gSeakerTransponderDelay;
     extern volatile bool gSeakerInvertAngle;
     extern void saveSeakerCalibToPrefs();
     
@@ -488,6 +731,13 @@ void webSetup(){
   server.begin();
   ws.begin();
   ws.onEvent([](uint8_t c, WStype_t t, uint8_t * p, size_t l){
+    if (c < 32 && (t == WStype_CONNECTED || t == WStype_DISCONNECTED)){
+      uint32_t bit = 1UL << c;
+      if (t == WStype_CONNECTED) { wsClients |= bit; wsNewClients |= bit; }
+      else { wsClients &= ~bit; wsNewClients &= ~bit; }
+      wsBinClients &= ~bit; wsNmeaBinClients &= ~bit;
+      return;
+    }
     if (t == WStype_TEXT && p && l){
       String s; s.reserve(l); for(size_t i=0;i<l;i++) s += (char)p[i]; s.trim();
       if (s.length()==0) return;
@@ -502,6 +752,15 @@ void webSetup(){
             Serial.printf("[LogLevel] WebSocket: level changed to '%s' successfully\n", getLogLevelName().c_str());
           }
         }
+      } else if (s.indexOf("\"cmd\":\"proto\"")>=0){
+        if (c >= 32) return;
+        uint32_t bit = 1UL << c;
+        bool bin = s.indexOf("\"bin\":1")>=0 || s.indexOf("\"bin\":true")>=0;
+        bool nmea = bin && (s.indexOf("\"nmea\":1")>=0 || s.indexOf("\"nmea\":true")>=0);
+        if (bin) wsBinClients |= bit; else wsBinClients &= ~bit;
+        if (nmea) wsNmeaBinClients |= bit; else wsNmeaBinClients &= ~bit;
+        wsNewClients |= bit;
+        Serial.printf("[WS] client %u: protocole %s%s\n", (unsigned)c, bin ? "binaire" : "JSON", nmea ? " + NMEA" : "");
       } else if (s.indexOf("\"cmd\":\"seaker\"")>=0){
         int k = s.indexOf("\"nmea\":"); if (k>=0){ int q1 = s.indexOf('"', k+7); int q2 = s.indexOf('"', q1+1); if (q1>=0 && q2>q1){ String nmea = s.substring(q1+1,q2); int star = nmea.indexOf('*'); String payload = (star>0)? nmea.substring(1,star): nmea.substring(1); sendSEAKERCommand(payload); } }
       }
@@ -515,6 +774,23 @@ void webLoop(){
   ElegantOTA.loop(); // Gestion des mises à jour OTA
 }
 
-void wsBroadcastJson(String json){ ws.broadcastTXT(json); }
+uint32_t wsTextClients(){ return wsClients & ~wsBinClients; }
+uint32_t wsBinaryClients(bool nmea){ return nmea ? wsNmeaBinClients : wsBinClients; }
+uint32_t wsTakeNewClients(){ uint32_t m = wsNewClients & wsClients; wsNewClients = 0; return m; }
+bool wsWantText(){ return wsTextClients() != 0; }
+bool wsWantBinary(bool nmea){ return wsBinaryClients(nmea) != 0; }
+
+void wsBroadcastJson(String json){
+  uint32_t m = wsTextClients();
+  for (uint8_t i = 0; m; ++i, m >>= 1) if (m & 1) ws.sendTXT(i, json);
+}
+void wsSendText(uint32_t clients, char* buf, size_t len){
+  for (uint8_t i = 0; clients; ++i, clients >>= 1) if (clients & 1) ws.sendTXT(i, (uint8_t*)buf, len, true);
+}
+void wsSendBinary(uint32_t clients, uint8_t* buf, size_t len){
+  for (uint8_t i = 0; clients; ++i, clients >>= 1) if (clients & 1) ws.sendBIN(i, buf, len, true);
+}
+void wsBroadcastText(char* buf, size_t len){ wsSendText(wsTextClients(), buf, len); }
+void wsBroadcastBinary(uint8_t* buf, size_t len, bool nmea){ wsSendBinary(wsBinaryClients(nmea), buf, len); }
 
 
@@ -3,6 +3,23 @@
 
 void webSetup();
 void webLoop();
+// Clients WebSocket en JSON (défaut) / en binaire (ws_binary, {"cmd":"proto","bin":1}),
+// pour ne construire que les messages attendus (masques: un bit par numéro de client)
+uint32_t wsTextClients();
+uint32_t wsBinaryClients(bool nmea = false);
+bool wsWantText();
+bool wsWantBinary(bool nmea = false);
+// Clients connectés (ou ayant changé de protocole) depuis le dernier appel: état complet à leur envoyer
+uint32_t wsTakeNewClients();
+// Clients JSON uniquement
 void wsBroadcastJson(String json);
+// Texte déjà écrit après NMEA_WS_HEADROOM octets libres de 'buf' (en-tête WS écrit sur place, sans allocation)
+void wsBroadcastText(char* buf, size_t len);
+// Enregistrement ws_binary après NMEA_WS_HEADROOM octets libres de 'buf', aux clients binaires
+// (nmea: seulement ceux qui ont demandé les lignes NMEA)
+void wsBroadcastBinary(uint8_t* buf, size_t len, bool nmea = false);
+// Idem vers les clients du masque
+void wsSendText(uint32_t clients, char* buf, size_t len);
+void wsSendBinary(uint32_t clients, uint8_t* buf, size_t len);
 
 
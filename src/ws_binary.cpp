@@ -0,0 +1,66 @@
+#include "ws_binary.h"
+#include <math.h>
+
+static void putU16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+
+static void putI32(uint8_t* p, int32_t v) {
+  uint32_t u = (uint32_t)v;
+  p[0] = (uint8_t)u; p[1] = (uint8_t)(u >> 8); p[2] = (uint8_t)(u >> 16); p[3] = (uint8_t)(u >> 24);
+}
+
+// Degrés -> 1e-7 ° (~1 cm), INT32_MIN si absent
+static int32_t degE7(double deg) {
+  if (!isfinite(deg) || fabs(deg) > 180.0) return INT32_MIN;
+  return (int32_t)lround(deg * 1e7);
+}
+
+// Non négatif, arrondi, saturé à 0xFFFE (0xFFFF = absent)
+static uint16_t scaledU16(double v, double scale) {
+  if (!isfinite(v) || v < 0.0) return 0xFFFF;
+  double s = v * scale + 0.5;
+  return s >= 65534.0 ? 0xFFFE : (uint16_t)s;
+}
+
+size_t wsbEncodeGps(uint8_t* p, bool valid, double lat, double lon, float hdgDeg) {
+  p[0] = WSB_GPS;
+  p[1] = valid ? WSB_FLAG_VALID : 0;
+  putI32(p + 2, degE7(lat));
+  putI32(p + 6, degE7(lon));
+  putU16(p + 10, scaledU16(hdgDeg, 100.0));
+  return WSB_GPS_SIZE;
+}
+
+size_t wsbEncodeTarget(uint8_t* p, double lat, double lon, float r95, uint8_t id, bool filtered) {
+  p[0] = WSB_TARGET;
+  p[1] = filtered ? WSB_FLAG_FILTERED : 0;
+  p[2] = id;
+  p[3] = 0;
+  putU16(p + 4, scaledU16(r95, 100.0));
+  putI32(p + 6, degE7(lat));
+  putI32(p + 10, degE7(lon));
+  return WSB_TARGET_SIZE;
+}
+
+size_t wsbEncodeBeacons(uint8_t* p) {
+  p[0] = WSB_BEACONS;
+  p[1] = 0;
+  return WSB_BEACONS_SIZE;
+}
+
+size_t wsbBeaconsAdd(uint8_t* beacons, uint8_t* p, uint8_t id, uint8_t model, double lat, double lon, float r95,
+                     uint32_t ageMs) {
+  beacons[1]++;
+  p[0] = id;
+  p[1] = model;
+  putU16(p + 2, scaledU16(r95, 100.0));
+  putI32(p + 4, degE7(lat));
+  putI32(p + 8, degE7(lon));
+  putU16(p + 12, ageMs >= 0xFFFE ? 0xFFFE : (uint16_t)ageMs);
+  return WSB_BEACON_SIZE;
+}
+
+size_t wsbEncodeRssi(uint8_t* p, int rssi) {
+  p[0] = WSB_RSSI;
+  p[1] = (uint8_t)(int8_t)(rssi < -128 ? -128 : (rssi > 127 ? 127 : rssi));
+  return WSB_RSSI_SIZE;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Protocole WebSocket binaire compact (optionnel, négocié par le client avec
+// {"cmd":"proto","bin":1}): enregistrements à disposition fixe, petit-boutiens,
+// premier octet = type. Décodés par DataView dans data/index.html et map.html.
+// Une trame WS peut enchaîner plusieurs enregistrements (ws_publisher).
+//
+//  GPS     (12 o): type, flags (b0 valide), lat i32, lon i32 (1e-7 °), cap u16 (0,01 °)
+//  TARGET  (14 o): type, flags (b0 filtrée, sinon brute), id u8, 0, r95 u16 (cm), lat i32, lon i32
+//  RSSI    (2 o):  type, dBm i8
+//  NMEA    (1 o + ligne): type, "$...*CS" en ASCII jusqu'à la fin de la trame
+//          (seulement si demandé: "nmea":1)
+//  BEACONS (2 o + 14 o/balise): type, n u8, puis n fois: id u8, modèle u8 (IMM, 0xFF
+//          hors IMM), r95 u16 (cm), lat i32, lon i32, âge u16 (ms)
+// Valeurs absentes: lat/lon INT32_MIN, u16 0xFFFF (cap, r95, âge saturés à 0xFFFE).
+// Module sans dépendance Arduino.
+
+enum WsBinType : uint8_t {
+  WSB_GPS = 1,
+  WSB_TARGET = 2,
+  WSB_RSSI = 3,
+  WSB_NMEA = 4,
+  WSB_BEACONS = 5,
+};
+
+static const size_t WSB_GPS_SIZE = 12;
+static const size_t WSB_TARGET_SIZE = 14;
+static const size_t WSB_RSSI_SIZE = 2;
+static const size_t WSB_BEACONS_SIZE = 2;
+static const size_t WSB_BEACON_SIZE = 14;
+
+static const uint8_t WSB_FLAG_VALID = 0x01;
+static const uint8_t WSB_FLAG_FILTERED = 0x01;
+
+// Chaque fonction écrit en 'p' (taille *_SIZE) et retourne le nombre d'octets
+size_t wsbEncodeGps(uint8_t* p, bool valid, double lat, double lon, float hdgDeg);
+size_t wsbEncodeTarget(uint8_t* p, double lat, double lon, float r95, uint8_t id, bool filtered);
+// En-tête BEACONS, 0 balise (wsbBeaconsAdd incrémente n)
+size_t wsbEncodeBeacons(uint8_t* p);
+size_t wsbBeaconsAdd(uint8_t* beacons, uint8_t* p, uint8_t id, uint8_t model, double lat, double lon, float r95,
+                     uint32_t ageMs);
+size_t wsbEncodeRssi(uint8_t* p, int rssi);
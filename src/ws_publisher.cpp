@@ -0,0 +1,204 @@
+#include "ws_publisher.h"
+#include "web_server.h"
+#include "telemetry_state.h"
+#include "runtime_config.h"
+#include "nmea_writer.h"
+#include "ws_binary.h"
+
+enum : uint8_t {
+  WSP_GPS = 0x01,
+  WSP_RAW = 0x02,
+  WSP_TARGETF = 0x04,
+  WSP_TARGETS = 0x08,
+  WSP_RSSI = 0x10,
+};
+
+// Renvoi périodique des pistes: âges à jour, les balises muettes disparaissent de la carte
+static const uint32_t WSP_TARGETS_REFRESH_MS = 1000;
+
+struct PubTarget {
+  uint8_t id;
+  double lat;
+  double lon;
+  float r95;
+};
+
+// Positions filtrées: la dernière par balise, conservée pour l'état complet;
+// masque des cases mises à jour dans le tick (une case par bit)
+static_assert(TARGET_MAX_BEACONS <= 8, "masque filtDirty sur 8 bits");
+
+static uint8_t dirty = 0;   // changé depuis le dernier tick
+static uint8_t have = 0;    // connu (état complet)
+static bool gpsValid = false;
+static double gpsLat = NAN, gpsLon = NAN;
+static float gpsHdg = NAN;
+static PubTarget filt[TARGET_MAX_BEACONS];
+static unsigned long filtMs[TARGET_MAX_BEACONS];
+static uint8_t filtN = 0;
+static uint8_t filtDirty = 0;
+static PubTarget raw[TARGET_MAX_BEACONS];   // pings bruts du tick, le dernier par balise
+static uint8_t rawN = 0;
+static int rssiDbm = 0;
+static unsigned long lastTickMs = 0;
+static unsigned long lastTargetsMs = 0;
+static WsPubStats stats = {};
+
+// Tampons de l'état complet (loop uniquement)
+static char textBuf[NMEA_WS_HEADROOM + 160 + TARGET_MAX_BEACONS * (96 + 112 + 128)];
+static uint8_t binBuf[NMEA_WS_HEADROOM + WSB_GPS_SIZE + 2 * TARGET_MAX_BEACONS * WSB_TARGET_SIZE +
+                      WSB_BEACONS_SIZE + TARGET_MAX_BEACONS * WSB_BEACON_SIZE + WSB_RSSI_SIZE];
+
+void wsPubGps(bool valid, double lat, double lon, float hdgDeg) {
+  gpsValid = valid; gpsLat = lat; gpsLon = lon; gpsHdg = hdgDeg;
+  dirty |= WSP_GPS; have |= WSP_GPS;
+}
+
+void wsPubTargetRaw(const TargetOutput& o) {
+  uint8_t i = 0;
+  while (i < rawN && raw[i].id != o.beaconId) ++i;
+  if (i == rawN) {
+    if (rawN < TARGET_MAX_BEACONS) rawN++;
+    else i = rawN - 1;
+  }
+  raw[i].id = o.beaconId; raw[i].lat = o.lat; raw[i].lon = o.lon; raw[i].r95 = o.r95;
+  dirty |= WSP_RAW; have |= WSP_RAW;
+}
+
+void wsPubTargetFiltered(const TargetOutput& o) {
+  uint8_t i = 0;
+  while (i < filtN && filt[i].id != o.beaconId) ++i;
+  if (i == filtN) {
+    if (filtN < TARGET_MAX_BEACONS) filtN++;
+    else {
+      // Banque pleine: la balise mise à jour le moins récemment cède sa case
+      i = 0;
+      for (uint8_t k = 1; k < filtN; ++k) if ((long)(filtMs[k] - filtMs[i]) < 0) i = k;
+    }
+  }
+  filt[i].id = o.beaconId; filt[i].lat = o.lat; filt[i].lon = o.lon; filt[i].r95 = o.r95;
+  filtMs[i] = millis();
+  filtDirty |= (uint8_t)(1u << i);
+  dirty |= WSP_TARGETF | WSP_TARGETS; have |= WSP_TARGETF | WSP_TARGETS;
+}
+
+void wsPubRssi(int rssi) {
+  if ((have & WSP_RSSI) && rssi == rssiDbm) return;
+  rssiDbm = rssi;
+  dirty |= WSP_RSSI; have |= WSP_RSSI;
+}
+
+static void putTargetJson(NmeaWriter& w, const PubTarget& t) {
+  nmeaPutStr(w, "{\"lat\":"); nmeaPutFixed(w, t.lat, 7, "null");
+  nmeaPutStr(w, ",\"lon\":"); nmeaPutFixed(w, t.lon, 7, "null");
+  nmeaPutStr(w, ",\"r95_m\":"); nmeaPutFixed(w, t.r95, 2, "null");
+  nmeaPutStr(w, ",\"id\":"); nmeaPutU32(w, t.id);
+}
+
+// {"gps":{...},"raw":[...],"targetf":[...],"targets":[...],"rssi":..}, clés du masque seulement;
+// 'fmask': cases de filt[] à émettre
+static size_t buildText(uint8_t mask, uint8_t fmask) {
+  NmeaWriter w;
+  nmeaWriterInit(w, textBuf, sizeof(textBuf), NMEA_WS_HEADROOM);
+  char sep = '{';
+  if (mask & WSP_GPS) {
+    nmeaPutChar(w, sep); sep = ',';
+    nmeaPutStr(w, "\"gps\":{\"valid\":"); nmeaPutU32(w, gpsValid ? 1 : 0);
+    nmeaPutStr(w, ",\"lat\":"); nmeaPutFixed(w, gpsLat, 7, "null");
+    nmeaPutStr(w, ",\"lon\":"); nmeaPutFixed(w, gpsLon, 7, "null");
+    nmeaPutStr(w, ",\"hdg\":"); nmeaPutFixed(w, gpsHdg, 1, "null");
+    nmeaPutChar(w, '}');
+  }
+  if ((mask & WSP_RAW) && rawN) {
+    nmeaPutChar(w, sep); sep = ',';
+    nmeaPutStr(w, "\"raw\":[");
+    for (uint8_t i = 0; i < rawN; ++i) {
+      if (i) nmeaPutChar(w, ',');
+      putTargetJson(w, raw[i]);
+      nmeaPutChar(w, '}');
+    }
+    nmeaPutChar(w, ']');
+  }
+  if ((mask & WSP_TARGETF) && fmask) {
+    nmeaPutChar(w, sep); sep = ',';
+    nmeaPutStr(w, "\"targetf\":[");
+    bool first = true;
+    for (uint8_t i = 0; i < filtN; ++i) {
+      if (!(fmask & (1u << i))) continue;
+      if (!first) nmeaPutChar(w, ',');
+      first = false;
+      putTargetJson(w, filt[i]);
+      nmeaPutStr(w, ",\"filtered\":true}");
+    }
+    nmeaPutChar(w, ']');
+  }
+  if (mask & WSP_TARGETS) {
+    nmeaPutChar(w, sep); sep = ',';
+    nmeaPutStr(w, "\"targets\":");
+    telemetryTargetsJsonTo(w);
+  }
+  if (mask & WSP_RSSI) {
+    nmeaPutChar(w, sep); sep = ',';
+    nmeaPutStr(w, "\"rssi\":"); nmeaPutI32(w, rssiDbm);
+  }
+  nmeaPutChar(w, '}');
+  return nmeaTextLen(w);
+}
+
+// Mêmes éléments en enregistrements ws_binary enchaînés
+static size_t buildBinary(uint8_t mask, uint8_t fmask) {
+  uint8_t* p = binBuf + NMEA_WS_HEADROOM;
+  size_t n = 0;
+  if (mask & WSP_GPS) n += wsbEncodeGps(p + n, gpsValid, gpsLat, gpsLon, gpsHdg);
+  if (mask & WSP_RAW) {
+    for (uint8_t i = 0; i < rawN; ++i) n += wsbEncodeTarget(p + n, raw[i].lat, raw[i].lon, raw[i].r95, raw[i].id, false);
+  }
+  if (mask & WSP_TARGETF) {
+    for (uint8_t i = 0; i < filtN; ++i)
+      if (fmask & (1u << i)) n += wsbEncodeTarget(p + n, filt[i].lat, filt[i].lon, filt[i].r95, filt[i].id, true);
+  }
+  if (mask & WSP_TARGETS) n += telemetryTargetsBinTo(p + n);
+  if (mask & WSP_RSSI) n += wsbEncodeRssi(p + n, rssiDbm);
+  return n;
+}
+
+static void sendFrames(uint8_t mask, uint8_t fmask, uint32_t text, uint32_t bin) {
+  if (text) {
+    size_t n = buildText(mask, fmask);
+    wsSendText(text, textBuf, n);
+    uint32_t k = __builtin_popcount(text);
+    stats.frames += k; stats.bytes += k * n;
+  }
+  if (bin) {
+    size_t n = buildBinary(mask, fmask);
+    if (!n) return;
+    wsSendBinary(bin, binBuf, n);
+    uint32_t k = __builtin_popcount(bin);
+    stats.frames += k; stats.bytes += k * n;
+  }
+}
+
+void wsPubLoop() {
+  unsigned long now = millis();
+  if (now - lastTickMs < gWsTickMs) return;
+  lastTickMs = now;
+  if ((have & WSP_TARGETS) && now - lastTargetsMs >= WSP_TARGETS_REFRESH_MS) dirty |= WSP_TARGETS;
+  if (dirty & WSP_TARGETS) lastTargetsMs = now;
+  uint32_t fresh = wsTakeNewClients();
+  if (!dirty && !fresh) return;
+  uint32_t text = wsTextClients();
+  uint32_t bin = wsBinaryClients();
+  if (fresh && have) {
+    sendFrames(have, (uint8_t)((1u << filtN) - 1), text & fresh, bin & fresh);
+    stats.snapshots += __builtin_popcount(fresh);
+  }
+  if (dirty) sendFrames(dirty, filtDirty, text & ~fresh, bin & ~fresh);
+  stats.ticks++;
+  dirty = 0;
+  filtDirty = 0;
+  rawN = 0;
+  have &= ~WSP_RAW;
+}
+
+WsPubStats wsPubGetStats() {
+  return stats;
+}
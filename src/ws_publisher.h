@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+#include "target_fusion.h"
+
+// Publication WebSocket de l'état temps réel regroupée par tick: GPS, pings
+// bruts et positions filtrées (par balise), pistes des balises et RSSI sont notés dans un masque
+// de changements et partent en une seule trame par client toutes les
+// gWsTickMs (JSON multi-clés, ou enregistrements ws_binary enchaînés).
+// Un client qui se connecte (ou change de protocole) reçoit l'état complet au
+// tick suivant. Les trames NMEA restent diffusées à part, telles quelles.
+// loop uniquement.
+
+struct WsPubStats {
+  uint32_t ticks;       // ticks avec changements ou nouveaux clients
+  uint32_t frames;      // trames envoyées (par client)
+  uint32_t bytes;       // octets envoyés (par client, hors en-tête WS)
+  uint32_t snapshots;   // états complets envoyés à des nouveaux clients
+};
+
+void wsPubGps(bool valid, double lat, double lon, float hdgDeg);
+// Ping brut (dernier par balise dans le tick)
+void wsPubTargetRaw(const TargetOutput& o);
+// Position filtrée, après telemetrySetTarget (pistes mises à jour): la dernière par
+// balise est gardée, chaque balise mise à jour dans le tick est émise
+void wsPubTargetFiltered(const TargetOutput& o);
+void wsPubRssi(int rssi);
+
+// À appeler à chaque tour de loop: envoie les changements à chaque tick
+void wsPubLoop();
+WsPubStats wsPubGetStats();
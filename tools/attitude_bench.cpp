@@ -0,0 +1,108 @@
+// Banc hôte de la compensation géométrie/attitude (src/vessel_geometry)
+// Bateau en houle (roulis 8° / 6 s, tangage 3° / 5 s, phases aléatoires), antenne
+// GNSS en tête de mât, tête SEAKER sous la coque: bras de levier (-2; 0,5; 4,5) m,
+// tête inclinée de 2° en tangage au montage. Cible à la profondeur de la tête puis
+// 30 m plus bas, gisement aléatoire; l'angle mesuré est la projection du rayon dans
+// le plan de la tête, la distance est la distance oblique vraie. Erreur horizontale
+// de la position reconstruite sans géométrie (calcul historique), avec bras de levier
+// seul, et avec bras de levier + montage + attitude. Sortie: RMS / max par distance
+// horizontale, coût par ping.
+//
+//Build
+//g++ -O2 -std=gnu++11 -Isrc -o attitude_bench tools/attitude_bench.cpp src/vessel_geometry.cpp
+//
+//Usage
+//./attitude_bench [pings]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <random>
+#include <chrono>
+#include "vessel_geometry.h"
+
+static const float DEG = (float)M_PI / 180.0f;
+
+// Repère nivelé -> bateau: transposée de Ry(tangage) Rx(roulis)
+static void levelToBody(float p, float r, const float w[3], float b[3]) {
+  float sp = sinf(p), cp = cosf(p), sr = sinf(r), cr = cosf(r);
+  b[0] = cp * w[0] - sp * w[2];
+  b[1] = sp * sr * w[0] + cr * w[1] + cp * sr * w[2];
+  b[2] = sp * cr * w[0] - sr * w[1] + cp * cr * w[2];
+}
+
+struct Err { double se; double mx; int n; };
+
+static void note(Err& e, float dx, float dy) {
+  double d2 = (double)dx * dx + (double)dy * dy;
+  e.se += d2; e.n++;
+  if (sqrt(d2) > e.mx) e.mx = sqrt(d2);
+}
+
+int main(int argc, char** argv) {
+  int pings = (argc > 1) ? atoi(argv[1]) : 20000;
+  VesselGeometry g;
+  vesselGeometryDefaults(g);
+  g.antX = 0.0f; g.antY = 0.0f; g.antZ = -3.0f;
+  g.headX = -2.0f; g.headY = 0.5f; g.headZ = 1.5f;
+  g.mountPitchDeg = 2.0f;
+  VesselGeometry leverOnly = g;
+  leverOnly.mountPitchDeg = 0.0f; leverOnly.attitude = false;
+  VesselMount mFull, mLever;
+  vesselMountPrepare(g, mFull);
+  vesselMountPrepare(leverOnly, mLever);
+
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+  const float ranges[3] = {50.0f, 150.0f, 300.0f};
+  const float depths[2] = {0.0f, 30.0f};
+  printf("%-14s %18s %18s %18s\n", "dist/prof.", "sans géométrie", "bras de levier", "levier+attitude");
+  for (int k = 0; k < 6; ++k) {
+    Err e0 = {}, e1 = {}, e2 = {};
+    float H = ranges[k % 3], Z = depths[k / 3];
+    float R = sqrtf(H * H + Z * Z);   // distance oblique mesurée
+    for (int i = 0; i < pings; ++i) {
+      float t = 600.0f * u01(rng);
+      float roll = 8.0f * DEG * sinf(2.0f * (float)M_PI * t / 6.0f + 1.3f);
+      float pitch = 3.0f * DEG * sinf(2.0f * (float)M_PI * t / 5.0f);
+      float B = 2.0f * (float)M_PI * u01(rng);          // gisement vrai / cap
+      // Position vraie de la tête (repère nivelé, origine antenne)
+      float lever[3] = {g.headX - g.antX, g.headY - g.antY, g.headZ - g.antZ}, lw[3];
+      {
+        float sp = sinf(pitch), cp = cosf(pitch), sr = sinf(roll), cr = cosf(roll);
+        lw[0] = cp * lever[0] + sp * sr * lever[1] + sp * cr * lever[2];
+        lw[1] = cr * lever[1] - sr * lever[2];
+      }
+      float tx = lw[0] + H * cosf(B), ty = lw[1] + H * sinf(B);
+      // Rayon vu de la tête: repère bateau puis repère de la tête (montage)
+      float w[3] = {H * cosf(B) / R, H * sinf(B) / R, Z / R}, b[3];
+      levelToBody(pitch, roll, w, b);
+      float mp = g.mountPitchDeg * DEG;
+      float hx = cosf(mp) * b[0] - sinf(mp) * b[2];
+      float hy = b[1];
+      float rel = atan2f(hy, hx) / DEG;
+      // Calcul historique: tête à l'antenne, à plat
+      note(e0, R * cosf(rel * DEG) - tx, R * sinf(rel * DEG) - ty);
+      VesselPingGeom pg;
+      vesselApplyPing(mLever, rel, NAN, NAN, pg);
+      note(e1, pg.fwd + R * cosf(pg.relBrgRad) - tx, pg.stbd + R * sinf(pg.relBrgRad) - ty);
+      vesselApplyPing(mFull, rel, pitch / DEG, roll / DEG, pg);
+      note(e2, pg.fwd + R * cosf(pg.relBrgRad) - tx, pg.stbd + R * sinf(pg.relBrgRad) - ty);
+    }
+    printf("%5.0f / %2.0f m  %7.2f / %6.2f m  %7.2f / %6.2f m  %7.2f / %6.2f m\n", (double)H, (double)Z,
+           sqrt(e0.se / e0.n), e0.mx, sqrt(e1.se / e1.n), e1.mx, sqrt(e2.se / e2.n), e2.mx);
+  }
+
+  typedef std::chrono::steady_clock Clock;
+  volatile float sink = 0.0f;
+  Clock::time_point a = Clock::now();
+  for (int i = 0; i < pings * 10; ++i) {
+    VesselPingGeom pg;
+    vesselApplyPing(mFull, (float)(i % 360), 1.5f + 1e-4f * (i & 255), -4.0f, pg);
+    sink = sink + pg.relBrgRad;
+  }
+  Clock::time_point b = Clock::now();
+  printf("vesselApplyPing: %.0f ns/ping (RMS / max de l'erreur horizontale)\n",
+         std::chrono::duration<double, std::nano>(b - a).count() / (pings * 10.0));
+  return 0;
+}
@@ -0,0 +1,96 @@
+// Contrôle hôte de la projection locale (src/local_enu) face à utm.cpp
+// Calcul de la cible comme dans target_fusion: pose bateau + (azimut vrai, distance).
+// Référence: problème direct géodésique de Vincenty sur l'ellipsoïde WGS84.
+// Bateau tiré dans le rayon donné autour de l'ancrage, cible à 50..1500 m.
+//
+//Build
+//g++ -O2 -std=gnu++11 -Isrc -o enu_accuracy tools/enu_accuracy.cpp src/local_enu.cpp src/utm.cpp
+//
+//Usage
+//./enu_accuracy [rayon_m] [tirages]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "local_enu.h"
+#include "utm.h"
+
+static const double A = 6378137.0;
+static const double F = 1.0 / 298.257223563;
+static const double B = A * (1.0 - F);
+static const double D2R = M_PI / 180.0;
+
+// Vincenty, problème direct (azimut vrai en degrés, distance en mètres)
+static void vincentyDirect(double latDeg, double lonDeg, double azDeg, double s, double& lat2, double& lon2) {
+  double a1 = azDeg * D2R;
+  double sa1 = sin(a1), ca1 = cos(a1);
+  double tanU1 = (1 - F) * tan(latDeg * D2R);
+  double cosU1 = 1 / sqrt(1 + tanU1 * tanU1), sinU1 = tanU1 * cosU1;
+  double sig1 = atan2(tanU1, ca1);
+  double sinAlpha = cosU1 * sa1;
+  double cos2Alpha = 1 - sinAlpha * sinAlpha;
+  double u2 = cos2Alpha * (A * A - B * B) / (B * B);
+  double AA = 1 + u2 / 16384 * (4096 + u2 * (-768 + u2 * (320 - 175 * u2)));
+  double BB = u2 / 1024 * (256 + u2 * (-128 + u2 * (74 - 47 * u2)));
+  double sig = s / (B * AA), sigP, cos2SigM, sinSig, cosSig;
+  do {
+    cos2SigM = cos(2 * sig1 + sig);
+    sinSig = sin(sig); cosSig = cos(sig);
+    double dSig = BB * sinSig * (cos2SigM + BB / 4 * (cosSig * (-1 + 2 * cos2SigM * cos2SigM) -
+                  BB / 6 * cos2SigM * (-3 + 4 * sinSig * sinSig) * (-3 + 4 * cos2SigM * cos2SigM)));
+    sigP = sig;
+    sig = s / (B * AA) + dSig;
+  } while (fabs(sig - sigP) > 1e-13);
+  double tmp = sinU1 * sinSig - cosU1 * cosSig * ca1;
+  double phi2 = atan2(sinU1 * cosSig + cosU1 * sinSig * ca1, (1 - F) * sqrt(sinAlpha * sinAlpha + tmp * tmp));
+  double lam = atan2(sinSig * sa1, cosU1 * cosSig - sinU1 * sinSig * ca1);
+  double C = F / 16 * cos2Alpha * (4 + F * (4 - 3 * cos2Alpha));
+  double L = lam - (1 - C) * F * sinAlpha * (sig + C * sinSig * (cos2SigM + C * cosSig * (-1 + 2 * cos2SigM * cos2SigM)));
+  lat2 = phi2 / D2R;
+  lon2 = lonDeg + L / D2R;
+}
+
+// Écart horizontal en mètres (petites distances)
+static double gapM(double lat1, double lon1, double lat2, double lon2) {
+  double s = sin(lat1 * D2R), w = sqrt(1 - F * (2 - F) * s * s);
+  double N = A / w, M = A * (1 - F * (2 - F)) / (w * w * w);
+  double dn = (lat2 - lat1) * D2R * M, de = (lon2 - lon1) * D2R * N * cos(lat1 * D2R);
+  return sqrt(dn * dn + de * de);
+}
+
+static double urand(double a, double b) { return a + (b - a) * (rand() / (double)RAND_MAX); }
+
+int main(int argc, char** argv) {
+  double radius = (argc > 1) ? atof(argv[1]) : 2000.0;
+  int draws = (argc > 2) ? atoi(argv[2]) : 20000;
+  printf("rayon=%.0f m, %d tirages par latitude\n", radius, draws);
+  printf(" lat  | enu max   enu rms  | utm max   utm rms  (m)\n");
+  srand(1);
+  for (int latBand = 0; latBand <= 70; latBand += 10) {
+    double eMax = 0, eSq = 0, uMax = 0, uSq = 0;
+    for (int i = 0; i < draws; ++i) {
+      // Ancrage sur toute la largeur du fuseau (bord inclus: convergence maximale pour UTM)
+      double lat0 = latBand + urand(-0.5, 0.5), lon0 = urand(-2.9, 2.9);
+      double bLat, bLon, tLat, tLon;
+      vincentyDirect(lat0, lon0, urand(0, 360), urand(0, radius), bLat, bLon);
+      double az = urand(0, 360), d = urand(50, 1500);
+      vincentyDirect(bLat, bLon, az, d, tLat, tLon);
+
+      LocalEnu p; localEnuInit(p, lat0, lon0);
+      float e, n; localEnuForward(p, bLat, bLon, e, n);
+      float g = localEnuGridAzimuth(p, bLon, (float)az) * (float)D2R;
+      double lat, lon; localEnuInverse(p, e + (float)d * sinf(g), n + (float)d * cosf(g), lat, lon);
+      double err = gapM(tLat, tLon, lat, lon);
+      eMax = fmax(eMax, err); eSq += err * err;
+
+      // Chemin historique: UTM, azimut vrai appliqué tel quel sur la grille
+      int zone; bool north; double ue, un;
+      wgs84ToUtm(bLat, bLon, zone, north, ue, un);
+      utmToWgs84(zone, north, ue + d * sin(az * D2R), un + d * cos(az * D2R), lat, lon);
+      err = gapM(tLat, tLon, lat, lon);
+      uMax = fmax(uMax, err); uSq += err * err;
+    }
+    printf(" %3d  | %.4f  %.4f   | %.3f  %.3f\n", latBand, eMax, sqrt(eSq / draws), uMax, sqrt(uSq / draws));
+  }
+  return 0;
+}
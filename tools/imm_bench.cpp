@@ -0,0 +1,138 @@
+// Banc hôte du pistage IMM (src/target_imm) face au filtre à modèle unique
+// Trajectoires de src/demo_sim.cpp (reproduites ici, pings toutes les 250 ms comme
+// le mock SEAKER) et un cas opérationnel stationnaire / transit:
+//  - demo: bateau en petite orbite + dérive, ROV en va-et-vient 30..200 m sur 180 s
+//  - hover: ROV immobile 120 s, transit 0,5 m/s 120 s, immobile 120 s, demi-tour 1 m/s 60 s
+// Le tracé "HELLO" de la démo n'est pas repris: la cible y saute de 40 à 80 m d'un
+// trait à l'autre (lever de plume) et parcourt 80 m en 2 s; aucun modèle cinématique ne
+// le suit (~40 m RMS pour tous), la ligne ne départageait rien.
+// Mesure polaire EKF (sigma angle 3°, distance max(0,6 m, 0,5 %) pour le bruit
+// uniforme ±1 m / ±2° de la démo), gating 4 sigma et réinitialisation après 5 rejets. Sorties: RMS position, temps par ping, probabilités moyennes par phase.
+//
+//Build
+//g++ -O2 -std=gnu++11 -Isrc -o imm_bench tools/imm_bench.cpp src/target_imm.cpp src/target_filter.cpp
+//
+//Usage
+//./imm_bench [répétitions_chrono]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <random>
+#include <vector>
+#include <chrono>
+#include "target_imm.h"
+
+struct Truth { float t, bx, by, tx, ty; int phase; };
+
+static const float PING_DT = 0.25f;
+static const float DEG = (float)M_PI / 180.0f;
+
+// demo_sim.cpp, mode par défaut: azimut = cap bateau (45°) + angle de base 0
+static void trajDemo(std::vector<Truth>& v) {
+  for (float t = 0; t < 900.0f; t += PING_DT) {
+    float w = 2.0f * (float)M_PI / 120.0f;
+    float drift = 0.05f * t;
+    float bx = 3.0f * sinf(w * t) + 0.7071f * drift, by = 3.0f * cosf(w * t) + 0.7071f * drift;
+    float dist = 115.0f + 85.0f * sinf(2.0f * (float)M_PI * t / 180.0f);
+    v.push_back({t, bx, by, bx + dist * sinf(45.0f * DEG), by + dist * cosf(45.0f * DEG), 0});
+  }
+}
+
+// Stationnaire / transit: phase 0 = immobile, 1 = transit
+static void trajHover(std::vector<Truth>& v) {
+  float tx = 0, ty = 80.0f;
+  for (float t = 0; t < 420.0f; t += PING_DT) {
+    int ph = 0; float vx = 0, vy = 0;
+    if (t >= 120 && t < 240) { ph = 1; vx = 0.5f; }
+    else if (t >= 360) { ph = 1; vx = -1.0f; }
+    tx += vx * PING_DT; ty += vy * PING_DT;
+    v.push_back({t, 0, 0, tx, ty, ph});
+  }
+}
+
+struct Result { double rms; double muPhase[2][IMM_MODEL_COUNT]; int nPhase[2]; int gated; int resets; };
+
+// imm: vrai = IMM, sinon modèle unique à aStd
+static Result run(const std::vector<Truth>& tr, bool imm, float aStd, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> ua(-2.0f, 2.0f), ud(-1.0f, 1.0f);
+  TargetImmState is; targetImmReset(is);
+  TargetFilterState fs = {};
+  Result r = {};
+  double se = 0; int n = 0, streak = 0;
+  for (size_t k = 0; k < tr.size(); ++k) {
+    const Truth& p = tr[k];
+    float dx = p.tx - p.bx, dy = p.ty - p.by;
+    float rng0 = sqrtf(dx * dx + dy * dy);
+    TargetMeas m;
+    m.mode = TARGET_MEAS_EKF;
+    m.polar.originX = p.bx; m.polar.originY = p.by;
+    m.polar.range = fmaxf(0.0f, rng0 + ud(rng));
+    m.polar.bearingRad = atan2f(dx, dy) + ua(rng) * DEG;
+    m.polar.rangeStd = fmaxf(0.6f, 0.005f * m.polar.range);
+    m.polar.bearingStd = 3.0f * DEG;
+    m.polar.originStd = 0.03f;
+    m.x = p.bx + m.polar.range * sinf(m.polar.bearingRad);
+    m.y = p.by + m.polar.range * cosf(m.polar.bearingRad);
+    m.posStd = 1.0f;
+    float ex, ey;
+    // Réinitialisation après 5 rejets consécutifs, comme target_fusion
+    if (streak >= 5) { targetImmReset(is); targetFilterReset(fs); streak = 0; r.resets++; }
+    if (imm) {
+      if (k) targetImmPredict(is, PING_DT, aStd);
+      if (targetImmInnovation(is, m) >= 4.0f) { r.gated++; streak++; } else { targetImmUpdate(is, m); streak = 0; }
+      ex = targetFilterX(is.est); ey = targetFilterY(is.est);
+      if (k > 40) {
+        for (int j = 0; j < IMM_MODEL_COUNT; ++j) r.muPhase[p.phase][j] += is.mu[j];
+        r.nPhase[p.phase]++;
+      }
+    } else {
+      if (k) targetFilterPredict(fs, PING_DT, aStd);
+      if (targetFilterMeasInnovation(fs, m) >= 4.0f) { r.gated++; streak++; } else { targetFilterMeasUpdate(fs, m); streak = 0; }
+      ex = targetFilterX(fs); ey = targetFilterY(fs);
+    }
+    if (k > 40) { se += (ex - p.tx) * (ex - p.tx) + (ey - p.ty) * (ey - p.ty); n++; }
+  }
+  r.rms = sqrt(se / n);
+  for (int ph = 0; ph < 2; ++ph)
+    for (int j = 0; j < IMM_MODEL_COUNT; ++j) if (r.nPhase[ph]) r.muPhase[ph][j] /= r.nPhase[ph];
+  return r;
+}
+
+int main(int argc, char** argv) {
+  int reps = (argc > 1) ? atoi(argv[1]) : 200;
+  const char* names[2] = {"demo", "hover"};
+  std::vector<Truth> tr[2];
+  trajDemo(tr[0]); trajHover(tr[1]);
+  const float singles[3] = {0.05f, 0.5f, 2.0f};
+  printf("%-6s %10s %10s %10s %10s\n", "traj", "K=0.05", "K=0.5", "K=2", "IMM(K=0.5)");
+  for (int t = 0; t < 2; ++t) {
+    printf("%-6s", names[t]);
+    for (int s = 0; s < 3; ++s) {
+      Result r = run(tr[t], false, singles[s], 11);
+      printf(" %8.2f m", r.rms);
+      if (getenv("V")) printf("(%d/%d)", r.gated, r.resets);
+    }
+    Result ri = run(tr[t], true, 0.5f, 11);
+    printf(" %8.2f m", ri.rms);
+    if (getenv("V")) printf("(%d/%d)", ri.gated, ri.resets);
+    printf("\n");
+    if (t == 1) {
+      for (int ph = 0; ph < 2; ++ph)
+        printf("  hover phase %s: mu immobile %.2f, cv %.2f, manoeuvre %.2f\n", ph ? "transit" : "immobile",
+               ri.muPhase[ph][0], ri.muPhase[ph][1], ri.muPhase[ph][2]);
+    }
+  }
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point a = Clock::now();
+  for (int i = 0; i < reps; ++i) run(tr[1], false, 0.5f, i);
+  Clock::time_point b = Clock::now();
+  for (int i = 0; i < reps; ++i) run(tr[1], true, 0.5f, i);
+  Clock::time_point c = Clock::now();
+  double pings = (double)reps * tr[1].size();
+  printf("modèle unique: %.0f ns/ping, IMM: %.0f ns/ping (prédiction + gating + mise à jour, EKF polaire)\n",
+         std::chrono::duration<double, std::nano>(b - a).count() / pings,
+         std::chrono::duration<double, std::nano>(c - b).count() / pings);
+  return 0;
+}
@@ -0,0 +1,169 @@
+// Banc hôte du filtre cible (src/target_filter, src/kalman_fixed.h)
+//  - ns par prédiction + mise à jour (float)
+//  - erreur RMS position / vitesse sur une cible simulée (dérive lente + bruit
+//    de mesure), face à l'ancien filtre à covariance diagonale (reproduit ici)
+//  - mesure (distance, gisement): point converti isotrope vs EKF vs UKF polaires,
+//    bateau en aller-retour à 300 m de la cible, bruit angulaire 3° et 0,5 % en distance,
+//    un ping sur 20 allongé de 25 m (trajet multiple), gating à 4 sigma comme target_fusion
+//
+//Build
+//g++ -O2 -std=gnu++11 -Isrc -o kalman_bench tools/kalman_bench.cpp src/target_filter.cpp
+//
+//Usage
+//./kalman_bench [mises_à_jour]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <random>
+#include <chrono>
+#include "target_filter.h"
+
+// --- Ancien filtre: diagonales seules, vitesses jamais corrigées ---
+struct OldState { float x, y, vx, vy, Pxx, Pyy, Pvvx, Pvvy; bool init; };
+static void oldPredict(OldState& s, float dt, float aStd) {
+  if (!s.init) return;
+  s.x += s.vx * dt; s.y += s.vy * dt;
+  float q = aStd * aStd;
+  s.Pxx += s.Pvvx * dt * dt + q * (dt * dt * 0.5f) * (dt * dt * 0.5f);
+  s.Pyy += s.Pvvy * dt * dt + q * (dt * dt * 0.5f) * (dt * dt * 0.5f);
+  s.Pvvx += q * dt; s.Pvvy += q * dt;
+}
+static float oldUpdate(OldState& s, float mx, float my, float std) {
+  float r2 = std * std;
+  if (!s.init) { s = OldState{mx, my, 0, 0, r2, r2, 100, 100, true}; return 0; }
+  float yx = mx - s.x, yy = my - s.y, Sx = s.Pxx + r2, Sy = s.Pyy + r2;
+  float Kx = s.Pxx / Sx, Ky = s.Pyy / Sy;
+  s.x += Kx * yx; s.y += Ky * yy;
+  s.Pxx *= (1 - Kx); s.Pyy *= (1 - Ky);
+  return sqrtf(yx * yx / Sx + yy * yy / Sy);
+}
+
+typedef std::chrono::steady_clock Clock;
+static volatile float gSink;
+
+int main(int argc, char** argv) {
+  int n = (argc > 1) ? atoi(argv[1]) : 200000;
+  const float dt = 2.0f, measStd = 1.5f, aStd = 0.05f;
+  std::mt19937 rng(1);
+  std::normal_distribution<float> noise(0.0f, measStd);
+
+  // Trajectoire: dérive de 0,3 m/s cap 60°, légère courbure
+  TargetFilterState kf = {};
+  OldState old = {};
+  double ePos = 0, eVel = 0, oPos = 0, oVel = 0;
+  int counted = 0;
+  float tx = 0, ty = 0;
+  for (int i = 0; i < 2000; ++i) {
+    float hdg = 1.047f + 0.0005f * i;
+    float vx = 0.3f * sinf(hdg), vy = 0.3f * cosf(hdg);
+    tx += vx * dt; ty += vy * dt;
+    float mx = tx + noise(rng), my = ty + noise(rng);
+    if (i) { targetFilterPredict(kf, dt, aStd); oldPredict(old, dt, aStd); }
+    targetFilterUpdate(kf, mx, my, measStd);
+    oldUpdate(old, mx, my, measStd);
+    if (i >= 100) {
+      ePos += pow(targetFilterX(kf) - tx, 2) + pow(targetFilterY(kf) - ty, 2);
+      eVel += pow(kf.kf.x.m[2][0] - vx, 2) + pow(kf.kf.x.m[3][0] - vy, 2);
+      oPos += pow(old.x - tx, 2) + pow(old.y - ty, 2);
+      oVel += pow(old.vx - vx, 2) + pow(old.vy - vy, 2);
+      counted++;
+    }
+  }
+  printf("cible 0,3 m/s, mesure %.1f m, ping %.0f s\n", measStd, dt);
+  printf("joseph 4x4 : rms pos %.3f m, rms vit %.3f m/s\n", sqrt(ePos / counted), sqrt(eVel / counted));
+  printf("ancien     : rms pos %.3f m, rms vit %.3f m/s\n", sqrt(oPos / counted), sqrt(oVel / counted));
+
+  // Temps (mesures pré-tirées pour ne chronométrer que le filtre)
+  float* mx = new float[n]; float* my = new float[n];
+  for (int i = 0; i < n; ++i) { mx[i] = noise(rng); my[i] = noise(rng); }
+  targetFilterInit(kf, 0, 0, measStd);
+  Clock::time_point t0 = Clock::now();
+  float acc = 0;
+  for (int i = 0; i < n; ++i) {
+    targetFilterPredict(kf, dt, aStd);
+    acc += targetFilterUpdate(kf, mx[i], my[i], measStd);
+  }
+  Clock::time_point t1 = Clock::now();
+  old.init = false;
+  for (int i = 0; i < n; ++i) {
+    oldPredict(old, dt, aStd);
+    acc += oldUpdate(old, mx[i], my[i], measStd);
+  }
+  Clock::time_point t2 = Clock::now();
+  gSink = acc;
+  printf("joseph 4x4 : %.1f ns/(prédiction+mise à jour)\n", std::chrono::duration<double, std::nano>(t1 - t0).count() / n);
+  printf("ancien     : %.1f ns/(prédiction+mise à jour)\n", std::chrono::duration<double, std::nano>(t2 - t1).count() / n);
+  delete[] mx; delete[] my;
+
+  // --- Mesure polaire ---
+  const float angStd = 3.0f * (float)M_PI / 180.0f, rngRel = 0.005f, gpsStd = 0.5f;
+  const float pdt = 1.0f;
+  std::normal_distribution<float> unit(0.0f, 1.0f);
+  const char* names[3] = {"cart", "ekf ", "ukf "};
+  for (int mode = 0; mode < 3; ++mode) {
+    std::mt19937 prng(7);
+    TargetFilterState f = {};
+    double sp = 0, sr = 0, sv = 0, sn = 0; int cnt = 0, okRej = 0, badRej = 0, nOut = 0;
+    float gx = 0, gy = 0;
+    for (int i = 0; i < 3000; ++i) {
+      float t = i * pdt;
+      gx = 0.02f * t; gy = 0.01f * t;                       // cible: 2 cm/s
+      float bx = 200.0f * sinf(0.003f * t), by = -300.0f;   // aller-retour sur une ligne
+      float ex = bx + gpsStd * unit(prng), ey = by + gpsStd * unit(prng);
+      float dx = gx - bx, dy = gy - by, r = sqrtf(dx * dx + dy * dy);
+      float rStd = fmaxf(0.1f, rngRel * r);
+      float mr = r + rStd * unit(prng), mb = atan2f(dx, dy) + angStd * unit(prng);
+      bool outlier = (i % 20) == 10;
+      if (outlier) { mr += 25.0f; nOut++; }
+      if (i) targetFilterPredict(f, pdt, aStd);
+      float lat = mr * angStd, iso = sqrtf(lat * lat + rStd * rStd + gpsStd * gpsStd);
+      float mx = ex + mr * sinf(mb), my = ey + mr * cosf(mb);
+      TargetPolarMeas pm = {ex, ey, mr, mb, rStd, angStd, gpsStd};
+      float g = (mode == TARGET_MEAS_CART) ? targetFilterInnovation(f, mx, my, iso)
+                                           : targetFilterPolarInnovation(f, (uint8_t)mode, pm);
+      if (g >= 4.0f) {
+        if (outlier) okRej++; else badRej++;
+      } else if (mode == TARGET_MEAS_CART) {
+        sn += targetFilterUpdate(f, mx, my, iso);
+      } else {
+        sn += targetFilterPolarUpdate(f, (uint8_t)mode, pm);
+      }
+      if (i >= 200) {
+        float ox = targetFilterX(f) - gx, oy = targetFilterY(f) - gy;
+        sp += ox * ox + oy * oy;
+        sr += pow((ox * dx + oy * dy) / r, 2);               // composante radiale
+        sv += pow(f.kf.x.m[2][0] - 0.02f, 2) + pow(f.kf.x.m[3][0] - 0.01f, 2);
+        cnt++;
+      }
+    }
+    printf("polaire %s : rms pos %.3f m (radial %.3f m), rms vit %.4f m/s, innovation moy %.2f sigma, "
+           "aberrants rejetés %d/%d, faux rejets %d\n",
+           names[mode], sqrt(sp / cnt), sqrt(sr / cnt), sqrt(sv / cnt), sn / 3000.0, okRej, nOut, badRej);
+  }
+  {
+    TargetPolarMeas pm = {0, 0, 500.0f, 0.3f, 2.5f, angStd, gpsStd};
+    for (int mode = 0; mode < 3; ++mode) {
+      TargetFilterState f = {};
+      targetFilterInit(f, 500.0f * sinf(0.3f), 500.0f * cosf(0.3f), 5.0f);
+      Clock::time_point a = Clock::now();
+      float s2 = 0;
+      for (int i = 0; i < n; ++i) {
+        pm.range = 500.0f + 2.5f * (float)((i * 37) % 7 - 3);
+        targetFilterPredict(f, dt, aStd);
+        if (mode == TARGET_MEAS_CART) {
+          s2 += targetFilterInnovation(f, pm.range * sinf(pm.bearingRad), pm.range * cosf(pm.bearingRad), 26.0f);
+          s2 += targetFilterUpdate(f, pm.range * sinf(pm.bearingRad), pm.range * cosf(pm.bearingRad), 26.0f);
+        } else {
+          s2 += targetFilterPolarInnovation(f, (uint8_t)mode, pm);
+          s2 += targetFilterPolarUpdate(f, (uint8_t)mode, pm);
+        }
+      }
+      Clock::time_point b = Clock::now();
+      gSink = s2;
+      printf("polaire %s : %.1f ns/(prédiction+gating+mise à jour)\n", names[mode],
+             std::chrono::duration<double, std::nano>(b - a).count() / n);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,144 @@
+// Banc de mesure hôte: temps de parsing NMEA par ligne
+//  - "minimal": tokenizer + dispatch (src/nmea_parse, src/nmea_dispatch), GSV/GSA ignorés
+//  - "sats":    idem + table satellites GSV/GSA (src/gnss_sats)
+//  - "vendor":  SkyTraqNmeaParser::Encode octet par octet (docs/PX1172RH-HAT-RaspberryPiDemo)
+//
+//Build
+//g++ -O2 -std=gnu++11 -Isrc -Idocs/PX1172RH-HAT-RaspberryPiDemo -o nmea_bench tools/nmea_bench.cpp src/nmea_parse.cpp src/nmea_dispatch.cpp src/gnss_sats.cpp docs/PX1172RH-HAT-RaspberryPiDemo/SkyTraqNmeaParser.cpp
+//
+//Usage
+//./nmea_bench [fichier.nmea] [répétitions]
+// Fichier: trames brutes une par ligne (curl http://<ip>/api/gps/raw?lines=128, ou log série).
+// Sans fichier, une rafale SkyTraq type (GGA/GSA/GSV/RMC/VTG/PSTI) est utilisée.
+// Note: le parseur constructeur est compilé tel que livré (_SUPPORT_*_SATELLITES_ = 0),
+// il ne remplit donc pas de table satellites: la comparaison lui est favorable.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "nmea_parse.h"
+#include "nmea_dispatch.h"
+#include "gnss_sats.h"
+#include "SkyTraqNmeaParser.h"
+
+static const char* kSampleBurst[] = {
+  "$GNGGA,083559.000,4739.6736,N,00244.2553,W,4,24,0.6,10.2,M,49.6,M,1.0,0000*5C",
+  "$GNGSA,A,3,05,13,15,18,20,23,24,29,,,,,1.1,0.6,0.9,1*3E",
+  "$GNGSA,A,3,66,67,76,77,,,,,,,,,1.1,0.6,0.9,2*34",
+  "$GPGSV,3,1,11,05,42,297,45,13,55,180,47,15,62,064,48,18,21,073,40,1*66",
+  "$GPGSV,3,2,11,20,12,312,38,23,08,033,35,24,36,120,44,29,31,233,46,1*61",
+  "$GPGSV,3,3,11,10,05,280,,26,02,170,,193,18,101,30,1*52",
+  "$GLGSV,2,1,06,66,35,062,44,67,71,331,46,76,22,140,39,77,48,221,45,1*74",
+  "$GLGSV,2,2,06,65,05,012,,86,10,300,,1*7A",
+  "$GNRMC,083559.000,A,4739.6736,N,00244.2553,W,0.1,180.3,110925,,,R*61",
+  "$GNVTG,180.3,T,,M,0.1,N,0.2,K,R*2F",
+  "$PSTI,030,083559.000,A,4739.6736,N,00244.2553,W,10.2,0.01,-0.02,0.00,110925,R,1.0,999.9*2E",
+  "$PSTI,036,083559.000,110925,A,182.4,-1.2,0.8,R*1F",
+  "$GPHDT,182.4,T*0C",
+};
+
+static volatile bool gSink = false;
+static bool sinkHandler(const NmeaField* t, int n) { gSink ^= (n > 0 && t[0].len > 0); return true; }
+
+// Même jeu de phrases que la table du firmware (gps_skytraq.cpp), handlers neutres
+static constexpr NmeaHandlerEntry kBenchHandlers[] = {
+  { nmeaId3("GGA"), 0, "GGA", sinkHandler },
+  { nmeaId3("RMC"), 0, "RMC", sinkHandler },
+  { nmeaId3("VTG"), 0, "VTG", sinkHandler },
+  { nmeaId3("HDT"), 0, "HDT", sinkHandler },
+  { nmeaId3("THS"), 0, "THS", sinkHandler },
+  { nmeaIdP("PASHR"), 0, "PASHR", sinkHandler },
+  { nmeaIdP("PSTI"), 36, "PSTI036", sinkHandler },
+  { nmeaIdP("PSTI"), 30, "PSTI030", sinkHandler },
+  { nmeaId3("GSV"), 0, "GSV", sinkHandler },
+  { nmeaId3("GSA"), 0, "GSA", sinkHandler },
+};
+static const int kBenchCount = sizeof(kBenchHandlers) / sizeof(kBenchHandlers[0]);
+typedef NmeaDispatch<kBenchHandlers, kBenchCount> BenchDispatch;
+static constexpr NmeaSlotTable kBenchSlots = BenchDispatch::slots();
+
+static GnssSatTable gSats;
+
+static void parseFirmware(const std::string& line, bool withSats) {
+  NmeaField t[NMEA_MAX_FIELDS];
+  int n = 0;
+  if (nmeaTokenize(line.data(), line.size(), t, NMEA_MAX_FIELDS, n) != NMEA_TOK_OK || n == 0) return;
+  uint32_t key; uint16_t sub;
+  if (!nmeaSentenceKey(t, n, key, sub)) return;
+  int h = BenchDispatch::find(kBenchSlots, key, sub);
+  if (h < 0) return;
+  if (key == nmeaId3("GSV") || key == nmeaId3("GSA")) {
+    if (!withSats) return; // parseur minimal: phrases ignorées
+    bool done;
+    if (key == nmeaId3("GSV")) gnssApplyGsv(gSats, t, n, done);
+    else gnssApplyGsa(gSats, t, n);
+    return;
+  }
+  kBenchHandlers[h].handler(t, n);
+}
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char** argv) {
+  std::vector<std::string> lines;
+  if (argc > 1) {
+    FILE* f = fopen(argv[1], "r");
+    if (!f) { perror(argv[1]); return 1; }
+    char buf[512];
+    while (fgets(buf, sizeof(buf), f)) {
+      size_t l = strlen(buf);
+      while (l && (buf[l - 1] == '\n' || buf[l - 1] == '\r')) buf[--l] = '\0';
+      if (l && buf[0] == '$') lines.push_back(std::string(buf, l));
+    }
+    fclose(f);
+  } else {
+    for (size_t i = 0; i < sizeof(kSampleBurst) / sizeof(kSampleBurst[0]); ++i) {
+      // Checksums de l'échantillon recalculés pour rester valides
+      std::string s = kSampleBurst[i];
+      size_t star = s.find('*');
+      char cks[4];
+      snprintf(cks, sizeof(cks), "%02X", nmeaChecksumBuf(s.data() + 1, star - 1));
+      lines.push_back(s.substr(0, star + 1) + cks);
+    }
+  }
+  if (lines.empty()) { fprintf(stderr, "aucune trame\n"); return 1; }
+  int reps = (argc > 2) ? atoi(argv[2]) : 20000;
+  gnssSatInit(gSats);
+  size_t total = lines.size() * (size_t)reps;
+
+  Clock::time_point t0 = Clock::now();
+  for (int r = 0; r < reps; ++r) for (size_t i = 0; i < lines.size(); ++i) parseFirmware(lines[i], false);
+  Clock::time_point t1 = Clock::now();
+  for (int r = 0; r < reps; ++r) for (size_t i = 0; i < lines.size(); ++i) parseFirmware(lines[i], true);
+  Clock::time_point t2 = Clock::now();
+  SkyTraqNmeaParser vendor;
+  for (int r = 0; r < reps; ++r) {
+    for (size_t i = 0; i < lines.size(); ++i) {
+      const std::string& s = lines[i];
+      for (size_t k = 0; k < s.size(); ++k) vendor.Encode((U08)s[k]);
+      vendor.Encode('\r');
+      vendor.Encode('\n');
+    }
+  }
+  Clock::time_point t3 = Clock::now();
+
+  double nMin = std::chrono::duration<double, std::nano>(t1 - t0).count() / total;
+  double nSat = std::chrono::duration<double, std::nano>(t2 - t1).count() / total;
+  double nVen = std::chrono::duration<double, std::nano>(t3 - t2).count() / total;
+  printf("lignes=%zu x %d\n", lines.size(), reps);
+  printf("minimal : %8.1f ns/ligne\n", nMin);
+  printf("sats    : %8.1f ns/ligne (%.2fx minimal)\n", nSat, nSat / nMin);
+  printf("vendor  : %8.1f ns/ligne (%.2fx minimal)\n", nVen, nVen / nMin);
+
+  GnssSatSummary sum;
+  gnssSatSummarize(gSats, sum);
+  for (int c = 0; c < GNSS_CONST_COUNT; ++c) {
+    if (!sum.c[c].inView) continue;
+    printf("%-4s vue=%u suivis=%u utilisés=%u snr=%u max=%u\n", gnssConstName((GnssConst)c),
+           sum.c[c].inView, sum.c[c].tracked, sum.c[c].used, sum.c[c].snrMean, sum.c[c].snrMax);
+  }
+  return 0;
+}
@@ -0,0 +1,110 @@
+// Vérification hôte du décodage du lien SEAKER (src/seaker_proto, src/nmea_parse)
+//  - $DTPING format TAT (TOF, TAT ms, angle, distance dm) et format legacy (angle, distance m)
+//  - $STATUS (statut, fréquence, SNR, énergies)
+//  - entrées malformées: checksum faux, '*' absent, champs manquants ou vides,
+//    trop de champs (au-delà de NMEA_MAX_FIELDS), statut trop long, phrase inconnue
+//  - canal des commandes CONFIG sortantes et validation du TAT
+// Sortie: une ligne par échec, code de retour 1 si au moins un échec.
+//
+//Build
+//g++ -O2 -std=gnu++11 -Isrc -o seaker_check tools/seaker_check.cpp src/seaker_proto.cpp src/nmea_parse.cpp
+//
+//Usage
+//./seaker_check
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "seaker_proto.h"
+
+static int failures = 0, checks = 0;
+
+#define CHECK(cond) do { checks++; if (!(cond)) { failures++; printf("ÉCHEC %s:%d: %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+static bool near(float a, float b) { return fabsf(a - b) < 1e-4f; }
+
+static SeakerSentenceType decode(const char* line, SeakerPing& p, SeakerStatusRec& st) {
+  // Valeurs sentinelles: un champ non écrit par le décodeur reste visible
+  memset(&p, 0x5A, sizeof(p));
+  memset(&st, 0x5A, sizeof(st));
+  return seakerDecodeLine(line, strlen(line), 1234u, p, st);
+}
+
+static void checkDtping() {
+  SeakerPing p; SeakerStatusRec st;
+  // Format avec TAT: distance en décimètres
+  CHECK(decode("$DTPING,0.412,2000,-12.5,3087*12", p, st) == SEAKER_SENT_DTPING);
+  CHECK(near(p.tof, 0.412f));
+  CHECK(p.tatMs == 2000);
+  CHECK(near(p.angleDeg, -12.5f));
+  CHECK(near(p.distanceM, 308.7f));
+  CHECK(p.rxMs == 1234u && p.rxUs == 0 && p.beaconId == 0);
+  // Format legacy: angle, distance en mètres, sans TOF ni TAT
+  CHECK(decode("$DTPING,23.0,154.2*33", p, st) == SEAKER_SENT_DTPING);
+  CHECK(isnan(p.tof) && p.tatMs == -1);
+  CHECK(near(p.angleDeg, 23.0f) && near(p.distanceM, 154.2f));
+  // Champs manquants ou vides: phrase reconnue, angle et distance absents
+  CHECK(decode("$DTPING*00", p, st) == SEAKER_SENT_DTPING);
+  CHECK(isnan(p.angleDeg) && isnan(p.distanceM) && isnan(p.tof) && p.tatMs == -1);
+  CHECK(decode("$DTPING,0.412*05", p, st) == SEAKER_SENT_DTPING);
+  CHECK(isnan(p.angleDeg) && isnan(p.distanceM));
+  CHECK(decode("$DTPING,,2000,,*02", p, st) == SEAKER_SENT_DTPING);
+  CHECK(isnan(p.angleDeg) && isnan(p.distanceM));
+  // Trop de champs: les premiers sont décodés, le reste ignoré sans débordement
+  CHECK(decode("$DTPING,0.100,4000,5.0,500,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9*35", p, st)
+        == SEAKER_SENT_DTPING);
+  CHECK(p.tatMs == 4000 && near(p.angleDeg, 5.0f) && near(p.distanceM, 50.0f));
+}
+
+static void checkStatus() {
+  SeakerPing p; SeakerStatusRec st;
+  CHECK(decode("$STATUS,OK,24000,18.5,120.0,45.5*2F", p, st) == SEAKER_SENT_STATUS);
+  CHECK(strcmp(st.status, "OK") == 0);
+  CHECK(near(st.rxFrequency, 24000.0f) && near(st.snr, 18.5f));
+  CHECK(near(st.energyTx, 120.0f) && near(st.energyRx, 45.5f));
+  // Champs manquants: NAN
+  CHECK(decode("$STATUS,OK*3C", p, st) == SEAKER_SENT_STATUS);
+  CHECK(strcmp(st.status, "OK") == 0);
+  CHECK(isnan(st.rxFrequency) && isnan(st.snr) && isnan(st.energyTx) && isnan(st.energyRx));
+  // Statut plus long que le tampon: tronqué et terminé
+  CHECK(decode("$STATUS,RX_TIMEOUT_LONG_NAME*3B", p, st) == SEAKER_SENT_STATUS);
+  CHECK(strlen(st.status) == SEAKER_STATUS_MAX - 1);
+  CHECK(strncmp(st.status, "RX_TIMEOUT_LONG_NAME", SEAKER_STATUS_MAX - 1) == 0);
+}
+
+static void checkMalformed() {
+  SeakerPing p; SeakerStatusRec st;
+  CHECK(decode("$DTPING,0.412,2000,-12.5,3087*13", p, st) == SEAKER_SENT_NONE);   // checksum faux
+  CHECK(decode("$STATUS,OK,24000,18.5,120.0,45.5*00", p, st) == SEAKER_SENT_NONE);
+  CHECK(decode("$DTPING,23.0,154.2", p, st) == SEAKER_SENT_NONE);                 // sans '*'
+  CHECK(decode("DTPING,23.0,154.2*33", p, st) == SEAKER_SENT_NONE);               // sans '$'
+  CHECK(decode("", p, st) == SEAKER_SENT_NONE);
+  CHECK(decode("$GPGGA,1,2*55", p, st) == SEAKER_SENT_NONE);                      // phrase ignorée
+  CHECK(decode("[SEAKER] boot", p, st) == SEAKER_SENT_NONE);
+}
+
+static void checkCommands() {
+  const char* c1 = "CONFIG,3,1500,2000";
+  CHECK(seakerCommandChannel(c1, strlen(c1)) == 3);
+  const char* c2 = "CONFIG,0,1500";
+  CHECK(seakerCommandChannel(c2, strlen(c2)) == -1);
+  const char* c3 = "CONFIG,256";
+  CHECK(seakerCommandChannel(c3, strlen(c3)) == -1);
+  const char* c4 = "CONFIG,1x";
+  CHECK(seakerCommandChannel(c4, strlen(c4)) == -1);
+  const char* c5 = "PING,3";
+  CHECK(seakerCommandChannel(c5, strlen(c5)) == -1);
+  CHECK(seakerTatAccepted(4050, 2000, 100));
+  CHECK(seakerTatAccepted(3950, 2000, 100));
+  CHECK(!seakerTatAccepted(3000, 2000, 100));
+  CHECK(seakerTatAccepted(-1, 2000, 100));
+}
+
+int main() {
+  checkDtping();
+  checkStatus();
+  checkMalformed();
+  checkCommands();
+  printf("%d vérifications, %d échec(s)\n", checks, failures);
+  return failures ? 1 : 0;
+}
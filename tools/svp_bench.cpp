@@ -0,0 +1,90 @@
+// Banc hôte de la correction de réfraction (src/sound_profile)
+// Profil d'été avec thermocline (1520 m/s en surface, 1486 m/s sous 60 m), tête à
+// 2 m, balise de 2 à 300 m de profondeur, distance nominale SEAKER (1500 m/s) de
+// 100 à 1900 m. Référence: tir de rayons fin (bissection sur l'angle de départ).
+// Erreur de la distance horizontale: distance nominale brute (calcul historique),
+// ligne droite à la célérité moyenne harmonique, grille précalculée (bilinéaire).
+// Sortie: erreur moyenne / max par profondeur, tirages où la grille fait plus de
+// 5 cm pire que la ligne droite harmonique, temps de construction de la grille,
+// coût d'une consultation.
+//
+//Build
+//g++ -O2 -std=gnu++11 -Isrc -o svp_bench tools/svp_bench.cpp src/sound_profile.cpp
+//
+//Usage
+//./svp_bench [profil.csv]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <random>
+#include <chrono>
+#include "sound_profile.h"
+
+static const char* DEFAULT_SVP =
+  "# profondeur,celerite\n"
+  "depth,speed\n"
+  "0,1520\n10,1518\n20,1508\n30,1495\n45,1490\n60,1488\n200,1486\n500,1490\n";
+
+struct Err { double sa; double mx; int n; };
+
+static void note(Err& e, float d) {
+  e.sa += fabs(d); e.n++;
+  if (fabs(d) > e.mx) e.mx = fabs(d);
+}
+
+int main(int argc, char** argv) {
+  static char buf[8192];
+  size_t len = strlen(DEFAULT_SVP);
+  memcpy(buf, DEFAULT_SVP, len);
+  if (argc > 1) {
+    FILE* f = fopen(argv[1], "rb");
+    if (!f) { perror(argv[1]); return 1; }
+    len = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+  }
+  SoundProfile p;
+  if (!soundProfileParse(buf, len, p)) { fprintf(stderr, "profil invalide\n"); return 1; }
+  const float head = 2.0f;
+  typedef std::chrono::steady_clock Clock;
+  static SvpGrid g;
+  Clock::time_point a = Clock::now();
+  svpGridBuild(p, head, g);
+  Clock::time_point b = Clock::now();
+
+  const float depths[5] = {2.0f, 20.0f, 50.0f, 100.0f, 300.0f};
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<float> ur(100.0f, 1900.0f);
+  printf("%-8s %8s %18s %18s %18s %12s\n", "balise", "c moy.", "sans correction", "moy. harmonique", "grille", "grille>harm.");
+  for (int k = 0; k < 5; ++k) {
+    float dz = depths[k] - head;
+    float cm = soundProfileHarmonicMean(p, head, depths[k]);
+    Err e0 = {}, e1 = {}, e2 = {};
+    int worse = 0;
+    for (int i = 0; i < 100; ++i) {
+      float R = ur(rng);
+      if (R < 1.2f * fabsf(dz)) continue;
+      float ref = svpRayTraceHorizontal(p, head, R, dz);
+      if (!isfinite(ref)) continue;
+      note(e0, R - ref);
+      float s = R * cm / SVP_NOMINAL_SPEED;
+      float eh = sqrtf(fmaxf(0.0f, s * s - dz * dz)) - ref, eg = svpGridHorizontal(g, R, dz) - ref;
+      note(e1, eh);
+      note(e2, eg);
+      if (fabsf(eg) > fabsf(eh) + 0.05f) worse++;
+    }
+    printf("%5.0f m  %6.1f   %7.2f / %6.2f m  %7.2f / %6.2f m  %7.2f / %6.2f m  %6d / %d\n", (double)depths[k], (double)cm,
+           e0.sa / e0.n, e0.mx, e1.sa / e1.n, e1.mx, e2.sa / e2.n, e2.mx, worse, e2.n);
+  }
+
+  volatile float sink = 0.0f;
+  const int n = 2000000;
+  Clock::time_point c = Clock::now();
+  for (int i = 0; i < n; ++i) sink = sink + svpGridHorizontal(g, 50.0f + (i & 1023) * 1.7f, 40.0f);
+  Clock::time_point d = Clock::now();
+  printf("construction de la grille: %.1f ms, consultation: %.0f ns/ping (erreur moyenne / max)\n",
+         std::chrono::duration<double, std::milli>(b - a).count(),
+         std::chrono::duration<double, std::nano>(d - c).count() / n);
+  return 0;
+}
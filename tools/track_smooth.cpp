@@ -0,0 +1,184 @@
+// Lissage hors ligne d'une trace cible (même filtre et même lisseur RTS que le firmware)
+// Entrée: journal de tools/logger.py (lignes "<ISO8601>Z NMEA $TARGET,lat,lon,az=..,dist_m=..,r95_m=..,id=..*CS").
+// Un journal multi-balises se lisse une balise à la fois (--id).
+// La position du bateau est reconstituée à partir de la cible, de l'azimut et de la distance,
+// puis chaque ping repasse dans target_filter (mesure polaire ou cartésienne, gating) et
+// target_smoother, en une seule passe. Sortie: GeoJSON de points lissés (ts, r95_m, lag),
+// lisible directement par QGIS (docs/Guide_QGIS.md).
+//
+//Build
+//g++ -O2 -std=gnu++11 -Isrc -o track_smooth tools/track_smooth.cpp src/target_filter.cpp src/target_smoother.cpp src/local_enu.cpp
+//
+//Usage
+//./track_smooth rov.000.log sortie.geojson [--lag N] [--mode cart|ekf|ukf] [--ang deg] [--rel frac]
+//               [--gps m] [--astd m/s2] [--gate sigma] [--id N]
+//  --lag 0: lissage sur toute la trace (jusqu'à la réinitialisation suivante du filtre)
+//  --id N: pings de la balise N seulement (sans id dans la trame: balise 0); par défaut tous
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "target_filter.h"
+#include "target_smoother.h"
+#include "local_enu.h"
+
+// Mêmes seuils que src/target_fusion.cpp
+static const float FILTER_MAX_GAP_S = 30.0f;
+static const int FILTER_MAX_GATED = 5;
+
+struct Options {
+  int lag = 0;
+  uint8_t mode = TARGET_MEAS_EKF;
+  float angDeg = 3.0f, rangeRel = 0.005f, gpsStd = 0.5f, aStd = 0.5f, gate = 4.0f;
+  int id = -1;
+};
+
+static FILE* out = nullptr;
+static int written = 0;
+static LocalEnu enu = {};
+
+static void writePoint(const TargetSmoothOut& s) {
+  double lat, lon;
+  localEnuInverse(enu, s.x, s.y, lat, lon);
+  fprintf(out, "%s\n{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\",\"coordinates\":[%.8f,%.8f]},"
+               "\"properties\":{\"ts\":%.3f,\"r95_m\":%.2f,\"lag\":%u}}",
+          written ? "," : "", lon, lat, (double)s.tUs / 1e6, (double)(s.posStd * 2.45f), (unsigned)s.lag);
+  written++;
+}
+
+static void drain(TargetSmoother& sm, int lag) {
+  TargetSmoothOut s;
+  while (targetSmootherPop(sm, (uint16_t)lag, s)) writePoint(s);
+}
+
+// "2025-09-11T22:05:09.123456Z" -> µs depuis 1970 (UTC)
+static bool parseIso(const char* p, int64_t& us) {
+  struct tm tmv = {};
+  int y, mo, d, h, mi; double sec;
+  if (sscanf(p, "%d-%d-%dT%d:%d:%lfZ", &y, &mo, &d, &h, &mi, &sec) != 6) return false;
+  tmv.tm_year = y - 1900; tmv.tm_mon = mo - 1; tmv.tm_mday = d;
+  tmv.tm_hour = h; tmv.tm_min = mi; tmv.tm_sec = 0;
+  us = (int64_t)timegm(&tmv) * 1000000 + (int64_t)llround(sec * 1e6);
+  return true;
+}
+
+static bool parseTarget(const char* p, double& lat, double& lon, float& az, float& dist, int& id) {
+  const char* t = strstr(p, "$TARGET,");
+  if (!t) return false;
+  if (sscanf(t, "$TARGET,%lf,%lf,az=%f,dist_m=%f", &lat, &lon, &az, &dist) != 4) return false;
+  const char* i = strstr(t, ",id=");
+  id = i ? atoi(i + 4) : 0;
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s journal.log sortie.geojson [--lag N] [--mode cart|ekf|ukf] [--ang deg] [--rel frac] [--gps m] [--astd a] [--gate g] [--id N]\n", argv[0]);
+    return 1;
+  }
+  Options o;
+  for (int i = 3; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--lag")) o.lag = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--mode")) o.mode = !strcmp(argv[i + 1], "cart") ? TARGET_MEAS_CART : !strcmp(argv[i + 1], "ukf") ? TARGET_MEAS_UKF : TARGET_MEAS_EKF;
+    else if (!strcmp(argv[i], "--ang")) o.angDeg = (float)atof(argv[i + 1]);
+    else if (!strcmp(argv[i], "--rel")) o.rangeRel = (float)atof(argv[i + 1]);
+    else if (!strcmp(argv[i], "--gps")) o.gpsStd = (float)atof(argv[i + 1]);
+    else if (!strcmp(argv[i], "--astd")) o.aStd = (float)atof(argv[i + 1]);
+    else if (!strcmp(argv[i], "--gate")) o.gate = (float)atof(argv[i + 1]);
+    else if (!strcmp(argv[i], "--id")) o.id = atoi(argv[i + 1]);
+    else { fprintf(stderr, "option inconnue: %s\n", argv[i]); return 1; }
+  }
+  if (o.lag < 0 || o.lag > 65534) o.lag = 0;
+  FILE* in = fopen(argv[1], "r");
+  if (!in) { perror(argv[1]); return 1; }
+  out = fopen(argv[2], "w");
+  if (!out) { perror(argv[2]); return 1; }
+  fprintf(out, "{\"type\":\"FeatureCollection\",\"features\":[");
+
+  // Anneau à la taille du retard demandé; lag 0 = toute la trace, anneau extensible
+  std::vector<TargetSmoothStep> ring(o.lag > 0 ? o.lag + 1 : 4096);
+  TargetSmoother sm;
+  targetSmootherInit(sm, ring.data(), (uint16_t)ring.size());
+  TargetFilterState f = {};
+  int64_t lastUs = 0;
+  int gatedStreak = 0, pings = 0, gated = 0, resets = 0;
+  const float angStd = o.angDeg * (float)(M_PI / 180.0);
+
+  char line[512];
+  while (fgets(line, sizeof(line), in)) {
+    int64_t tUs; double lat, lon; float az, dist; int id;
+    if (!strstr(line, " NMEA ") || !parseIso(line, tUs) || !parseTarget(line, lat, lon, az, dist, id)) continue;
+    if (o.id >= 0 && id != o.id) continue;
+    if (!isfinite(dist) || !isfinite(az)) continue;
+    pings++;
+    if (localEnuNeedsReanchor(enu, lat, lon)) {
+      // Même règle que le firmware: lisseur vidé, filtre reporté dans le nouveau plan
+      drain(sm, 0);
+      LocalEnu prev = enu;
+      localEnuInit(enu, lat, lon);
+      if (prev.valid && f.initialized) {
+        double la, lo; float x, y;
+        localEnuInverse(prev, targetFilterX(f), targetFilterY(f), la, lo);
+        localEnuForward(enu, la, lo, x, y);
+        targetFilterSetPos(f, x, y);
+      }
+    }
+    float e1, n1;
+    localEnuForward(enu, lat, lon, e1, n1);
+    float brg = localEnuGridAzimuth(enu, lon, az) * (float)(M_PI / 180.0);
+    TargetPolarMeas pm;
+    pm.range = fabsf(dist);
+    pm.bearingRad = (dist < 0) ? brg + (float)M_PI : brg;
+    pm.originX = e1 - pm.range * sinf(pm.bearingRad);
+    pm.originY = n1 - pm.range * cosf(pm.bearingRad);
+    pm.rangeStd = fmaxf(0.1f, o.rangeRel * pm.range);
+    pm.bearingStd = angStd;
+    pm.originStd = o.gpsStd;
+    float lat2 = pm.range * angStd;
+    float measStd = sqrtf(lat2 * lat2 + pm.rangeStd * pm.rangeStd + o.gpsStd * o.gpsStd);
+
+    float dt = lastUs ? (float)(tUs - lastUs) / 1e6f : 0.0f;
+    lastUs = tUs;
+    if (dt > FILTER_MAX_GAP_S || gatedStreak >= FILTER_MAX_GATED) {
+      drain(sm, 0);
+      if (f.initialized) resets++;
+      targetFilterReset(f);
+      gatedStreak = 0;
+    }
+    if (dt > 0.0f) targetFilterPredict(f, dt, o.aStd);
+    bool polar = (o.mode != TARGET_MEAS_CART);
+    float g = polar ? targetFilterPolarInnovation(f, o.mode, pm) : targetFilterInnovation(f, e1, n1, measStd);
+    if (g >= o.gate) { gated++; gatedStreak++; continue; }
+    gatedStreak = 0;
+    KalmanFixed<4, 2> prior = f.kf;
+    bool hadPrior = f.initialized;
+    if (polar) targetFilterPolarUpdate(f, o.mode, pm);
+    else targetFilterUpdate(f, e1, n1, measStd);
+    if (!hadPrior) prior = f.kf;
+    if (o.lag == 0 && sm.count == sm.cap) {
+      if (ring.size() < 65535) {
+        // Trace plus longue que l'anneau: agrandissement, pas en attente recopiés dans l'ordre
+        std::vector<TargetSmoothStep> bigger(ring.size() * 2 < 65535 ? ring.size() * 2 : 65535);
+        for (uint16_t i = 0; i < sm.count; ++i) bigger[i] = ring[(sm.first + i) % sm.cap];
+        uint16_t n = sm.count;
+        ring.swap(bigger);
+        targetSmootherInit(sm, ring.data(), (uint16_t)ring.size());
+        sm.count = n;
+      } else {
+        drain(sm, sm.cap - 1);   // au-delà, retard fixe de 65534 pings
+      }
+    }
+    targetSmootherPush(sm, tUs, prior, f.kf);
+    if (o.lag > 0) drain(sm, o.lag);
+  }
+  drain(sm, 0);
+  fprintf(out, "\n]}\n");
+  fclose(out);
+  fclose(in);
+  fprintf(stderr, "%d pings, %d rejetés (gating), %d réinitialisations, %d points lissés (mode %s, lag %d)\n",
+          pings, gated, resets, written, targetMeasModeName(o.mode), o.lag);
+  return 0;
+}
@@ -0,0 +1,208 @@
+// Banc hôte du moteur UTM (src/utm.cpp, séries de Krüger ordre 6)
+//  - ns/point: conversion unitaire et par lot, aller et retour, face à
+//    l'ancienne implémentation (développements de Snyder, reproduite ici)
+//  - erreur: référence = Mercator transverse exacte (prolongement analytique
+//    de l'arc de méridien, sans série en n), plus écart aller-retour et
+//    écart Snyder -> référence
+// Points tirés sur tout le fuseau (|dLon| <= 3°), latitudes -80..84°.
+//
+//Build
+//g++ -O2 -std=gnu++11 -Isrc -o utm_bench tools/utm_bench.cpp src/utm.cpp
+//
+//Usage
+//./utm_bench [points] [répétitions]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <complex>
+#include <chrono>
+#include "utm.h"
+
+// --- Ancienne implémentation (Snyder, "Map Projections - A Working Manual") ---
+static const double WGS84_A = 6378137.0;
+static const double WGS84_F = 1.0 / 298.257223563;
+static const double WGS84_E2 = WGS84_F * (2.0 - WGS84_F);
+static const double K0 = 0.9996;
+static const double D2R = M_PI / 180.0;
+
+static bool snyderToUtm(double latDeg, double lonDeg, int& zone, bool& northHemisphere, double& easting, double& northing) {
+  zone = (int)floor((lonDeg + 180.0) / 6.0) + 1;
+  if (zone < 1) zone = 1;
+  if (zone > 60) zone = 60;
+  northHemisphere = (latDeg >= 0.0);
+  double lat = latDeg * D2R, lon = lonDeg * D2R;
+  double lon0 = ((zone - 1) * 6 - 180 + 3) * D2R;
+  double e2 = WGS84_E2, ep2 = e2 / (1.0 - e2);
+  double sinLat = sin(lat), cosLat = cos(lat), tanLat = tan(lat);
+  double N = WGS84_A / sqrt(1.0 - e2 * sinLat * sinLat);
+  double T = tanLat * tanLat, C = ep2 * cosLat * cosLat, A = (lon - lon0) * cosLat;
+  double M = WGS84_A * ((1 - e2/4 - 3*e2*e2/64 - 5*e2*e2*e2/256) * lat
+    - (3*e2/8 + 3*e2*e2/32 + 45*e2*e2*e2/1024) * sin(2*lat)
+    + (15*e2*e2/256 + 45*e2*e2*e2/1024) * sin(4*lat)
+    - (35*e2*e2*e2/3072) * sin(6*lat));
+  easting = K0 * N * (A + (1 - T + C) * A*A*A / 6.0 + (5 - 18*T + T*T + 72*C - 58*ep2) * A*A*A*A*A / 120.0) + 500000.0;
+  northing = K0 * (M + N * tanLat * (A*A/2.0 + (5 - T + 9*C + 4*C*C) * A*A*A*A / 24.0 + (61 - 58*T + T*T + 600*C - 330*ep2) * A*A*A*A*A*A / 720.0));
+  if (!northHemisphere) northing += 10000000.0;
+  return true;
+}
+
+static bool snyderToWgs84(int zone, bool northHemisphere, double easting, double northing, double& latDeg, double& lonDeg) {
+  double x = easting - 500000.0, y = northing;
+  if (!northHemisphere) y -= 10000000.0;
+  double e2 = WGS84_E2, ep2 = e2 / (1.0 - e2);
+  double lon0 = ((zone - 1) * 6 - 180 + 3) * D2R;
+  double mu = y / K0 / (WGS84_A * (1 - e2/4 - 3*e2*e2/64 - 5*e2*e2*e2/256));
+  double e1 = (1 - sqrt(1 - e2)) / (1 + sqrt(1 - e2));
+  double fp = mu + (3*e1/2 - 27*e1*e1*e1/32)*sin(2*mu) + (21*e1*e1/16 - 55*e1*e1*e1*e1/32)*sin(4*mu)
+            + (151*e1*e1*e1/96)*sin(6*mu) + (1097*e1*e1*e1*e1/512)*sin(8*mu);
+  double sinfp = sin(fp), cosfp = cos(fp), tanfp = tan(fp);
+  double C1 = ep2 * cosfp * cosfp, T1 = tanfp * tanfp;
+  double N1 = WGS84_A / sqrt(1 - e2 * sinfp * sinfp);
+  double R1 = N1 * (1 - e2) / (1 - e2 * sinfp * sinfp);
+  double D = x / (N1 * K0);
+  double lat = fp - (N1 * tanfp / R1) * (D*D/2.0 - (5 + 3*T1 + 10*C1 - 4*C1*C1 - 9*ep2) * D*D*D*D/24.0 + (61 + 90*T1 + 298*C1 + 45*T1*T1 - 252*ep2 - 3*C1*C1) * D*D*D*D*D*D/720.0);
+  double lon = lon0 + (D - (1 + 2*T1 + C1) * D*D*D/6.0 + (5 - 2*C1 + 28*T1 - 3*C1*C1 + 8*ep2 + 24*T1*T1) * D*D*D*D*D/120.0) / cosfp;
+  latDeg = lat / D2R; lonDeg = lon / D2R;
+  return true;
+}
+
+// --- Référence indépendante: Mercator transverse exacte (Lee 1976, Thompson) ---
+// La projection est le prolongement analytique de l'arc de méridien:
+//   y + i x = k0 M(phi(w)),  w = psi + i dLon  (psi: latitude isométrique)
+// phi(w) complexe par Newton sur psi(phi) = w, puis M(phi) = a(1-e²) ∫0^phi (1-e² sin² t)^-3/2 dt
+// par Gauss-Legendre sur le segment [0, phi] du plan complexe. Aucune série en n:
+// l'écart mesuré est l'erreur de troncature de l'ordre 6 plus les arrondis double.
+typedef long double LD;
+typedef std::complex<LD> CLD;
+static const int GL_N = 32, GL_SEG = 2;
+static LD glX[GL_N], glW[GL_N];
+
+static void glInit() {
+  for (int i = 0; i < GL_N; ++i) {
+    LD x = cosl(M_PIl * (i + 0.75L) / (GL_N + 0.5L)), dp = 1;
+    for (int it = 0; it < 100; ++it) {
+      LD p0 = 1, p1 = x;
+      for (int k = 2; k <= GL_N; ++k) { LD p2 = ((2*k - 1) * x * p1 - (k - 1) * p0) / k; p0 = p1; p1 = p2; }
+      dp = GL_N * (x * p1 - p0) / (x * x - 1);
+      LD dx = p1 / dp;
+      x -= dx;
+      if (fabsl(dx) < 1e-19L) break;
+    }
+    glX[i] = x; glW[i] = 2 / ((1 - x * x) * dp * dp);
+  }
+}
+
+static void refToUtm(double latDeg, double lonDeg, int zone, LD& e, LD& n) {
+  const LD f = 1.0L / 298.257223563L, e2 = f * (2.0L - f), ecc = sqrtl(e2);
+  LD lat = latDeg * (M_PIl / 180.0L), dl = (lonDeg - ((zone - 1) * 6 - 180 + 3)) * (M_PIl / 180.0L);
+  LD s = sinl(lat);
+  CLD w(atanhl(s) - ecc * atanhl(ecc * s), dl);
+  CLD phi = std::atan(std::sinh(w));
+  for (int it = 0; it < 50; ++it) {
+    CLD sp = std::sin(phi);
+    CLD r = std::atanh(sp) - ecc * std::atanh(ecc * sp) - w;
+    CLD d = r * (CLD(1) - e2 * sp * sp) * std::cos(phi) / (1 - e2);
+    phi -= d;
+    if (std::abs(d) < 1e-19L) break;
+  }
+  CLD m(0);
+  for (int k = 0; k < GL_SEG; ++k) {
+    for (int i = 0; i < GL_N; ++i) {
+      CLD t = phi * ((k + 0.5L * (glX[i] + 1)) / GL_SEG);
+      CLD st = std::sin(t);
+      CLD q = CLD(1) - e2 * st * st;
+      m += glW[i] / (q * std::sqrt(q));
+    }
+  }
+  m *= phi * (0.5L / GL_SEG) * (6378137.0L * (1 - e2));
+  e = 0.9996L * m.imag() + 500000.0L;
+  n = 0.9996L * m.real() + (latDeg < 0 ? 10000000.0L : 0.0L);
+}
+
+static double urand(double a, double b) { return a + (b - a) * (rand() / (double)RAND_MAX); }
+typedef std::chrono::steady_clock Clock;
+static double nsPer(Clock::time_point a, Clock::time_point b, size_t n) {
+  return std::chrono::duration<double, std::nano>(b - a).count() / n;
+}
+static volatile double gSink;
+
+int main(int argc, char** argv) {
+  size_t count = (argc > 1) ? (size_t)atol(argv[1]) : 100000;
+  int reps = (argc > 2) ? atoi(argv[2]) : 10;
+  std::vector<GeoPoint> pts(count);
+  std::vector<UtmCoord> utm(count);
+  std::vector<GeoPoint> back(count);
+  srand(1);
+  glInit();
+  for (size_t i = 0; i < count; ++i) {
+    int zone = 1 + rand() % 60;
+    pts[i].latDeg = urand(-80.0, 84.0);
+    pts[i].lonDeg = (zone - 1) * 6 - 180 + 3 + urand(-2.999, 2.999);
+  }
+
+  // --- Erreurs ---
+  double fwdMax = 0, rtMax = 0, snyFwdMax = 0, snyRtMax = 0, snyFwdMaxCore = 0;
+  for (size_t i = 0; i < count; ++i) {
+    int z; bool nh; double e, n;
+    wgs84ToUtm(pts[i].latDeg, pts[i].lonDeg, z, nh, e, n);
+    long double re, rn;
+    refToUtm(pts[i].latDeg, pts[i].lonDeg, z, re, rn);
+    fwdMax = fmax(fwdMax, (double)hypotl(e - re, n - rn));
+    double lat, lon;
+    utmToWgs84(z, nh, e, n, lat, lon);
+    double m = hypot((lat - pts[i].latDeg) * 111320.0, (lon - pts[i].lonDeg) * 111320.0 * cos(lat * D2R));
+    rtMax = fmax(rtMax, m);
+
+    double se, sn;
+    snyderToUtm(pts[i].latDeg, pts[i].lonDeg, z, nh, se, sn);
+    double d = (double)hypotl(se - re, sn - rn);
+    snyFwdMax = fmax(snyFwdMax, d);
+    if (fabs(pts[i].lonDeg - ((z - 1) * 6 - 180 + 3)) <= 1.0) snyFwdMaxCore = fmax(snyFwdMaxCore, d);
+    snyderToWgs84(z, nh, se, sn, lat, lon);
+    m = hypot((lat - pts[i].latDeg) * 111320.0, (lon - pts[i].lonDeg) * 111320.0 * cos(lat * D2R));
+    snyRtMax = fmax(snyRtMax, m);
+  }
+  printf("points=%zu x %d\n", count, reps);
+  printf("krüger : aller vs TM exacte max %.2e m, aller-retour max %.2e m\n", fwdMax, rtMax);
+  printf("snyder : aller vs TM exacte max %.2e m (|dLon|<=1°: %.2e m), aller-retour max %.2e m\n",
+         snyFwdMax, snyFwdMaxCore, snyRtMax);
+
+  // --- Temps ---
+  Clock::time_point t0 = Clock::now();
+  for (int r = 0; r < reps; ++r) {
+    for (size_t i = 0; i < count; ++i) {
+      UtmCoord& u = utm[i];
+      wgs84ToUtm(pts[i].latDeg, pts[i].lonDeg, u.zone, u.northHemisphere, u.easting, u.northing);
+    }
+  }
+  Clock::time_point t1 = Clock::now();
+  for (int r = 0; r < reps; ++r) wgs84ToUtmBatch(pts.data(), utm.data(), count);
+  Clock::time_point t2 = Clock::now();
+  for (int r = 0; r < reps; ++r) utmToWgs84Batch(utm.data(), back.data(), count);
+  Clock::time_point t3 = Clock::now();
+  double acc = 0;
+  for (int r = 0; r < reps; ++r) {
+    for (size_t i = 0; i < count; ++i) {
+      int z; bool nh; double e, n;
+      snyderToUtm(pts[i].latDeg, pts[i].lonDeg, z, nh, e, n);
+      acc += e;
+    }
+  }
+  Clock::time_point t4 = Clock::now();
+  for (int r = 0; r < reps; ++r) {
+    for (size_t i = 0; i < count; ++i) {
+      double lat, lon;
+      snyderToWgs84(utm[i].zone, utm[i].northHemisphere, utm[i].easting, utm[i].northing, lat, lon);
+      acc += lat;
+    }
+  }
+  Clock::time_point t5 = Clock::now();
+  gSink = acc + back[count / 2].latDeg;
+  size_t total = count * (size_t)reps;
+  printf("krüger : aller %.1f ns/pt, aller lot %.1f ns/pt, retour lot %.1f ns/pt\n",
+         nsPer(t0, t1, total), nsPer(t1, t2, total), nsPer(t2, t3, total));
+  printf("snyder : aller %.1f ns/pt, retour %.1f ns/pt\n", nsPer(t3, t4, total), nsPer(t4, t5, total));
+  return 0;
+}